@@ -0,0 +1,206 @@
+// Narrowphase benchmark for JellyPhysics: the small car from car_and_truck.car resting on one static ground
+// body with a long, bumpy top. Runs the same scene with and without the per-body edge index and checks that
+// both end up in the same place.
+//
+// usage: GroundBenchmark [edges] [steps]
+
+#include "JellyPhysics.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace JellyPhysics;
+
+static const Vector2 Gravity(0.0f, -12.0f);
+
+// tire, like the game's Tire without the motor.
+class GroundTire : public PressureBody
+{
+public:
+	GroundTire( World* w, const ClosedShape& shape, const Vector2& pos ) :
+		PressureBody(w, shape, 1.0f, 50.0f, 10.0f, 1.0f, 6000.0f, 100.0f, pos, 0.0f, Vector2::One, false)
+	{
+		mShockForce = Vector2::Zero;
+	}
+	
+	void addShockForce( const Vector2& f ) { mShockForce += f; }
+	
+	void accumulateExternalForces()
+	{
+		Vector2 shock = mShockForce / (float)mPointCount;
+		for (int i = 0; i < mPointCount; i++)
+			mPointMasses[i].Force += (Gravity * mPointMasses[i].Mass) + shock;
+		
+		mShockForce = Vector2::Zero;
+	}
+
+private:
+	Vector2		mShockForce;
+};
+
+// chassis, with the shock springs that hold the tires.
+class GroundChassis : public SpringBody
+{
+public:
+	struct Shock
+	{
+		int				point;
+		GroundTire*		tire;
+		float			length;
+		float			k;
+		float			damp;
+	};
+	
+	GroundChassis( World* w, const ClosedShape& shape, const Vector2& pos ) :
+		SpringBody(w, shape, 1.0f, 1000.0f, 10.0f, 300.0f, 20.0f, pos, 0.0f, Vector2::One, false)
+	{
+	}
+	
+	void addShock( int point, GroundTire* tire, float length, float k, float damp )
+	{
+		Shock s = { point, tire, length, k, damp };
+		mShocks.push_back(s);
+	}
+	
+	void accumulateExternalForces()
+	{
+		for (int i = 0; i < mPointCount; i++)
+			mPointMasses[i].Force += Gravity * mPointMasses[i].Mass;
+		
+		for (unsigned int i = 0; i < mShocks.size(); i++)
+		{
+			const Shock& s = mShocks[i];
+			PointMass pm = mPointMasses[s.point];
+			
+			Vector2 force = VectorTools::calculateSpringForce(pm.Position, pm.Velocity, s.tire->getDerivedPosition(), s.tire->getDerivedVelocity(), s.length, s.k, s.damp);
+			pm.Force += force;
+			s.tire->addShockForce(-force);
+		}
+	}
+
+private:
+	std::vector<Shock>	mShocks;
+};
+
+// ground running from -width/2 to width/2, with edges - 2 points along a bumpy top and two corners below.
+static ClosedShape makeGround( int edges, float width )
+{
+	int topPoints = edges - 2;
+	
+	ClosedShape shape;
+	shape.begin();
+	shape.addVertex(Vector2(-width * 0.5f, -4.0f));
+	for (int i = 0; i < topPoints; i++)
+	{
+		float x = -width * 0.5f + (width * i) / (topPoints - 1);
+		shape.addVertex(Vector2(x, (0.3f * sinf(x * 0.35f)) + (0.05f * sinf(x * 2.3f))));
+	}
+	shape.addVertex(Vector2(width * 0.5f, -4.0f));
+	shape.finish(false);
+	return shape;
+}
+
+static ClosedShape makeChassisShape()
+{
+	const float verts[][2] = { { -1.7f, -0.6f }, { -1.7f, -0.2f }, { -1.1f, 0.0f }, { -0.7f, 0.6f }, { 0.0f, 0.6f }, { 0.5f, 0.6f }, { 1.1f, 0.0f },
+		{ 2.1f, -0.2f }, { 2.1f, -0.6f }, { 1.1f, -0.6f }, { 0.5f, -0.6f }, { 0.0f, -0.6f }, { -0.5f, -0.6f }, { -1.1f, -0.6f } };
+	
+	ClosedShape shape;
+	shape.begin();
+	for (unsigned int i = 0; i < sizeof(verts) / sizeof(verts[0]); i++)
+		shape.addVertex(Vector2(verts[i][0], verts[i][1]));
+	shape.finish();
+	return shape;
+}
+
+static ClosedShape makeTireShape()
+{
+	ClosedShape shape;
+	shape.begin();
+	for (int i = 0; i < 360; i += 20)
+		shape.addVertex(Vector2(cosf(VectorTools::degToRad((float)-i)) * 0.3f, sinf(VectorTools::degToRad((float)-i)) * 0.3f));
+	shape.finish();
+	return shape;
+}
+
+struct GroundResult
+{
+	double	msPerStep;
+	Vector2	chassisPos;
+};
+
+static GroundResult runGround( bool useEdgeIndex, int edges, int steps )
+{
+	const float width = 200.0f;
+	
+	World world;
+	world.setUseEdgeIndex(useEdgeIndex);
+	
+	Body* ground = new Body(&world, makeGround(edges, width), 0.0f, Vector2::Zero, 0.0f, Vector2::One, false);
+	
+	// shock points and springs of the small car.
+	Vector2 pos(0.0f, 1.4f);
+	GroundChassis* chassis = new GroundChassis(&world, makeChassisShape(), pos);
+	GroundTire* front = new GroundTire(&world, makeTireShape(), pos + Vector2(1.5f, -0.3f));
+	GroundTire* back = new GroundTire(&world, makeTireShape(), pos + Vector2(-1.3f, -0.3f));
+	
+	chassis->addShock(9, front, 0.5f, 1000.0f, 50.0f);
+	chassis->addShock(8, front, 0.65f, 1000.0f, 50.0f);
+	chassis->addShock(6, front, 1.0f, 1000.0f, 50.0f);
+	chassis->addShock(7, front, 0.9f, 1000.0f, 50.0f);
+	chassis->addShock(11, front, 1.5f, 5000.0f, 50.0f);
+	chassis->addShock(0, back, 0.75f, 1000.0f, 50.0f);
+	chassis->addShock(12, back, 0.6f, 1000.0f, 50.0f);
+	chassis->addShock(1, back, 1.1f, 1000.0f, 50.0f);
+	chassis->addShock(4, back, 2.0f, 1000.0f, 50.0f);
+	chassis->addShock(11, back, 1.06f, 5000.0f, 50.0f);
+	
+	world.setWorldLimits(Vector2(-width * 0.5f - 2.0f, -6.0f), Vector2(width * 0.5f + 2.0f, 10.0f));
+	
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for (int s = 0; s < steps; s++)
+		world.update(0.004f);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	
+	GroundResult result;
+	result.msPerStep = elapsed.count() / steps;
+	result.chassisPos = chassis->getDerivedPosition();
+	
+	delete back;
+	delete front;
+	delete chassis;
+	delete ground;
+	
+	return result;
+}
+
+int main( int argc, char** argv )
+{
+	int edges = (argc > 1) ? atoi(argv[1]) : 1000;
+	int steps = (argc > 2) ? atoi(argv[2]) : 2000;
+	
+	if ((edges < 8) || (steps < 1))
+	{
+		printf("usage: %s [edges] [steps]\n", argv[0]);
+		return 1;
+	}
+	
+	printf("JellyPhysics ground scene: car on a %d-edge static ground, %d steps of 0.004s\n\n", edges, steps);
+	printf("%-18s %10s %16s %24s\n", "edge lookup", "ms/step", "ms/frame (x6)", "chassis position");
+	
+	GroundResult results[2];
+	const char* names[] = { "every edge", "edge index" };
+	for (int i = 0; i < 2; i++)
+	{
+		results[i] = runGround(i == 1, edges, steps);
+		printf("%-18s %10.4f %16.4f %11.5f %11.5f\n", names[i], results[i].msPerStep, results[i].msPerStep * 6.0, results[i].chassisPos.X, results[i].chassisPos.Y);
+	}
+	
+	bool same = ((results[0].chassisPos.X == results[1].chassisPos.X) && (results[0].chassisPos.Y == results[1].chassisPos.Y));
+	printf("\nspeedup %.2fx, results %s\n", results[0].msPerStep / results[1].msPerStep, same ? "identical" : "DIFFER");
+	
+	return same ? 0 : 1;
+}
@@ -0,0 +1,799 @@
+// Level benchmark for JellyPhysics: loads a level in the game's compiled format - the .scenec files that
+// LevelManager::LoadCompiledLevel reads - puts the small car from car_and_truck.car at its start and drives it
+// with a fixed input script, timing each phase of World::update. Without a level file it builds its own track
+// with ramps, a motor, a moving platform and rows of soft boxes and balls, writes it in the same format and
+// loads that.
+//
+// usage: LevelBenchmark [steps] [level.scenec]
+
+#include "JellyPhysics.h"
+
+#include "../JellyCar/Levels/SimpleStruct/BodyObjectInfo.h"
+#include "../JellyCar/Levels/SimpleStruct/BodyPoint.h"
+#include "../JellyCar/Levels/SimpleStruct/BodySpring.h"
+#include "../JellyCar/Levels/SimpleStruct/BodyPolygon.h"
+#include "../JellyCar/Levels/SimpleStruct/GameObject.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace JellyPhysics;
+
+// level bodies, like the game's GameSpringBody and GamePressureBody without the drawing.
+class LevelSpringBody : public SpringBody
+{
+public:
+	LevelSpringBody( World* w, const ClosedShape& shape, float massPerPoint, float edgeK, float edgeDamp,
+		const Vector2& pos, float angle, const Vector2& scale, bool kinematic ) :
+		SpringBody(w, shape, massPerPoint, edgeK, edgeDamp, pos, angle, scale, kinematic)
+	{
+	}
+	
+	void accumulateExternalForces()
+	{
+		if (mIsStatic)
+			return;
+		
+		SpringBody::accumulateExternalForces();
+		for (int i = 0; i < mPointCount; i++)
+			mPointMasses[i].Force += Vector2(0.0f, -9.8f * mPointMasses[i].Mass);
+	}
+	
+	void accumulateInternalForces()
+	{
+		if (!mIsStatic)
+			SpringBody::accumulateInternalForces();
+	}
+};
+
+class LevelPressureBody : public PressureBody
+{
+public:
+	LevelPressureBody( World* w, const ClosedShape& shape, float massPerPoint, float pressure, float shapeK, float shapeDamp,
+		float edgeK, float edgeDamp, const Vector2& pos, float angle, const Vector2& scale, bool kinematic ) :
+		PressureBody(w, shape, massPerPoint, pressure, shapeK, shapeDamp, edgeK, edgeDamp, pos, angle, scale, kinematic)
+	{
+	}
+	
+	void accumulateExternalForces()
+	{
+		if (mIsStatic)
+			return;
+		
+		PressureBody::accumulateExternalForces();
+		for (int i = 0; i < mPointCount; i++)
+			mPointMasses[i].Force += Vector2(0.0f, -9.8f * mPointMasses[i].Mass);
+	}
+	
+	void accumulateInternalForces()
+	{
+		if (!mIsStatic)
+			PressureBody::accumulateInternalForces();
+	}
+};
+
+// moving platforms and motors, like the game's KinematicPlatform and KinematicMotor.
+struct LevelControl
+{
+	Body*	body;
+	bool	motor;
+	Vector2	start;
+	Vector2	end;
+	float	factor;			// platform loops, in radians per second.
+	float	i;
+	float	speed;			// motor speed, in radians per second.
+	
+	void update( float elapsed )
+	{
+		if (motor)
+		{
+			body->setKinematicAngle(body->getDerivedAngle() + (speed * elapsed));
+			return;
+		}
+		
+		i += elapsed * factor;
+		if (i > TWO_PI) { i -= TWO_PI; }
+		
+		body->setKinematicPosition(start.lerp(end, 0.5f + (sinf(i) * 0.5f)));
+	}
+};
+
+// the game's car, with the small shape from car_and_truck.car and no transforming.
+class LevelTire : public PressureBody
+{
+public:
+	LevelTire( World* w, const ClosedShape& shape, const Vector2& pos ) :
+		PressureBody(w, shape, 1.0f, 50.0f, 10.0f, 1.0f, 6000.0f, 100.0f, pos, 0.0f, Vector2::One, false)
+	{
+		mTorqueForce = 0.0f;
+		mShockForce = Vector2::Zero;
+	}
+	
+	void setTorque( float t ) { mTorqueForce = t; }
+	void setShockForce( const Vector2& f ) { mShockForce = f; }
+	void addShockForce( const Vector2& f ) { mShockForce += f; }
+	
+	void accumulateExternalForces()
+	{
+		PressureBody::accumulateExternalForces();
+		
+		for (int i = 0; i < mPointCount; i++)
+			mPointMasses[i].Force += Vector2(0.0f, -12.0f) * mPointMasses[i].Mass;
+		
+		const float torque = 70.0f;
+		const float maxOmega = 25.0f;
+		float omegaFactor = (absf(((mDerivedOmega > 0) ? maxOmega : -maxOmega) - mDerivedOmega) / maxOmega) * mTorqueForce * torque;
+		for (int i = 0; i < mPointCount; i++)
+		{
+			Vector2 toPt = VectorTools::rotateVector(mPointMasses[i].Position - mDerivedPos, NEG_PI_OVER_ONE_POINT_TWO);
+			mPointMasses[i].Force += toPt * omegaFactor;
+		}
+		
+		Vector2 shock = mShockForce / (float)mPointCount;
+		for (int i = 0; i < mPointCount; i++)
+			mPointMasses[i].Force += shock;
+	}
+
+private:
+	float		mTorqueForce;
+	Vector2		mShockForce;
+};
+
+class LevelChassis : public SpringBody
+{
+public:
+	struct Shock
+	{
+		int				point;
+		LevelTire*		tire;
+		float			length;
+		float			k;
+		float			damp;
+	};
+	
+	LevelChassis( World* w, const ClosedShape& shape, const Vector2& pos ) :
+		SpringBody(w, shape, 1.0f, 1000.0f, 10.0f, 300.0f, 20.0f, pos, 0.0f, Vector2::One, false)
+	{
+		mTorque = 0.0f;
+	}
+	
+	void setTorque( float t ) { mTorque = t; }
+	
+	void addShock( int point, LevelTire* tire, float length, float k, float damp )
+	{
+		Shock s = { point, tire, length, k, damp };
+		mShocks.push_back(s);
+	}
+	
+	void accumulateExternalForces()
+	{
+		SpringBody::accumulateExternalForces();
+		
+		for (int i = 0; i < mPointCount; i++)
+			mPointMasses[i].Force += Vector2(0.0f, -12.0f) * mPointMasses[i].Mass;
+		
+		for (unsigned int i = 0; i < mShocks.size(); i++)
+		{
+			const Shock& s = mShocks[i];
+			Vector2 force = VectorTools::calculateSpringForce(mPointMasses[s.point].Position, mPointMasses[s.point].Velocity,
+				s.tire->getDerivedPosition(), s.tire->getDerivedVelocity(), s.length, s.k, s.damp);
+			mPointMasses[s.point].Force += force;
+			s.tire->addShockForce(-force);
+		}
+		
+		const float torqueForce = 40.0f;
+		const float maxOmega = 5.0f;
+		float omegaFactor = (absf(((mDerivedOmega > 0) ? maxOmega : -maxOmega) - mDerivedOmega) / maxOmega) * torqueForce * mTorque;
+		for (int i = 0; i < mPointCount; i++)
+		{
+			Vector2 toPt = VectorTools::rotateVector(mPointMasses[i].Position - mDerivedPos, NEG_PI_OVER_ONE_POINT_TWO);
+			mPointMasses[i].Force += toPt * omegaFactor;
+		}
+	}
+
+private:
+	std::vector<Shock>	mShocks;
+	float				mTorque;
+};
+
+class LevelCar
+{
+public:
+	LevelCar( World* w, const Vector2& pos )
+	{
+		const float verts[][2] = { { -1.7f, -0.6f }, { -1.7f, -0.2f }, { -1.1f, 0.0f }, { -0.7f, 0.6f }, { 0.0f, 0.6f }, { 0.5f, 0.6f }, { 1.1f, 0.0f },
+			{ 2.1f, -0.2f }, { 2.1f, -0.6f }, { 1.1f, -0.6f }, { 0.5f, -0.6f }, { 0.0f, -0.6f }, { -0.5f, -0.6f }, { -1.1f, -0.6f } };
+		const int springs[][2] = { { 0, 2 }, { 1, 13 }, { 2, 13 }, { 2, 12 }, { 3, 13 }, { 3, 12 }, { 3, 11 }, { 12, 4 }, { 4, 11 },
+			{ 4, 10 }, { 5, 11 }, { 5, 10 }, { 5, 9 }, { 6, 10 }, { 6, 9 }, { 6, 8 }, { 7, 9 } };
+		
+		ClosedShape chassisShape;
+		chassisShape.begin();
+		for (unsigned int i = 0; i < sizeof(verts) / sizeof(verts[0]); i++)
+			chassisShape.addVertex(Vector2(verts[i][0], verts[i][1]));
+		chassisShape.finish();
+		
+		ClosedShape tireShape;
+		tireShape.begin();
+		for (int i = 0; i < 360; i += 20)
+			tireShape.addVertex(Vector2(cosf(VectorTools::degToRad((float)-i)) * 0.3f, sinf(VectorTools::degToRad((float)-i)) * 0.3f));
+		tireShape.finish();
+		
+		mChassis = new LevelChassis(w, chassisShape, pos);
+		mChassis->setMaterial(2);
+		for (unsigned int i = 0; i < sizeof(springs) / sizeof(springs[0]); i++)
+			mChassis->addInternalSpring(springs[i][0], springs[i][1], 600.0f, 20.0f);
+		
+		mTires[0] = new LevelTire(w, tireShape, pos + Vector2(1.5f, -0.3f));
+		mTires[1] = new LevelTire(w, tireShape, pos + Vector2(-1.3f, -0.3f));
+		mTires[0]->setMaterial(3);
+		mTires[1]->setMaterial(3);
+		
+		mChassis->addShock(9, mTires[0], 0.5f, 1000.0f, 50.0f);
+		mChassis->addShock(8, mTires[0], 0.65f, 1000.0f, 50.0f);
+		mChassis->addShock(6, mTires[0], 1.0f, 1000.0f, 50.0f);
+		mChassis->addShock(7, mTires[0], 0.9f, 1000.0f, 50.0f);
+		mChassis->addShock(11, mTires[0], 1.5f, 5000.0f, 50.0f);
+		mChassis->addShock(0, mTires[1], 0.75f, 1000.0f, 50.0f);
+		mChassis->addShock(12, mTires[1], 0.6f, 1000.0f, 50.0f);
+		mChassis->addShock(1, mTires[1], 1.1f, 1000.0f, 50.0f);
+		mChassis->addShock(4, mTires[1], 2.0f, 1000.0f, 50.0f);
+		mChassis->addShock(11, mTires[1], 1.06f, 5000.0f, 50.0f);
+	}
+	
+	~LevelCar()
+	{
+		delete mTires[1];
+		delete mTires[0];
+		delete mChassis;
+	}
+	
+	// the arrow keys: torque on the tires to drive, and on the chassis to lean.
+	void setInput( float drive, float lean )
+	{
+		mTires[0]->setTorque(drive);
+		mTires[1]->setTorque(drive);
+		mChassis->setTorque(lean);
+	}
+	
+	// after every update, like Car::clearForces().
+	void clearForces()
+	{
+		mTires[0]->setShockForce(Vector2::Zero);
+		mTires[1]->setShockForce(Vector2::Zero);
+	}
+	
+	Vector2 getPosition() { return mChassis->getDerivedPosition(); }
+
+private:
+	LevelChassis*	mChassis;
+	LevelTire*		mTires[2];
+};
+
+// the input the car gets, from step on until the next entry.
+struct ScriptStep
+{
+	int		step;
+	float	drive;
+	float	lean;
+};
+
+static const ScriptStep Script[] = {
+	{ 0, 0.0f, 0.0f },			// settle.
+	{ 250, 1.0f, 0.0f },
+	{ 1800, 1.0f, 1.0f },
+	{ 1900, 1.0f, 0.0f },
+	{ 3200, -1.0f, 0.0f },		// back up a little.
+	{ 3500, 0.0f, 0.0f },
+	{ 3600, 1.0f, 0.0f },
+	{ 5000, 1.0f, -1.0f },
+	{ 5100, 1.0f, 0.0f },
+};
+
+// materials, as set up by LevelManager::InitPhysic: 0 ground, 1 objects, 2 chassis, 3 tires, 4 ice, 5 items,
+// 6 balloon, 7 and 8 for special objects.
+static void initMaterials( World& world )
+{
+	for (int i = 0; i < 9; i++)
+		world.addMaterial();
+	
+	world.setMaterialPairCollide(2, 3, false);
+	world.setMaterialPairCollide(3, 3, false);
+	world.setMaterialPairCollide(0, 2, true);
+	world.setMaterialPairCollide(0, 3, true);
+	world.setMaterialPairData(0, 3, 1.0f, 0.0f);
+	world.setMaterialPairData(1, 3, 1.0f, 0.0f);
+	world.setMaterialPairCollide(0, 0, false);
+	world.setMaterialPairData(0, 1, 0.4f, 1.0f);
+	world.setMaterialPairData(3, 4, 0.0f, 0.0f);
+	world.setMaterialPairData(2, 4, 0.0f, 0.0f);
+	world.setMaterialPairCollide(0, 4, false);
+	world.setMaterialPairCollide(4, 4, false);
+	world.setMaterialPairData(1, 4, 0.0f, 0.0f);
+	world.setMaterialPairCollide(0, 5, false);
+	world.setMaterialPairCollide(1, 5, false);
+	world.setMaterialPairCollide(2, 5, true);
+	world.setMaterialPairCollide(3, 5, true);
+	world.setMaterialPairCollide(4, 5, false);
+	world.setMaterialPairCollide(5, 5, false);
+	world.setMaterialPairCollide(6, 5, false);
+	world.setMaterialPairCollide(0, 7, true);
+	world.setMaterialPairCollide(7, 7, true);
+	world.setMaterialPairCollide(2, 7, false);
+	world.setMaterialPairCollide(3, 7, false);
+	world.setMaterialPairCollide(2, 6, false);
+	world.setMaterialPairCollide(3, 6, false);
+}
+
+// a compiled level, in memory.  the layout is the structs' own, as the game's level compiler wrote them.
+class LevelData
+{
+public:
+	LevelData() : mPos(0) { }
+	
+	std::vector<unsigned char>& getBytes() { return mBytes; }
+	
+	template <class T>
+	void write( const T* values, int count )
+	{
+		const unsigned char* bytes = (const unsigned char*)values;
+		mBytes.insert(mBytes.end(), bytes, bytes + (sizeof(T) * count));
+	}
+	
+	template <class T>
+	void write( const T& value ) { write(&value, 1); }
+	
+	// false once the data runs out.
+	template <class T>
+	bool read( T* values, int count )
+	{
+		if ((count < 0) || ((mBytes.size() - mPos) < (sizeof(T) * count)))
+			return false;
+		
+		memcpy((void*)values, &mBytes[0] + mPos, sizeof(T) * count);
+		mPos += sizeof(T) * count;
+		return true;
+	}
+	
+	template <class T>
+	bool read( T& value ) { return read(&value, 1); }
+
+private:
+	std::vector<unsigned char>	mBytes;
+	size_t						mPos;
+};
+
+// one body definition of a level, the game's BodyObject.
+struct LevelBodyObject
+{
+	BodyObjectInfo				info;
+	std::vector<BodyPoint>		points;
+	std::vector<BodySpring>		springs;
+	std::vector<BodyPolygon>	polygons;
+};
+
+struct Level
+{
+	std::vector<Body*>			bodies;
+	std::vector<LevelControl>	controls;
+	Vector2						carPos;
+	float						finishX;
+	float						finishY;
+	float						fallLine;
+	
+	~Level()
+	{
+		for (unsigned int i = 0; i < bodies.size(); i++)
+			delete bodies[i];
+	}
+};
+
+// the body building half of LevelSoftBody.
+static Body* createLevelBody( World* world, const LevelBodyObject& object, const GameObject& placement )
+{
+	const BodyObjectInfo& info = object.info;
+	
+	ClosedShape shape;
+	shape.begin();
+	for (unsigned int i = 0; i < object.points.size(); i++)
+		shape.addVertex(Vector2(object.points[i].x, object.points[i].y));
+	shape.finish((info.massPerPoint != 0.0f) && (!info.isKinematic));
+	
+	Vector2 pos(placement.posX, placement.posY);
+	float angle = VectorTools::degToRad(placement.angle);
+	Vector2 scale(placement.scaleX, placement.scaleY);
+	
+	SpringBody* body;
+	if (!info.pressureized)
+	{
+		body = new LevelSpringBody(world, shape, info.massPerPoint, info.edgeK, info.edgeDamping, pos, angle, scale, info.isKinematic);
+		if (info.shapeMatching)
+		{
+			body->setShapeMatching(true);
+			body->setShapeMatchingConstants(info.shapeK, info.shapeDamping);
+		}
+	}
+	else
+	{
+		body = new LevelPressureBody(world, shape, info.massPerPoint, info.pressure, info.shapeK, info.shapeDamping, info.edgeK, info.edgeDamping, pos, angle, scale, info.isKinematic);
+	}
+	
+	body->setMaterial(placement.material);
+	body->setVelocityDamping(0.993f);
+	
+	for (unsigned int i = 0; i < object.points.size(); i++)
+	{
+		if (object.points[i].mass != -1)
+			body->setMassIndividual(i, object.points[i].mass);
+	}
+	
+	for (unsigned int i = 0; i < object.springs.size(); i++)
+		body->addInternalSpring(object.springs[i].pt1, object.springs[i].pt2, object.springs[i].k, object.springs[i].damp);
+	
+	return body;
+}
+
+// read a level like LevelManager::LoadCompiledLevel does.  false if the data ends early or places a body it
+// has no definition for.
+static bool loadCompiledLevel( World* world, LevelData& data, Level& level )
+{
+	std::vector<LevelBodyObject> objects;
+	
+	int objectCount = 0;
+	if (!data.read(objectCount))
+		return false;
+	
+	for (int i = 0; i < objectCount; i++)
+	{
+		LevelBodyObject object;
+		int count = 0;
+		
+		if ((!data.read(object.info)) || (!data.read(count)))
+			return false;
+		
+		object.points.resize(count);
+		if ((!data.read(object.points.data(), count)) || (!data.read(count)))
+			return false;
+		
+		object.springs.resize(count);
+		if ((!data.read(object.springs.data(), count)) || (!data.read(count)))
+			return false;
+		
+		// polygons are only for drawing.
+		object.polygons.resize(count);
+		if (!data.read(object.polygons.data(), count))
+			return false;
+		
+		objects.push_back(object);
+	}
+	
+	int placementCount = 0;
+	if (!data.read(placementCount) || (placementCount < 0))
+		return false;
+	
+	std::vector<GameObject> placements(placementCount);
+	if (!data.read(placements.data(), placementCount))
+		return false;
+	
+	AABB limits;
+	for (int i = 0; i < placementCount; i++)
+	{
+		const GameObject& placement = placements[i];
+		
+		int object = -1;
+		for (unsigned int j = 0; j < objects.size(); j++)
+		{
+			if (strncmp(placement.name, objects[j].info.name, sizeof(placement.name)) == 0)
+			{
+				object = (int)j;
+				break;
+			}
+		}
+		
+		if (object < 0)
+			return false;
+		
+		Body* body = createLevelBody(world, objects[object], placement);
+		level.bodies.push_back(body);
+		
+		Vector2 pos(placement.posX, placement.posY);
+		if (placement.isPlatform)
+		{
+			LevelControl c;
+			c.body = body;
+			c.motor = false;
+			c.start = pos;
+			c.end = pos + Vector2(placement.platformOffsetX, placement.platformOffsetY);
+			c.factor = TWO_PI / placement.platformSecondsPerLoop;
+			c.i = HALF_PI + (TWO_PI * placement.platformStartOffset);
+			c.speed = 0.0f;
+			level.controls.push_back(c);
+			
+			if (placement.platformStartOffset != 0.0f)
+			{
+				Vector2 startPos = c.start.lerp(c.end, 0.5f + (sinf(HALF_PI + (PI * 2.0f * placement.platformStartOffset)) * 0.5f));
+				body->setPositionAngle(startPos, VectorTools::degToRad(placement.angle), Vector2(placement.scaleX, placement.scaleY));
+			}
+		}
+		
+		if (placement.isMotor)
+		{
+			LevelControl c;
+			c.body = body;
+			c.motor = true;
+			c.factor = 0.0f;
+			c.i = 0.0f;
+			c.speed = placement.motorRadiansPerSecond;
+			level.controls.push_back(c);
+		}
+		
+		body->updateAABB(0.0f, true);
+		limits.expandToInclude(body->getAABB().Min);
+		limits.expandToInclude(body->getAABB().Max);
+	}
+	
+	char carName[64];
+	if ((!data.read(carName, 64)) || (!data.read(level.carPos.X)) || (!data.read(level.carPos.Y)))
+		return false;
+	
+	if ((!data.read(level.finishX)) || (!data.read(level.finishY)) || (!data.read(level.fallLine)))
+		return false;
+	
+	world->setWorldLimits(limits.Min, limits.Max);
+	return true;
+}
+
+static LevelBodyObject makeObject( const char* name, float massPerPoint, float edgeK, float edgeDamping, bool kinematic )
+{
+	LevelBodyObject object;
+	memset(&object.info, 0, sizeof(object.info));
+	strncpy(object.info.name, name, sizeof(object.info.name) - 1);
+	object.info.massPerPoint = massPerPoint;
+	object.info.edgeK = edgeK;
+	object.info.edgeDamping = edgeDamping;
+	object.info.isKinematic = kinematic;
+	object.info.shapeK = 100.0f;
+	object.info.shapeDamping = 10.0f;
+	return object;
+}
+
+static void addPoint( LevelBodyObject& object, float x, float y )
+{
+	BodyPoint p = { x, y, -1.0f };
+	object.points.push_back(p);
+}
+
+static void addSpring( LevelBodyObject& object, int a, int b, float k, float damp )
+{
+	BodySpring s = { a, b, k, damp };
+	object.springs.push_back(s);
+}
+
+static GameObject makePlacement( const char* name, float x, float y, float angle, int material )
+{
+	GameObject placement;
+	memset(&placement, 0, sizeof(placement));
+	strncpy(placement.name, name, sizeof(placement.name) - 1);
+	placement.posX = x;
+	placement.posY = y;
+	placement.angle = angle;
+	placement.scaleX = 1.0f;
+	placement.scaleY = 1.0f;
+	placement.material = material;
+	return placement;
+}
+
+// the built-in level: 200 units of bumpy ground with ramps, rows of boxes and balls along the way, a spinning
+// bar to drive under and a platform moving overhead.
+static void buildLevel( LevelData& data )
+{
+	const float length = 200.0f;
+	const int groundPoints = 600;
+	
+	std::vector<LevelBodyObject> objects;
+	
+	LevelBodyObject ground = makeObject("ground", 0.0f, 100.0f, 1.0f, false);
+	addPoint(ground, -10.0f, -5.0f);
+	for (int i = 0; i < groundPoints; i++)
+	{
+		float x = -10.0f + ((length + 10.0f) * i) / (groundPoints - 1);
+		addPoint(ground, x, (0.3f * sinf(x * 0.35f)) + (0.05f * sinf(x * 2.3f)));
+	}
+	addPoint(ground, length, -5.0f);
+	objects.push_back(ground);
+	
+	LevelBodyObject ramp = makeObject("ramp", 0.0f, 100.0f, 1.0f, false);
+	addPoint(ramp, -3.0f, -1.0f);
+	addPoint(ramp, 0.0f, 0.8f);
+	addPoint(ramp, 1.0f, 0.8f);
+	addPoint(ramp, 3.0f, -1.0f);
+	objects.push_back(ramp);
+	
+	// boxes with a point halfway along each side and springs across, held in shape by shape matching.
+	LevelBodyObject box = makeObject("box", 1.0f, 300.0f, 20.0f, false);
+	box.info.shapeMatching = true;
+	box.info.shapeK = 150.0f;
+	box.info.shapeDamping = 15.0f;
+	const float boxPoints[][2] = { { -0.4f, -0.4f }, { -0.4f, 0.0f }, { -0.4f, 0.4f }, { 0.0f, 0.4f }, { 0.4f, 0.4f }, { 0.4f, 0.0f }, { 0.4f, -0.4f }, { 0.0f, -0.4f } };
+	for (int i = 0; i < 8; i++)
+		addPoint(box, boxPoints[i][0], boxPoints[i][1]);
+	for (int i = 0; i < 4; i++)
+		addSpring(box, i, i + 4, 300.0f, 10.0f);
+	objects.push_back(box);
+	
+	LevelBodyObject ball = makeObject("ball", 1.0f, 300.0f, 20.0f, false);
+	ball.info.pressureized = true;
+	ball.info.pressure = 40.0f;
+	ball.info.shapeK = 300.0f;
+	ball.info.shapeDamping = 20.0f;
+	for (int i = 0; i < 12; i++)
+		addPoint(ball, cosf(-TWO_PI * i / 12) * 0.45f, sinf(-TWO_PI * i / 12) * 0.45f);
+	objects.push_back(ball);
+	
+	LevelBodyObject bar = makeObject("bar", 1.0f, 300.0f, 20.0f, true);
+	addPoint(bar, -2.5f, -0.15f);
+	addPoint(bar, -2.5f, 0.15f);
+	addPoint(bar, 2.5f, 0.15f);
+	addPoint(bar, 2.5f, -0.15f);
+	objects.push_back(bar);
+	
+	std::vector<GameObject> placements;
+	placements.push_back(makePlacement("ground", 0.0f, 0.0f, 0.0f, 0));
+	placements.push_back(makePlacement("ramp", 20.0f, 0.5f, 0.0f, 0));
+	placements.push_back(makePlacement("ramp", 95.0f, 0.5f, 0.0f, 0));
+	placements.push_back(makePlacement("ramp", 150.0f, 0.5f, 0.0f, 0));
+	
+	// rows of soft bodies to push through, every third one a ball.
+	const float rows[] = { 35.0f, 70.0f, 85.0f, 120.0f, 140.0f, 170.0f };
+	int rowBody = 0;
+	for (unsigned int r = 0; r < sizeof(rows) / sizeof(rows[0]); r++)
+	{
+		for (int i = 0; i < 4; i++)
+			placements.push_back(makePlacement(((rowBody++ % 3) == 2) ? "ball" : "box", rows[r] + i, 1.0f, 0.0f, 1));
+	}
+	
+	GameObject motor = makePlacement("bar", 55.0f, 4.5f, 0.0f, 0);
+	motor.isMotor = true;
+	motor.motorRadiansPerSecond = 1.5f;
+	placements.push_back(motor);
+	
+	GameObject platform = makePlacement("bar", 105.0f, 6.0f, 0.0f, 0);
+	platform.isPlatform = true;
+	platform.platformOffsetX = 20.0f;
+	platform.platformSecondsPerLoop = 8.0f;
+	platform.platformStartOffset = 0.25f;
+	placements.push_back(platform);
+	
+	data.write((int)objects.size());
+	for (unsigned int i = 0; i < objects.size(); i++)
+	{
+		const LevelBodyObject& object = objects[i];
+		data.write(object.info);
+		data.write((int)object.points.size());
+		data.write(object.points.data(), (int)object.points.size());
+		data.write((int)object.springs.size());
+		data.write(object.springs.data(), (int)object.springs.size());
+		data.write((int)object.polygons.size());
+		data.write(object.polygons.data(), (int)object.polygons.size());
+	}
+	
+	data.write((int)placements.size());
+	data.write(placements.data(), (int)placements.size());
+	
+	char carName[64];
+	memset(carName, 0, sizeof(carName));
+	strncpy(carName, "car_and_truck", sizeof(carName) - 1);
+	data.write(carName, 64);
+	data.write(0.0f);				// car position.
+	data.write(1.4f);
+	data.write(length - 5.0f);		// finish.
+	data.write(0.0f);
+	data.write(-10.0f);				// fall line.
+}
+
+static bool readFile( const char* fileName, std::vector<unsigned char>& bytes )
+{
+	FILE* file = fopen(fileName, "rb");
+	if (!file)
+		return false;
+	
+	unsigned char buffer[4096];
+	size_t count;
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		bytes.insert(bytes.end(), buffer, buffer + count);
+	
+	fclose(file);
+	return true;
+}
+
+int main( int argc, char** argv )
+{
+	int steps = (argc > 1) ? atoi(argv[1]) : 8000;
+	const char* levelFile = (argc > 2) ? argv[2] : 0;
+	
+	if (steps < 1)
+	{
+		printf("usage: %s [steps] [level.scenec]\n", argv[0]);
+		return 1;
+	}
+	
+	LevelData data;
+	if (levelFile)
+	{
+		if (!readFile(levelFile, data.getBytes()))
+		{
+			printf("can't read %s\n", levelFile);
+			return 1;
+		}
+	}
+	else
+	{
+		buildLevel(data);
+	}
+	
+	World world;
+	initMaterials(world);
+	
+	Level level;
+	if (!loadCompiledLevel(&world, data, level))
+	{
+		printf("%s is not a compiled level\n", levelFile ? levelFile : "the built-in level");
+		return 1;
+	}
+	
+	LevelCar car(&world, level.carPos);
+	
+	printf("JellyPhysics level: %s, %d bodies, %d point masses, %d steps of 0.004s\n\n", levelFile ? levelFile : "built-in",
+		(int)level.bodies.size() + 3, world.getPointMassPool().size(), steps);
+	
+	world.setPhaseTiming(true);
+	
+	int script = 0;
+	const int scriptLength = sizeof(Script) / sizeof(Script[0]);
+	double pairs = 0.0;
+	
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for (int s = 0; s < steps; s++)
+	{
+		while (((script + 1) < scriptLength) && (Script[script + 1].step <= s))
+			script++;
+		car.setInput(Script[script].drive, Script[script].lean);
+		
+		// the game's order within a step.
+		world.update(0.004f);
+		for (unsigned int i = 0; i < level.controls.size(); i++)
+			level.controls[i].update(0.004f);
+		car.clearForces();
+		
+		pairs += world.getBroadphasePairCount();
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	
+	const World::PhaseTimes& times = world.getPhaseTimes();
+	const char* names[] = { "integration", "broadphase", "narrowphase", "collision response" };
+	double phases[] = { times.integration, times.broadphase, times.narrowphase, times.collisionResponse };
+	
+	printf("%-20s %12s %12s %8s\n", "phase", "ms total", "us/step", "share");
+	double timed = 0.0;
+	for (int i = 0; i < 4; i++)
+		timed += phases[i];
+	for (int i = 0; i < 4; i++)
+		printf("%-20s %12.2f %12.2f %7.1f%%\n", names[i], phases[i] * 1000.0, (phases[i] * 1.0e6) / steps, (phases[i] * 100.0) / timed);
+	printf("%-20s %12.2f %12.2f\n", "whole step", elapsed.count(), (elapsed.count() * 1000.0) / steps);
+	
+	// FNV-1a over the raw bits of the pool.
+	PointMassPool& pool = world.getPointMassPool();
+	const unsigned char* bytes = (const unsigned char*)pool.getPositions();
+	unsigned int checksum = 2166136261u;
+	for (size_t i = 0; i < pool.size() * sizeof(Vector2); i++)
+		checksum = (checksum ^ bytes[i]) * 16777619u;
+	
+	Vector2 carPos = car.getPosition();
+	printf("\n%.1f pairs/step, car at %.2f %.2f (finish at %.2f), checksum %x\n", pairs / steps, carPos.X, carPos.Y, level.finishX, checksum);
+	
+	return 0;
+}
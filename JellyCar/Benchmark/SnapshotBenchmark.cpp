@@ -0,0 +1,276 @@
+// Snapshot check for JellyPhysics: a pile of soft boxes and pressure balls dropped into a cup with a bumpy
+// floor, next to a shelf of boxes that fall asleep until a ball is sent rolling into them. Later the ball is
+// pumped up and stiffened and one of the boxes stretched, the way a car changes its tires and chassis. Runs N
+// steps and saves the state, runs M more, then restores the state - into the same world and into a second one
+// built the same way - and runs the M steps again. All three runs have to end in exactly the same state.
+//
+// usage: SnapshotBenchmark [bodies] [N] [M]
+
+#include "JellyPhysics.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace JellyPhysics;
+
+static const Vector2 Gravity(0.0f, -9.8f);
+
+class SnapshotSpringBody : public SpringBody
+{
+public:
+	SnapshotSpringBody( World* w, const ClosedShape& shape, const Vector2& pos ) :
+		SpringBody(w, shape, 1.0f, 1000.0f, 20.0f, 300.0f, 20.0f, pos, 0.0f, Vector2::One, false)
+	{
+		setVelocityDamping(0.993f);
+	}
+
+	void accumulateExternalForces()
+	{
+		for (int i = 0; i < mPointCount; i++)
+			mPointMasses[i].Force += Gravity * mPointMasses[i].Mass;
+	}
+
+	// widen the shape the body springs back to, and its springs with it.
+	void stretch( float x )
+	{
+		Vector2List& verts = mBaseShape.getVertices();
+		for (unsigned int i = 0; i < verts.size(); i++)
+			verts[i].X *= x;
+
+		for (unsigned int i = 0; i < mSprings.size(); i++)
+			mSprings[i].springD = (verts[mSprings[i].pointMassA] - verts[mSprings[i].pointMassB]).length();
+
+		wake();
+	}
+};
+
+class SnapshotPressureBody : public PressureBody
+{
+public:
+	SnapshotPressureBody( World* w, const ClosedShape& shape, const Vector2& pos ) :
+		PressureBody(w, shape, 1.0f, 40.0f, 300.0f, 20.0f, 300.0f, 20.0f, pos, 0.0f, Vector2::One, false)
+	{
+		setVelocityDamping(0.993f);
+	}
+
+	void accumulateExternalForces()
+	{
+		for (int i = 0; i < mPointCount; i++)
+			mPointMasses[i].Force += Gravity * mPointMasses[i].Mass;
+	}
+};
+
+static ClosedShape makeBox( float width, float height )
+{
+	ClosedShape shape;
+	shape.begin();
+	shape.addVertex(Vector2(0.0f, 0.0f));
+	shape.addVertex(Vector2(0.0f, height));
+	shape.addVertex(Vector2(width, height));
+	shape.addVertex(Vector2(width, 0.0f));
+	shape.finish();
+	return shape;
+}
+
+static ClosedShape makeRing( float radius, int points )
+{
+	ClosedShape shape;
+	shape.begin();
+	for (int i = 0; i < points; i++)
+	{
+		float angle = -TWO_PI * i / points;
+		shape.addVertex(Vector2(cosf(angle) * radius, sinf(angle) * radius));
+	}
+	shape.finish();
+	return shape;
+}
+
+// cup with a bumpy floor, walls up to height, open at the top.
+static ClosedShape makeCup( float width, float height, int floorPoints )
+{
+	float half = width * 0.5f;
+
+	ClosedShape shape;
+	shape.begin();
+	shape.addVertex(Vector2(-half - 1.0f, -1.0f));
+	shape.addVertex(Vector2(-half - 1.0f, height));
+	shape.addVertex(Vector2(-half, height));
+	for (int i = 0; i < floorPoints; i++)
+	{
+		float x = -half + (width * i) / (floorPoints - 1);
+		shape.addVertex(Vector2(x, 0.15f * sinf(x * 1.7f)));
+	}
+	shape.addVertex(Vector2(half, height));
+	shape.addVertex(Vector2(half + 1.0f, height));
+	shape.addVertex(Vector2(half + 1.0f, -1.0f));
+	shape.finish(false);
+	return shape;
+}
+
+class SnapshotScene
+{
+public:
+	// the ball is sent rolling at kickStep, and changed along with one of the boxes at changeStep.
+	SnapshotScene( int bodyCount, int kickStep, int changeStep ) : mStep(0), mKickStep(kickStep), mChangeStep(changeStep)
+	{
+		const int columns = 10;
+		const float width = columns * 1.2f + 1.0f;
+		const float shelfWidth = 16.0f;
+		float height = (bodyCount / columns + 2) * 1.2f;
+
+		mWorld.setSleeping(true);
+		mBodies.push_back(new Body(&mWorld, makeCup(width, height, 40), 0.0f, Vector2::Zero, 0.0f, Vector2::One, false));
+
+		// the shelf starts right of the cup, its top level with the cup's floor.
+		float shelfLeft = width * 0.5f + 1.0f;
+		mBodies.push_back(new Body(&mWorld, makeBox(shelfWidth, 1.0f), 0.0f, Vector2(shelfLeft + shelfWidth * 0.5f, -0.5f), 0.0f, Vector2::One, false));
+
+		ClosedShape box = makeBox(0.8f, 0.8f);
+		ClosedShape ball = makeRing(0.45f, 16);
+		for (int i = 0; i < bodyCount; i++)
+		{
+			int row = i / columns;
+			int column = i % columns;
+			Vector2 pos((column - (columns - 1) * 0.5f) * 1.2f + ((row & 1) ? 0.15f : -0.15f), 1.0f + row * 1.2f);
+
+			if ((i % 4) == 0)
+				mBodies.push_back(new SnapshotPressureBody(&mWorld, ball, pos));
+			else
+				mBodies.push_back(new SnapshotSpringBody(&mWorld, box, pos - Vector2(0.4f, 0.4f)));
+		}
+
+		for (int i = 0; i < 5; i++)
+		{
+			SnapshotSpringBody* shelfBox = new SnapshotSpringBody(&mWorld, box, Vector2(shelfLeft + 1.0f + (i * 2.0f), 0.45f));
+			mBodies.push_back(shelfBox);
+			if (i == 4)
+				mStretchBox = shelfBox;
+		}
+
+		mBall = new SnapshotPressureBody(&mWorld, ball, Vector2(shelfLeft + 11.5f, 0.5f));
+		mBodies.push_back(mBall);
+
+		mWorld.setWorldLimits(Vector2(-width * 0.5f - 2.0f, -2.0f), Vector2(shelfLeft + shelfWidth + 1.0f, height + 2.0f));
+	}
+
+	~SnapshotScene()
+	{
+		for (unsigned int i = 0; i < mBodies.size(); i++)
+			delete mBodies[i];
+	}
+
+	World& getWorld() { return mWorld; }
+
+	// the step count is scripting state of the scene, not of the world, so it is restored separately.
+	int getStep() { return mStep; }
+	void setStep( int step ) { mStep = step; }
+
+	void run( int steps )
+	{
+		for (int s = 0; s < steps; s++)
+		{
+			if (mStep == mKickStep)
+				mBall->setVelocity(Vector2(-6.0f, 0.0f));
+
+			if (mStep == mChangeStep)
+			{
+				mBall->setGasPressure(mBall->getGasPressure() * 2.0f);
+				mBall->setEdgeSpringConstants(600.0f, 30.0f);
+				mStretchBox->stretch(1.5f);
+			}
+
+			mWorld.update(0.004f);
+			mStep++;
+		}
+	}
+
+	// FNV-1a over the saved state, which covers everything restoreState() puts back.
+	unsigned int hash()
+	{
+		std::vector<unsigned char> state;
+		mWorld.saveState(state);
+
+		unsigned int h = 2166136261u;
+		for (unsigned int i = 0; i < state.size(); i++)
+			h = (h ^ state[i]) * 16777619u;
+		return h;
+	}
+
+private:
+	World				mWorld;
+	std::vector<Body*>		mBodies;
+	SnapshotPressureBody*	mBall;
+	SnapshotSpringBody*		mStretchBox;
+	int						mStep;
+	int						mKickStep;
+	int						mChangeStep;
+};
+
+int main( int argc, char** argv )
+{
+	int bodyCount = (argc > 1) ? atoi(argv[1]) : 60;
+	int before = (argc > 2) ? atoi(argv[2]) : 1000;
+	int after = (argc > 3) ? atoi(argv[3]) : 1000;
+
+	if ((bodyCount < 1) || (before < 0) || (after < 1))
+	{
+		printf("usage: %s [bodies] [N] [M]\n", argv[0]);
+		return 1;
+	}
+
+	printf("JellyPhysics snapshot check: %d bodies, snapshot after %d steps, then %d more\n\n", bodyCount, before, after);
+
+	// the ball goes after the snapshot, into boxes that have been asleep for a while, and is changed once it
+	// has hit them, so restoring has to undo the changes too.
+	int kickStep = before + (after / 4);
+	int changeStep = before + (after / 2);
+
+	SnapshotScene scene(bodyCount, kickStep, changeStep);
+	scene.run(before);
+
+	const int repeats = 100;
+	std::vector<unsigned char> snapshot;
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < repeats; i++)
+		scene.getWorld().saveState(snapshot);
+	std::chrono::duration<double, std::micro> saveTime = std::chrono::high_resolution_clock::now() - start;
+
+	World::Stats stats = scene.getWorld().getStats();
+	printf("snapshot           %10u bytes, %d bodies awake, %d asleep\n", (unsigned int)snapshot.size(), stats.awakeBodies, stats.asleepBodies);
+
+	scene.run(after);
+	unsigned int expected = scene.hash();
+
+	stats = scene.getWorld().getStats();
+	printf("after %5d steps   %10d bodies awake, %d asleep\n", after, stats.awakeBodies, stats.asleepBodies);
+
+	start = std::chrono::high_resolution_clock::now();
+	bool restored = true;
+	for (int i = 0; i < repeats; i++)
+		restored = restored && scene.getWorld().restoreState(snapshot);
+	std::chrono::duration<double, std::micro> restoreTime = std::chrono::high_resolution_clock::now() - start;
+
+	printf("save / restore     %10.2f / %.2f us\n\n", saveTime.count() / repeats, restoreTime.count() / repeats);
+
+	scene.setStep(before);
+	scene.run(after);
+	unsigned int rerun = scene.hash();
+
+	SnapshotScene ghost(bodyCount, kickStep, changeStep);
+	bool ghostRestored = ghost.getWorld().restoreState(snapshot);
+	ghost.setStep(before);
+	ghost.run(after);
+	unsigned int ghostRun = ghost.hash();
+
+	printf("%-18s %10x\n", "first run", expected);
+	printf("%-18s %10x%s\n", "restored", rerun, restored ? "" : "  (restore FAILED)");
+	printf("%-18s %10x%s\n", "restored elsewhere", ghostRun, ghostRestored ? "" : "  (restore FAILED)");
+
+	bool same = (restored && ghostRestored && (rerun == expected) && (ghostRun == expected));
+	printf("\nresults %s\n", same ? "identical" : "DIFFER");
+
+	return same ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+// Stress scene for the JellyPhysics broadphase: hundreds of soft bodies resting
+// on the shelves of one narrow bookcase. Every body shares the same X span, the
+// worst case for a single-axis sweep. Each broadphase also runs with a
+// multithreaded narrowphase, which has to end up exactly where one thread does.
+//
+// usage: StressBenchmark [bodies] [steps] [threads]
+
+#include "JellyPhysics.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+using namespace JellyPhysics;
+
+// spring body with gravity, like GameSpringBody in the game.
+class StressBody : public SpringBody
+{
+public:
+	StressBody( World* w, const ClosedShape& shape, const Vector2& pos ) :
+		SpringBody(w, shape, 1.0f, 1000.0f, 20.0f, 300.0f, 20.0f, pos, 0.0f, Vector2::One, false)
+	{
+		setVelocityDamping(0.993f);
+	}
+
+	void accumulateExternalForces()
+	{
+		for (unsigned int i = 0; i < mPointMasses.size(); i++)
+			mPointMasses[i].Force += Vector2(0.0f, -9.8f * mPointMasses[i].Mass);
+	}
+};
+
+static ClosedShape makeBox( float width, float height )
+{
+	ClosedShape shape;
+	shape.begin();
+	shape.addVertex(Vector2(0.0f, 0.0f));
+	shape.addVertex(Vector2(0.0f, height));
+	shape.addVertex(Vector2(width, height));
+	shape.addVertex(Vector2(width, 0.0f));
+	shape.finish();
+	return shape;
+}
+
+static ClosedShape makeRing( float radius, int points )
+{
+	ClosedShape shape;
+	shape.begin();
+	for (int i = 0; i < points; i++)
+	{
+		float angle = -TWO_PI * i / points;
+		shape.addVertex(Vector2(cosf(angle) * radius, sinf(angle) * radius));
+	}
+	shape.finish();
+	return shape;
+}
+
+struct StressResult
+{
+	double	msPerStep;
+	double	pairsPerStep;
+	float	averageHeight;
+	unsigned int	checksum;	// of every point position, to compare runs exactly.
+};
+
+static StressResult runStress( World::BroadphaseType type, int threads, int bodyCount, int steps )
+{
+	const int columns = 12;
+	const int rowsPerShelf = 5;
+	const float spacing = 1.1f;
+	const float shelfPitch = rowsPerShelf * spacing + 1.5f;
+
+	World world;
+	world.setBroadphase(type);
+	world.setThreadCount(threads);
+
+	std::vector<Body*> bodies;
+
+	// shelves (the lowest one is the floor) and the two side walls.
+	int perShelf = columns * rowsPerShelf;
+	int shelves = (bodyCount + perShelf - 1) / perShelf;
+	float halfWidth = columns * spacing * 0.5f + 0.5f;
+	float height = shelves * shelfPitch;
+	for (int i = 0; i < shelves; i++)
+		bodies.push_back(new Body(&world, makeBox(halfWidth * 2.0f, 1.0f), 0.0f, Vector2(0.0f, i * shelfPitch - 0.5f), 0.0f, Vector2::One, false));
+	bodies.push_back(new Body(&world, makeBox(1.0f, height + 1.0f), 0.0f, Vector2(-halfWidth - 0.5f, height * 0.5f - 0.5f), 0.0f, Vector2::One, false));
+	bodies.push_back(new Body(&world, makeBox(1.0f, height + 1.0f), 0.0f, Vector2(halfWidth + 0.5f, height * 0.5f - 0.5f), 0.0f, Vector2::One, false));
+	int staticCount = (int)bodies.size();
+
+	ClosedShape box = makeBox(0.9f, 0.9f);
+	ClosedShape ring = makeRing(0.45f, 12);
+	for (int i = 0; i < bodyCount; i++)
+	{
+		int shelf = i / perShelf;
+		int row = (i % perShelf) / columns;
+		int column = i % columns;
+		Vector2 pos((column - (columns - 1) * 0.5f) * spacing + ((row & 1) ? 0.1f : -0.1f), shelf * shelfPitch + 0.6f + row * spacing);
+		bodies.push_back(new StressBody(&world, ((i % 3) == 0) ? ring : box, pos));
+	}
+
+	world.setWorldLimits(Vector2(-halfWidth - 2.0f, -2.0f), Vector2(halfWidth + 2.0f, height + 2.0f));
+
+	long long pairs = 0;
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for (int s = 0; s < steps; s++)
+	{
+		world.update(0.004f);
+		pairs += world.getBroadphasePairCount();
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+	StressResult result;
+	result.msPerStep = elapsed.count() / steps;
+	result.pairsPerStep = (double)pairs / steps;
+	result.averageHeight = 0.0f;
+	for (unsigned int i = staticCount; i < bodies.size(); i++)
+		result.averageHeight += bodies[i]->getDerivedPosition().Y / bodyCount;
+
+	// FNV-1a over the raw bits of the pool.
+	PointMassPool& pool = world.getPointMassPool();
+	const unsigned char* bytes = (const unsigned char*)pool.getPositions();
+	result.checksum = 2166136261u;
+	for (size_t i = 0; i < pool.size() * sizeof(Vector2); i++)
+		result.checksum = (result.checksum ^ bytes[i]) * 16777619u;
+
+	for (unsigned int i = 0; i < bodies.size(); i++)
+		delete bodies[i];
+
+	return result;
+}
+
+int main( int argc, char** argv )
+{
+	int bodyCount = (argc > 1) ? atoi(argv[1]) : 600;
+	int steps = (argc > 2) ? atoi(argv[2]) : 600;
+	int threads = (argc > 3) ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+	if (threads < 2)
+		threads = 2;
+
+	if ((bodyCount < 1) || (steps < 1))
+	{
+		printf("usage: %s [bodies] [steps] [threads]\n", argv[0]);
+		return 1;
+	}
+
+	printf("JellyPhysics stress scene: %d bodies, %d steps of 0.004s\n", bodyCount, steps);
+	
+	// with fewer cores than threads the threaded rows only show what the hand-off costs.
+	int cores = (int)std::thread::hardware_concurrency();
+	if ((cores > 0) && (cores < threads))
+		printf("only %d hardware thread(s), the %d thread runs share them and can't show a speedup\n", cores, threads);
+	printf("\n");
+	printf("%-18s %8s %12s %10s %16s %12s %10s\n", "broadphase", "threads", "pairs/step", "ms/step", "ms/frame (x6)", "avg height", "checksum");
+
+	const World::BroadphaseType types[] = { World::BroadphaseSweepAndPrune, World::BroadphaseUniformGrid };
+	const char* names[] = { "sweep and prune", "uniform grid" };
+	bool same = true;
+	for (int i = 0; i < 2; i++)
+	{
+		StressResult serial = runStress(types[i], 1, bodyCount, steps);
+		printf("%-18s %8d %12.1f %10.3f %16.3f %12.3f %10x\n", names[i], 1, serial.pairsPerStep, serial.msPerStep, serial.msPerStep * 6.0, serial.averageHeight, serial.checksum);
+
+		StressResult r = runStress(types[i], threads, bodyCount, steps);
+		printf("%-18s %8d %12.1f %10.3f %16.3f %12.3f %10x  (%.2fx)\n", names[i], threads, r.pairsPerStep, r.msPerStep, r.msPerStep * 6.0, r.averageHeight, r.checksum, serial.msPerStep / r.msPerStep);
+
+		if (r.checksum != serial.checksum)
+			same = false;
+	}
+
+	printf("\nthreaded results %s\n", same ? "identical" : "DIFFER");
+
+	return same ? 0 : 1;
+}
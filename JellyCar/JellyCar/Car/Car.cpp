@@ -330,7 +330,7 @@ void Car::update(float elapsed)
 	}
 
 	if (ballon)
-		ballonBody->SetBallonPosition(mChassis->getPointMass(5)->Position, mChassis->getDerivedVelocity());
+		ballonBody->SetBallonPosition(mChassis->getPointMass(5).Position, mChassis->getDerivedVelocity());
 }
 
 void Car::SetChassisTextures(Texture* small, Texture* big)
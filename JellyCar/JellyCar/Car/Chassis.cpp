@@ -131,6 +131,42 @@ void Chassis::InterpolateShape(float x)
 		mShocks[i].interpolateD(x);
 }
 
+void Chassis::saveState(std::vector<unsigned char>& buffer)
+{
+	SpringBody::saveState(buffer);
+
+	writeState(buffer, (int)mShocks.size());
+	for (unsigned int i = 0; i < mShocks.size(); i++)
+	{
+		writeState(buffer, mShocks[i].mD);
+		writeState(buffer, mShocks[i].mK);
+		writeState(buffer, mShocks[i].mDamp);
+	}
+}
+
+bool Chassis::restoreState(StateReader& reader, bool apply)
+{
+	int shockCount = 0;
+	if ((!SpringBody::restoreState(reader, apply)) || (!reader.read(shockCount)) || (shockCount != (int)mShocks.size()))
+		return false;
+
+	for (int i = 0; i < shockCount; i++)
+	{
+		float values[3];
+		if (!reader.read(values, 3))
+			return false;
+
+		if (apply)
+		{
+			mShocks[i].mD = values[0];
+			mShocks[i].mK = values[1];
+			mShocks[i].mDamp = values[2];
+		}
+	}
+
+	return true;
+}
+
 
 
 void Chassis::SetTorque(float t) { torque = t; }
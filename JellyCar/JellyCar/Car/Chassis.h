@@ -61,6 +61,10 @@ public:
 	
 	void InterpolateShape(float x);
 
+	// the spring body's state and the shocks InterpolateShape() changes.
+	void saveState(std::vector<unsigned char>& buffer);
+	bool restoreState(StateReader& reader, bool apply);
+
 	void SetTorque(float t);
 	float GetTorque();
 
@@ -162,7 +162,7 @@ void Tire::Draw(glm::mat4 &proj, Texture* texture)
 
 		for (unsigned int i = 0; i < mPointMasses.size(); i++)
 		{
-			shape[i + 1] = ((PointMass)mPointMasses.at(i)).Position;
+			shape[i + 1] = mPointMasses[i].Position;
 		}
 
 		shape[mPointMasses.size() + 1] = mPointMasses[0].Position;
@@ -296,8 +296,8 @@ void JellyOptions::HandleEvents(GameManager* manager)
 		{
 			if (dragBody != NULL)
 			{
-				PointMass *pm = dragBody->getPointMass(dragPoint);
-				dragBody->setDragForce(VectorTools::calculateSpringForce(pm->Position, pm->Velocity, Vector2(dragX, dragY), Vector2(0, 0), 0.0f, 100.0f, 10.0f), dragPoint);
+				PointMass pm = dragBody->getPointMass(dragPoint);
+				dragBody->setDragForce(VectorTools::calculateSpringForce(pm.Position, pm.Velocity, Vector2(dragX, dragY), Vector2(0, 0), 0.0f, 100.0f, 10.0f), dragPoint);
 			}
 		}
 		else
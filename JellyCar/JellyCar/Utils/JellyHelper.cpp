@@ -29,7 +29,7 @@ JellyHellper* JellyHellper::Instance()
 	return _helper;
 }
 
-void JellyHellper::UpdateLines(VertexArrayObject* vertexArray, std::vector<PointMass> &pointMasses, bool create)
+void JellyHellper::UpdateLines(VertexArrayObject* vertexArray, Body::PointMassList &pointMasses, bool create)
 {
 	unsigned int vertsCount = pointMasses.size();
 	unsigned int indicesCount = pointMasses.size() * 2;
@@ -108,7 +108,7 @@ void JellyHellper::DrawLines(VertexArrayObject* vertexArray, glm::mat4 &proj, gl
 	}
 }
 
-void JellyHellper::UpdateSpringShape(VertexArrayObject* vertexArray, std::vector<PointMass> &pointMasses, int *mIndices, int mIndicesCount, bool create)
+void JellyHellper::UpdateSpringShape(VertexArrayObject* vertexArray, Body::PointMassList &pointMasses, int *mIndices, int mIndicesCount, bool create)
 {
 	unsigned int vertsCount = pointMasses.size();
 	int indicesCount = mIndicesCount;
@@ -242,7 +242,7 @@ std::vector<Vector2> JellyHellper::GetTexturePositions(const AABB& aabb, const B
 	return positions;
 }
 
-void JellyHellper::UpdateTextured(VertexArrayObject* vertexArray, std::vector<PointMass> &pointMasses, std::vector<Vector2> &mTextureList, int *mIndices, int mIndicesCount, bool create)
+void JellyHellper::UpdateTextured(VertexArrayObject* vertexArray, Body::PointMassList &pointMasses, std::vector<Vector2> &mTextureList, int *mIndices, int mIndicesCount, bool create)
 {
 	unsigned int vertsCount = pointMasses.size();
 	int indicesCount = mIndicesCount;
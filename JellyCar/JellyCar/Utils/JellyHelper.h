@@ -31,10 +31,10 @@ public:
 	void LoadShaders();
 
 	//updating and drawing lines
-	void UpdateLines(VertexArrayObject* vertexArray, std::vector<PointMass> &pointMasses,bool create);
+	void UpdateLines(VertexArrayObject* vertexArray, Body::PointMassList &pointMasses,bool create);
 	void DrawLines(VertexArrayObject* vertexArray, glm::mat4 &proj, glm::vec4 &color);
 
-	void UpdateSpringShape(VertexArrayObject* vertexArray, std::vector<PointMass> &pointMasses, int *mIndices, int mIndicesCount, bool create);
+	void UpdateSpringShape(VertexArrayObject* vertexArray, Body::PointMassList &pointMasses, int *mIndices, int mIndicesCount, bool create);
 	void UpdateBlobShape(VertexArrayObject* vertexArray, std::vector<Vector2> &points, int count, bool create);
 	void DrawShape(VertexArrayObject* vertexArray, glm::mat4 &proj, glm::vec4 &color);
 
@@ -42,7 +42,7 @@ public:
 	std::vector<Vector2> GetTexturePositions(const AABB& aabb, const Body::PointMassList& vector);
 
 	void UpdateTexturedBlob(VertexArrayObject* vertexArray, std::vector<Vector2> &points, int count, std::vector<Vector2> &mTetxure, bool create);
-	void UpdateTextured(VertexArrayObject* vertexArray, std::vector<PointMass> &pointMasses, std::vector<Vector2> &mTextureList, int *mIndices, int mIndicesCount, bool create);
+	void UpdateTextured(VertexArrayObject* vertexArray, Body::PointMassList &pointMasses, std::vector<Vector2> &mTextureList, int *mIndices, int mIndicesCount, bool create);
 	void DrawTextured(VertexArrayObject* vertexArray, glm::mat4 &proj, Texture* texture, glm::vec4 &color);
 	
 };
\ No newline at end of file
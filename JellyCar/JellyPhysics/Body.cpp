@@ -35,6 +35,12 @@ namespace JellyPhysics
 		mIgnoreMe = false;
 		mDisable = false;
 		
+		mIsAsleep = false;
+		mRestTime = 0.0f;
+		mSleepNext = 0;
+		mIndex = 0;
+		
+		w->getPointMassPool().allocate(mPointMasses, 0);
 		w->addBody( this );
 	}
 	
@@ -62,6 +68,11 @@ namespace JellyPhysics
 		mIgnoreMe = false;
 		mDisable = false;
 		
+		mIsAsleep = false;
+		mRestTime = 0.0f;
+		mSleepNext = 0;
+		mIndex = 0;
+		
 		setShape(shape);
 		for (int i = 0; i < mPointCount; i++)
 			mPointMasses[i].Mass = massPerPoint;
@@ -98,6 +109,11 @@ namespace JellyPhysics
 		mIgnoreMe = false;
 		mDisable = false;
 		
+		mIsAsleep = false;
+		mRestTime = 0.0f;
+		mSleepNext = 0;
+		mIndex = 0;
+		
 		setShape(shape);
 		for (int i = 0; i < mPointCount; i++)
 			mPointMasses[i].Mass = pointMasses[i];
@@ -114,7 +130,7 @@ namespace JellyPhysics
 	{
 		mSprings.clear();
 		mGlobalShape.clear();
-		mPointMasses.clear();
+		mWorld->getPointMassPool().release(mPointMasses);
 		mEdgeInfo.clear();
 
 		mWorld->removeBody(this);
@@ -127,7 +143,6 @@ namespace JellyPhysics
 		
 		if (mBaseShape.getVertices().size() != mPointCount)
 		{
-			mPointMasses.clear();
 			mGlobalShape.clear();
 			mEdgeInfo.clear();
 			
@@ -136,8 +151,9 @@ namespace JellyPhysics
 			
 			mBaseShape.transformVertices(mDerivedPos, mDerivedAngle, mScale, mGlobalShape);
 			
+			mWorld->getPointMassPool().allocate(mPointMasses, (int)mBaseShape.getVertices().size());
 			for (unsigned int i = 0; i < mBaseShape.getVertices().size(); i++)
-				mPointMasses.push_back(PointMass(0.0f, mGlobalShape[i])); 
+				mPointMasses[i].Position = mGlobalShape[i];
 			
 			EdgeInfo e;
 			e.dir = Vector2::Zero;
@@ -184,10 +200,14 @@ namespace JellyPhysics
 	//--------------------------------------------------------------------
 	void Body::setPositionAngle( const Vector2& pos, float angleInRadians, const Vector2& scale )
 	{
+		wake();
+		
 		mBaseShape.transformVertices(pos, angleInRadians, scale, mGlobalShape);
 		for (int i = 0; i < mPointCount; i++)
 			mPointMasses[i].Position = mGlobalShape[i];
 		
+		mEdgeIndex.invalidate();
+		
 		mDerivedPos = pos;
 		mDerivedAngle = angleInRadians;
 	}
@@ -207,10 +227,14 @@ namespace JellyPhysics
 		Vector2 center = Vector2::Zero;
 		Vector2 vel = Vector2::Zero;
 		
-		for (PointMassList::iterator it = mPointMasses.begin(); it != mPointMasses.end(); it++)
+		PointMassPool* pool = mPointMasses.getPool();
+		Vector2* positions = pool->getPositions() + mPointMasses.getStart();
+		Vector2* velocities = pool->getVelocities() + mPointMasses.getStart();
+		
+		for (int i = 0; i < mPointCount; i++)
 		{
-			center += (*it).Position;
-			vel += (*it).Velocity;
+			center += positions[i];
+			vel += velocities[i];
 		}
 		
 		center *= mInvPC;
@@ -228,7 +252,7 @@ namespace JellyPhysics
 			Vector2 baseNorm = mBaseShape.getVertices()[i];
 			baseNorm.normalise();
 			
-			Vector2 curNorm = mPointMasses[i].Position - mDerivedPos;
+			Vector2 curNorm = positions[i] - mDerivedPos;
 			curNorm.normalise();
 			
 			float dot = baseNorm.dotProduct(curNorm);
@@ -281,19 +305,15 @@ namespace JellyPhysics
 	{
 		if (mIsStatic || mIgnoreMe) { return; }
 		
-		for (PointMassList::iterator it = mPointMasses.begin(); it != mPointMasses.end(); it++)
-			(*it).integrateForce(elapsed);
+		mPointMasses.getPool()->integrate(mPointMasses.getStart(), mPointCount, elapsed);
 	}
 	
 	//--------------------------------------------------------------------
 	void Body::dampenVelocity()
 	{
-		if (mIsStatic || mIgnoreMe) { return; }
+		if (mIsStatic || mIgnoreMe || mIsAsleep) { return; }
 		
-		for (PointMassList::iterator it = mPointMasses.begin(); it != mPointMasses.end(); it++)
-		{
-			(*it).Velocity *= mVelDamping;
-		}
+		mPointMasses.getPool()->dampenVelocity(mPointMasses.getStart(), mPointCount, mVelDamping);
 	}
 	
 	//--------------------------------------------------------------------
@@ -301,19 +321,8 @@ namespace JellyPhysics
 	{
 		if (((!mIsStatic) && (!mIgnoreMe)) || (forceUpdate))
 		{
-			mAABB.clear();
-			for (PointMassList::iterator it = mPointMasses.begin(); it != mPointMasses.end(); it++)
-			{
-				Vector2 p = (*it).Position;
-				mAABB.expandToInclude(p);
-				
-				// expanding for velocity only makes sense for dynamic objects.
-				if (!mIsStatic)
-				{
-					p += (*it).Velocity * elapsed;
-					mAABB.expandToInclude(p);
-				}
-			}
+			// expanding for velocity only makes sense for dynamic objects.
+			mPointMasses.getPool()->getBounds(mPointMasses.getStart(), mPointCount, elapsed, !mIsStatic, mAABB);
 			
 			//printf("Body: %d AABB: min[%f][%f] max[%f][%f]\n", this, mAABB.Min.X, mAABB.Min.Y, mAABB.Max.X, mAABB.Max.Y);
 		}
@@ -334,54 +343,127 @@ namespace JellyPhysics
 	{
 		if (((!mIsStatic) && (!mIgnoreMe)) || (forceUpdate))
 		{
-			for (int i = 0; i < mPointCount; i++)
+			Vector2* positions = mPointMasses.getPool()->getPositions() + mPointMasses.getStart();
+			
+			int i = 0;
+#ifdef JELLY_USE_SSE
+			// four edges at a time, split into x and y registers, as long as none of them wraps around to point 0.
+			// the same steps as Vector2::normalise() below, with its branches turned into masks.
+			static_assert(sizeof(EdgeInfo) == (4 * sizeof(float)), "EdgeInfo is stored one register per edge");
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 minLength = _mm_set1_ps(1.0e-08f);
+			const __m128 signBit = _mm_set1_ps(-0.0f);
+			for (; i + 4 < mPointCount; i += 4)
+			{
+				__m128 a01 = _mm_loadu_ps(&positions[i].X);
+				__m128 a23 = _mm_loadu_ps(&positions[i + 2].X);
+				__m128 b01 = _mm_loadu_ps(&positions[i + 1].X);
+				__m128 b23 = _mm_loadu_ps(&positions[i + 3].X);
+				
+				__m128 ex = _mm_sub_ps(_mm_shuffle_ps(b01, b23, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a01, a23, _MM_SHUFFLE(2, 0, 2, 0)));
+				__m128 ey = _mm_sub_ps(_mm_shuffle_ps(b01, b23, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(a01, a23, _MM_SHUFFLE(3, 1, 3, 1)));
+				
+				__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)));
+				__m128 scale = _mm_cmpgt_ps(length, minLength);
+				__m128 invL = _mm_div_ps(one, _mm_or_ps(_mm_and_ps(scale, length), _mm_andnot_ps(scale, one)));
+				ex = _mm_or_ps(_mm_and_ps(scale, _mm_mul_ps(ex, invL)), _mm_andnot_ps(scale, ex));
+				ey = _mm_or_ps(_mm_and_ps(scale, _mm_mul_ps(ey, invL)), _mm_andnot_ps(scale, ey));
+				
+				// 1.0e-08f is just below 1.0e-08, so <= against it matches the < of the loop below.
+				__m128 flat = _mm_cmple_ps(_mm_andnot_ps(signBit, ey), minLength);
+				__m128 slope = _mm_andnot_ps(flat, _mm_div_ps(ex, _mm_or_ps(_mm_andnot_ps(flat, ey), _mm_and_ps(flat, one))));
+				
+				// EdgeInfo is dir, length, slope: one register each once transposed.
+				_MM_TRANSPOSE4_PS(ex, ey, length, slope);
+				_mm_storeu_ps(&mEdgeInfo[i].dir.X, ex);
+				_mm_storeu_ps(&mEdgeInfo[i + 1].dir.X, ey);
+				_mm_storeu_ps(&mEdgeInfo[i + 2].dir.X, length);
+				_mm_storeu_ps(&mEdgeInfo[i + 3].dir.X, slope);
+			}
+#endif
+			for (; i < mPointCount; i++)
 			{
 				int j = (i < (mPointCount-1)) ? i+1 : 0;
 				
-				Vector2 e = mPointMasses[j].Position - mPointMasses[i].Position;
+				Vector2 e = positions[j] - positions[i];
 				mEdgeInfo[i].length = e.normalise();
 				mEdgeInfo[i].dir = e;
 				mEdgeInfo[i].slope = (absf(e.Y) < 1.0e-08) ? 0.0f : (e.X / e.Y);
 			}
+			
+			mEdgeIndex.invalidate();
 		}
 	}
 	
 	//--------------------------------------------------------------------
-	bool Body::contains( const Vector2& pt )
+	// flips inside for each edge crossed by the line from pt to (endX, pt.Y), see contains().
+	struct EdgeCrossingTest
 	{
-		// basic idea: draw a line from the point to a point known to be outside the body.  count the number of
-		// lines in the polygon it intersects.  if that number is odd, we are inside.  if it's even, we are outside.
-		// in this implementation we will always use a line that moves off in the positive X direction from the point
-		// to simplify things.
-		Vector2 endPt = Vector2(mAABB.Max.X + 0.1f, pt.Y);
-		
-		// line we are testing against goes from pt -> endPt.
-		bool inside = false;
-		Vector2 edgeSt = mPointMasses[0].Position;
-		Vector2 edgeEnd;
-		int c = mPointCount;
-		for (int i = 0; i < c; i++)
+		const Vector2*				positions;
+		const Body::EdgeInfoList*	edgeInfo;
+		int							count;
+		Vector2						pt;
+		float						endX;
+		bool						inside;
+		
+		void visit( int i )
 		{
 			// the current edge is defined as the line from edgeSt -> edgeEnd.
-			if (i < (c - 1))
-				edgeEnd = mPointMasses[i + 1].Position;
-			else
-				edgeEnd = mPointMasses[0].Position;
+			const Vector2& edgeSt = positions[i];
+			const Vector2& edgeEnd = positions[(i < (count - 1)) ? i + 1 : 0];
 			
 			// perform check now...
 			if (((edgeSt.Y <= pt.Y) && (edgeEnd.Y > pt.Y)) || ((edgeSt.Y > pt.Y) && (edgeEnd.Y <= pt.Y)))
 			{
 				// this line crosses the test line at some point... does it do so within our test range?
-				float slope = mEdgeInfo[i].slope; //(edgeEnd.X - edgeSt.X) / (edgeEnd.Y - edgeSt.Y);
+				float slope = (*edgeInfo)[i].slope; //(edgeEnd.X - edgeSt.X) / (edgeEnd.Y - edgeSt.Y);
 				float hitX = edgeSt.X + ((pt.Y - edgeSt.Y) * slope);
 				
-				if ((hitX >= pt.X) && (hitX <= endPt.X))
+				if ((hitX >= pt.X) && (hitX <= endX))
 					inside = !inside;
 			}
-			edgeSt = edgeEnd;
+		}
+	};
+	
+	//--------------------------------------------------------------------
+	bool Body::contains( const Vector2& pt )
+	{
+		// basic idea: draw a line from the point to a point known to be outside the body.  count the number of
+		// lines in the polygon it intersects.  if that number is odd, we are inside.  if it's even, we are outside.
+		// in this implementation we will always use a line that moves off in the positive X direction from the point
+		// to simplify things.
+		EdgeCrossingTest test;
+		test.positions = mPointMasses.getPool()->getPositions() + mPointMasses.getStart();
+		test.edgeInfo = &mEdgeInfo;
+		test.count = mPointCount;
+		test.pt = pt;
+		test.endX = mAABB.Max.X + 0.1f;
+		test.inside = false;
+		
+		// line we are testing against goes from pt -> endPt.
+		EdgeIndex* index = getEdgeIndex();
+		if (index)
+		{
+			index->queryRay(pt, test.endX, test);
+		}
+		else
+		{
+			for (int i = 0; i < mPointCount; i++)
+				test.visit(i);
 		}
 		
-		return inside;
+		return test.inside;
+	}
+	
+	//--------------------------------------------------------------------
+	EdgeIndex* Body::getEdgeIndex()
+	{
+		if ((mPointCount < EdgeIndex::MinEdgeCount) || (!mWorld->getUseEdgeIndex()))
+			return 0;
+		
+		// static bodies rarely move, so they can afford a grid that is slow to build.
+		mEdgeIndex.refresh(mPointMasses.getPool()->getPositions() + mPointMasses.getStart(), mPointCount, mIsStatic);
+		return &mEdgeIndex;
 	}
 	
 	//--------------------------------------------------------------------
@@ -566,26 +648,41 @@ namespace JellyPhysics
 
 	void Body::setVelocity(Vector2 velocity)
 	{
-		for (PointMassList::iterator it = mPointMasses.begin(); it != mPointMasses.end(); it++)
-		{
-			(*it).Velocity = velocity;
-		}
+		wake();
+		mPointMasses.getPool()->setVelocity(mPointMasses.getStart(), mPointCount, velocity);
 	}
 	
 	//--------------------------------------------------------------------
 	void Body::addGlobalForce( const Vector2& pt, const Vector2& force )
 	{
+		wake();
+		
 		Vector2 R = (mDerivedPos - pt);
 		
 		float torqueF = R.crossProduct(force);
 		
-		for (PointMassList::iterator it = mPointMasses.begin(); it != mPointMasses.end(); it++)
+		for (int i = 0; i < mPointCount; i++)
 		{
-			Vector2 toPt = ((*it).Position - mDerivedPos);
+			PointMass pm = mPointMasses[i];
+			Vector2 toPt = (pm.Position - mDerivedPos);
 			Vector2 torque = JellyPhysics::VectorTools::rotateVector(toPt, -HALF_PI);
 			
-			(*it).Force += torque * torqueF;
-			(*it).Force += force;
+			pm.Force += torque * torqueF;
+			pm.Force += force;
+		}
+	}
+	
+	//--------------------------------------------------------------------
+	void Body::wake()
+	{
+		Body* b = this;
+		while ((b) && (b->mIsAsleep))
+		{
+			Body* next = b->mSleepNext;
+			b->mIsAsleep = false;
+			b->mRestTime = 0.0f;
+			b->mSleepNext = 0;
+			b = next;
 		}
 	}
 
@@ -7,10 +7,12 @@
 #include "Bitmask.h"
 #include "AABB.h"
 #include "PointMass.h"
+#include "EdgeIndex.h"
 #include "InternalSpring.h"
 
 #include <vector>
 #include <string>
+#include <string.h>
 
 namespace JellyPhysics 
 {
@@ -23,7 +25,7 @@ namespace JellyPhysics
 		std::string _name;
 
 	public:
-		typedef std::vector<PointMass> PointMassList;
+		typedef JellyPhysics::PointMassList PointMassList;
 		typedef std::vector<InternalSpring>	SpringList;
 		
 		struct EdgeInfo
@@ -38,8 +40,9 @@ namespace JellyPhysics
 		World*					mWorld;
 		ClosedShape				mBaseShape;
 		Vector2List				mGlobalShape;
-		PointMassList			mPointMasses;
+		PointMassList			mPointMasses;		// this body's range in the world's PointMassPool.
 		EdgeInfoList			mEdgeInfo;
+		EdgeIndex				mEdgeIndex;
 		Vector2					mScale;
 		Vector2					mDerivedPos;
 		Vector2					mDerivedVel;
@@ -60,6 +63,11 @@ namespace JellyPhysics
 		bool					mIgnoreMe;
 		bool					mDisable;
 		
+		bool					mIsAsleep;
+		float					mRestTime;			// how long this body has been moving slower than the world's sleep thresholds.
+		Body*					mSleepNext;			// next body of the island this one went to sleep with, in a ring.
+		int						mIndex;				// position in the world's body list, set by World where it needs it.
+		
 		int 					dragPoint;
 		Vector2 				dragForce;
 		
@@ -132,13 +140,16 @@ namespace JellyPhysics
 		
 		bool contains( const Vector2& pt );
 		
+		// up to date edge index, or 0 if this body has too few edges to need one.
+		EdgeIndex* getEdgeIndex();
+		
 		float getClosestPoint( const Vector2& pt, Vector2& hitPt, Vector2& norm, int& pointA, int& pointB, float& edgeD );
 		float getClosestPointOnEdge( const Vector2& pt, int edgeNum, Vector2& hitPt, Vector2& norm, float& edgeD );
 		float getClosestPointOnEdgeSquared( const Vector2& pt, int edgeNum, Vector2& hitPt, Vector2& norm, float& edgeD );
 		int getClosestPointMass( const Vector2& pos, float& dist );
 		
 		int getPointMassCount() { return mPointCount; }
-		PointMass* getPointMass( int index ) { return &mPointMasses[index]; }
+		PointMass getPointMass( int index ) { return mPointMasses[index]; }
 		
 		void addGlobalForce( const Vector2& pt, const Vector2& force );
 		
@@ -167,10 +178,58 @@ namespace JellyPhysics
 		
 		void setDragForce(Vector2 force, int pm)
 		{
+			wake();
 			dragForce = force * 2;
 			dragPoint = pm;
 		}
 		
+		// asleep bodies are left out of the simulation until something touches them, see World::setSleeping().
+		bool getIsAsleep() { return mIsAsleep; }
+		
+		// wake this body, and every body of the island it went to sleep with.
+		void wake();
+		
+		// walks a buffer written by World::saveState().  values are copied as they are laid out in memory.
+		struct StateReader
+		{
+			const unsigned char*	pos;
+			const unsigned char*	end;
+			
+			// copy the next count values out, or skip over them if values is 0.  false if the buffer is too short.
+			template <class T>
+			bool read( T* values, int count )
+			{
+				if ((count < 0) || ((size_t)(end - pos) < (sizeof(T) * count)))
+					return false;
+				
+				if (values)
+					memcpy((void*)values, pos, sizeof(T) * count);
+				pos += sizeof(T) * count;
+				return true;
+			}
+			
+			template <class T>
+			bool read( T& value ) { return read(&value, 1); }
+		};
+		
+		template <class T>
+		static void writeState( std::vector<unsigned char>& buffer, const T* values, int count )
+		{
+			const unsigned char* bytes = (const unsigned char*)values;
+			buffer.insert(buffer.end(), bytes, bytes + (sizeof(T) * count));
+		}
+		
+		template <class T>
+		static void writeState( std::vector<unsigned char>& buffer, const T& value ) { writeState(buffer, &value, 1); }
+		
+		// state a subclass changes while the world runs (spring lengths, gas pressure and the like), appended to
+		// World::saveState() after the body's own.
+		virtual void saveState( std::vector<unsigned char>& buffer ) { }
+		
+		// read back what saveState() wrote, false if it doesn't fit this body.  only changes the body if apply, and
+		// is always called with apply false first.
+		virtual bool restoreState( StateReader& reader, bool apply ) { return true; }
+		
 	};
 }
 
@@ -0,0 +1,240 @@
+#include "EdgeIndex.h"
+
+#include <math.h>
+
+namespace JellyPhysics
+{
+	
+	void EdgeIndex::refresh( const Vector2* positions, int count, bool useGrid )
+	{
+		if ((!mDirty) && (count == mEdgeCount) && (useGrid == mUseGrid))
+			return;
+		
+		bool rebuildTree = ((count != mEdgeCount) || (useGrid != mUseGrid) || mNodes.empty());
+		
+		mEdgeCount = count;
+		mUseGrid = useGrid;
+		mDirty = false;
+		
+		if (mEdgeCount == 0)
+			return;
+		
+		if (mUseGrid)
+		{
+			_buildGrid(positions);
+		}
+		else
+		{
+			if (rebuildTree)
+				_buildTree();
+			
+			_refitTree(positions);
+		}
+	}
+	
+	void EdgeIndex::_buildGrid( const Vector2* positions )
+	{
+		// cells about the size of an average edge, but no more than a few cells per edge.
+		Vector2 min = positions[0];
+		Vector2 max = positions[0];
+		float totalLength = 0.0f;
+		for (int i = 0; i < mEdgeCount; i++)
+		{
+			const Vector2& p = positions[i];
+			min.X = std::min(min.X, p.X);
+			min.Y = std::min(min.Y, p.Y);
+			max.X = std::max(max.X, p.X);
+			max.Y = std::max(max.Y, p.Y);
+			
+			totalLength += (positions[(i < (mEdgeCount - 1)) ? i + 1 : 0] - p).length();
+		}
+		
+		Vector2 size = max - min;
+		mCellSize = std::max(totalLength / mEdgeCount, 1.0e-3f);
+		while (true)
+		{
+			mColumns = (int)(size.X / mCellSize) + 1;
+			mRows = (int)(size.Y / mCellSize) + 1;
+			if (((long long)mColumns * mRows) <= (mEdgeCount * 4))
+				break;
+			
+			mCellSize *= 1.5f;
+		}
+		
+		mOrigin = min;
+		mInvCellSize = 1.0f / mCellSize;
+		
+		// count the cells each edge's box covers, then fill them back to front.
+		int cellCount = mColumns * mRows;
+		mCellStart.assign(cellCount + 1, 0);
+		mEdgeFirstColumn.resize(mEdgeCount);
+		
+		for (int pass = 0; pass < 2; pass++)
+		{
+			for (int i = 0; i < mEdgeCount; i++)
+			{
+				const Vector2& a = positions[i];
+				const Vector2& b = positions[(i < (mEdgeCount - 1)) ? i + 1 : 0];
+				
+				int minX = _column(std::min(a.X, b.X));
+				int maxX = _column(std::max(a.X, b.X));
+				int minY = _row(std::min(a.Y, b.Y));
+				int maxY = _row(std::max(a.Y, b.Y));
+				mEdgeFirstColumn[i] = minX;
+				
+				for (int y = minY; y <= maxY; y++)
+				{
+					for (int x = minX; x <= maxX; x++)
+					{
+						int cell = (y * mColumns) + x;
+						if (pass == 0)
+							mCellStart[cell]++;
+						else
+							mCellEdges[--mCellStart[cell]] = i;
+					}
+				}
+			}
+			
+			if (pass == 0)
+			{
+				for (int c = 1; c <= cellCount; c++)
+					mCellStart[c] += mCellStart[c - 1];
+				
+				mCellEdges.resize(mCellStart[cellCount]);
+			}
+		}
+	}
+	
+	void EdgeIndex::_buildTree()
+	{
+		mNodes.clear();
+		mNodes.reserve(((mEdgeCount / LeafSize) + 1) * 2);
+		_buildNode(0, mEdgeCount);
+	}
+	
+	int EdgeIndex::_buildNode( int first, int count )
+	{
+		int index = (int)mNodes.size();
+		
+		Node node;
+		node.minX = node.minY = node.maxX = node.maxY = 0.0f;
+		node.first = first;
+		node.count = count;
+		node.right = 0;
+		mNodes.push_back(node);
+		
+		if (count > LeafSize)
+		{
+			int half = count / 2;
+			_buildNode(first, half);
+			int right = _buildNode(first + half, count - half);
+			
+			mNodes[index].count = 0;
+			mNodes[index].right = right;
+		}
+		
+		return index;
+	}
+	
+	void EdgeIndex::_refitTree( const Vector2* positions )
+	{
+		// children always come after their parent, so walking backwards refits them first.
+		for (int n = (int)mNodes.size() - 1; n >= 0; n--)
+		{
+			Node& node = mNodes[n];
+			if (node.count > 0)
+			{
+				// a leaf's edges end one point past its last edge.
+				int last = node.first + node.count;
+				const Vector2& start = positions[node.first];
+				node.minX = node.maxX = start.X;
+				node.minY = node.maxY = start.Y;
+				for (int i = node.first + 1; i <= last; i++)
+				{
+					const Vector2& p = positions[(i < mEdgeCount) ? i : 0];
+					node.minX = std::min(node.minX, p.X);
+					node.minY = std::min(node.minY, p.Y);
+					node.maxX = std::max(node.maxX, p.X);
+					node.maxY = std::max(node.maxY, p.Y);
+				}
+			}
+			else
+			{
+				const Node& left = mNodes[n + 1];
+				const Node& right = mNodes[node.right];
+				node.minX = std::min(left.minX, right.minX);
+				node.minY = std::min(left.minY, right.minY);
+				node.maxX = std::max(left.maxX, right.maxX);
+				node.maxY = std::max(left.maxY, right.maxY);
+			}
+		}
+	}
+	
+	void EdgeIndex::queryBox( const AABB& box, std::vector<int>& edges ) const
+	{
+		if (mEdgeCount == 0)
+			return;
+		
+		if (mUseGrid)
+		{
+			int minX = _column(box.Min.X);
+			int maxX = _column(box.Max.X);
+			int minY = _row(box.Min.Y);
+			int maxY = _row(box.Max.Y);
+			
+			for (int y = minY; y <= maxY; y++)
+			{
+				for (int x = minX; x <= maxX; x++)
+				{
+					int cell = (y * mColumns) + x;
+					edges.insert(edges.end(), mCellEdges.begin() + mCellStart[cell], mCellEdges.begin() + mCellStart[cell + 1]);
+				}
+			}
+		}
+		else
+		{
+			int stack[64];
+			int top = 0;
+			stack[top++] = 0;
+			
+			while (top > 0)
+			{
+				int index = stack[--top];
+				const Node& node = mNodes[index];
+				if ((node.maxX < box.Min.X) || (node.minX > box.Max.X) || (node.maxY < box.Min.Y) || (node.minY > box.Max.Y))
+					continue;
+				
+				if (node.count > 0)
+				{
+					for (int i = node.first; i < node.first + node.count; i++)
+						edges.push_back(i);
+					continue;
+				}
+				
+				stack[top++] = node.right;
+				stack[top++] = index + 1;
+			}
+		}
+	}
+	
+	int EdgeIndex::_column( float x ) const
+	{
+		// clamp before converting, points far outside the grid would overflow an int.
+		float column = floorf((x - mOrigin.X) * mInvCellSize);
+		return (int)std::min(std::max(column, 0.0f), (float)(mColumns - 1));
+	}
+	
+	int EdgeIndex::_row( float y ) const
+	{
+		float row = floorf((y - mOrigin.Y) * mInvCellSize);
+		return (int)std::min(std::max(row, 0.0f), (float)(mRows - 1));
+	}
+	
+	float EdgeIndex::_boxDistanceSquared( const Node& node, const Vector2& pt )
+	{
+		float dx = std::max(std::max(node.minX - pt.X, pt.X - node.maxX), 0.0f);
+		float dy = std::max(std::max(node.minY - pt.Y, pt.Y - node.maxY), 0.0f);
+		return (dx * dx) + (dy * dy);
+	}
+
+}
@@ -0,0 +1,234 @@
+#ifndef _EDGE_INDEX_H
+#define _EDGE_INDEX_H
+
+#include "JellyPrerequisites.h"
+#include "Vector2.h"
+#include "AABB.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace JellyPhysics
+{
+	// spatial index over the edges of one body, so collision checks only look at the edges near a point
+	// instead of all of them.  edge i runs from point i to point i+1 (wrapping around).
+	//
+	// static bodies get a uniform grid over their bounding box, built once.  moving bodies get a bounding box
+	// tree over runs of neighbouring edges; the runs never change, only the boxes are refit after the points
+	// move.
+	class EdgeIndex
+	{
+	public:
+		// bodies with fewer edges than this are quicker to check edge by edge.
+		static const int MinEdgeCount = 16;
+		
+		EdgeIndex() : mDirty(true), mUseGrid(false), mEdgeCount(0), mColumns(0), mRows(0), mCellSize(0.0f), mInvCellSize(0.0f) { }
+		
+		// the points have moved, rebuild before the next query.
+		void invalidate() { mDirty = true; }
+		
+		// bring the index up to date with the given points, if anything changed since the last refresh.
+		void refresh( const Vector2* positions, int count, bool useGrid );
+		
+		// visit edges nearest first (roughly), stopping once no unvisited edge can be within sqrt(visitor.getLimit())
+		// of pt.  visitor needs float getLimit() and void visit(int edge).  an edge may be visited more than once.
+		template <class Visitor>
+		void queryNearest( const Vector2& pt, Visitor& visitor ) const;
+		
+		// add the edges that might overlap box to edges, some of them more than once.
+		void queryBox( const AABB& box, std::vector<int>& edges ) const;
+		
+		// visit every edge that might cross the horizontal line from pt to (endX, pt.Y), each exactly once.
+		template <class Visitor>
+		void queryRay( const Vector2& pt, float endX, Visitor& visitor ) const;
+	
+	private:
+		struct Node
+		{
+			float	minX;
+			float	minY;
+			float	maxX;
+			float	maxY;
+			int		first;		// first edge under this node.
+			int		count;		// edges in a leaf, 0 for inner nodes.
+			int		right;		// index of the right child of inner nodes.  the left child always follows its parent.
+		};
+		
+		static const int LeafSize = 4;
+		
+		void _buildGrid( const Vector2* positions );
+		void _buildTree();
+		int _buildNode( int first, int count );
+		void _refitTree( const Vector2* positions );
+		
+		int _column( float x ) const;
+		int _row( float y ) const;
+		
+		// lower bounds are compared with a little slack, so rounding in the exact edge test can never make a
+		// skipped edge the closest one.
+		static bool _beyond( float distSquared, float limit ) { return (distSquared > (limit + (limit * 0.001f) + 1.0e-6f)); }
+		
+		static float _boxDistanceSquared( const Node& node, const Vector2& pt );
+		
+		bool				mDirty;
+		bool				mUseGrid;
+		int					mEdgeCount;
+		
+		// grid.
+		Vector2				mOrigin;
+		int					mColumns;
+		int					mRows;
+		float				mCellSize;
+		float				mInvCellSize;
+		std::vector<int>	mCellStart;			// first entry of each cell in mCellEdges, plus an end marker.
+		std::vector<int>	mCellEdges;			// edge indices, grouped by cell.
+		std::vector<int>	mEdgeFirstColumn;	// leftmost column each edge touches.
+		
+		// tree.
+		std::vector<Node>	mNodes;
+	};
+	
+	template <class Visitor>
+	void EdgeIndex::queryNearest( const Vector2& pt, Visitor& visitor ) const
+	{
+		if (mEdgeCount == 0)
+			return;
+		
+		if (mUseGrid)
+		{
+			int cx = _column(pt.X);
+			int cy = _row(pt.Y);
+			
+			int lastRing = cx;
+			if ((mColumns - 1 - cx) > lastRing) { lastRing = mColumns - 1 - cx; }
+			if (cy > lastRing) { lastRing = cy; }
+			if ((mRows - 1 - cy) > lastRing) { lastRing = mRows - 1 - cy; }
+			
+			for (int ring = 0; ring <= lastRing; ring++)
+			{
+				if (ring > 0)
+				{
+					// every edge not visited yet lies outside the square of the rings already done.  sides with no
+					// cells beyond them don't count.
+					float gap = 1.0e30f;
+					if ((cx - ring) >= 0) { gap = std::min(gap, pt.X - (mOrigin.X + ((cx - ring + 1) * mCellSize))); }
+					if ((cx + ring) < mColumns) { gap = std::min(gap, (mOrigin.X + ((cx + ring) * mCellSize)) - pt.X); }
+					if ((cy - ring) >= 0) { gap = std::min(gap, pt.Y - (mOrigin.Y + ((cy - ring + 1) * mCellSize))); }
+					if ((cy + ring) < mRows) { gap = std::min(gap, (mOrigin.Y + ((cy + ring) * mCellSize)) - pt.Y); }
+					
+					if ((gap > 0.0f) && _beyond(gap * gap, visitor.getLimit()))
+						return;
+				}
+				
+				int minY = std::max(cy - ring, 0);
+				int maxY = std::min(cy + ring, mRows - 1);
+				for (int y = minY; y <= maxY; y++)
+				{
+					// whole rows at the top and bottom of the ring, just the two ends in between.
+					bool edgeRow = ((y == (cy - ring)) || (y == (cy + ring)));
+					int step = (edgeRow || (ring == 0)) ? 1 : (ring * 2);
+					
+					for (int x = cx - ring; x <= cx + ring; x += step)
+					{
+						if ((x < 0) || (x >= mColumns))
+							continue;
+						
+						int cell = (y * mColumns) + x;
+						for (int i = mCellStart[cell]; i < mCellStart[cell + 1]; i++)
+							visitor.visit(mCellEdges[i]);
+					}
+				}
+			}
+		}
+		else
+		{
+			int stack[64];
+			int top = 0;
+			stack[top++] = 0;
+			
+			while (top > 0)
+			{
+				int index = stack[--top];
+				const Node& node = mNodes[index];
+				if (_beyond(_boxDistanceSquared(node, pt), visitor.getLimit()))
+					continue;
+				
+				if (node.count > 0)
+				{
+					for (int i = node.first; i < node.first + node.count; i++)
+						visitor.visit(i);
+					continue;
+				}
+				
+				// push the farther child first, so the nearer one is searched first.
+				int left = index + 1;
+				int right = node.right;
+				if (_boxDistanceSquared(mNodes[left], pt) <= _boxDistanceSquared(mNodes[right], pt))
+				{
+					stack[top++] = right;
+					stack[top++] = left;
+				}
+				else
+				{
+					stack[top++] = left;
+					stack[top++] = right;
+				}
+			}
+		}
+	}
+	
+	template <class Visitor>
+	void EdgeIndex::queryRay( const Vector2& pt, float endX, Visitor& visitor ) const
+	{
+		if (mEdgeCount == 0)
+			return;
+		
+		if (mUseGrid)
+		{
+			// walk the row from one column before the point, in case rounding puts a crossing just left of it.
+			// an edge spanning several columns is only visited in the first of them.
+			int row = _row(pt.Y);
+			int startColumn = std::max(_column(pt.X) - 1, 0);
+			int endColumn = _column(endX);
+			
+			for (int x = startColumn; x <= endColumn; x++)
+			{
+				int cell = (row * mColumns) + x;
+				for (int i = mCellStart[cell]; i < mCellStart[cell + 1]; i++)
+				{
+					int edge = mCellEdges[i];
+					if (std::max(mEdgeFirstColumn[edge], startColumn) == x)
+						visitor.visit(edge);
+				}
+			}
+		}
+		else
+		{
+			float slack = 1.0e-4f * (absf(pt.X) + absf(endX) + 1.0f);
+			
+			int stack[64];
+			int top = 0;
+			stack[top++] = 0;
+			
+			while (top > 0)
+			{
+				int index = stack[--top];
+				const Node& node = mNodes[index];
+				if ((pt.Y < node.minY) || (pt.Y > node.maxY) || (node.maxX < (pt.X - slack)) || (node.minX > (endX + slack)))
+					continue;
+				
+				if (node.count > 0)
+				{
+					for (int i = node.first; i < node.first + node.count; i++)
+						visitor.visit(i);
+					continue;
+				}
+				
+				stack[top++] = node.right;
+				stack[top++] = index + 1;
+			}
+		}
+	}
+}
+
+#endif	// _EDGE_INDEX_H
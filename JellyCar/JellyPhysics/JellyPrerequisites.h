@@ -4,6 +4,13 @@
 #include "Vector2.h"
 #include <vector>
 
+// SSE versions of the per-point passes, where the target has it.  other targets run the plain loops, written
+// without branches so the compiler can vectorize them.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#define JELLY_USE_SSE
+#include <xmmintrin.h>
+#endif
+
 namespace JellyPhysics 
 {
 	
@@ -1,35 +1,210 @@
 #include "PointMass.h"
-#include <stdio.h>
+#include "JellyPrerequisites.h"
 
-namespace  JellyPhysics 
-{
+#include <algorithm>
 
-	PointMass::PointMass( float mass, const Vector2& pos )
+namespace  JellyPhysics
+{
+	
+	void PointMassPool::allocate( PointMassList& list, int count )
+	{
+		if (list.mPool)
+			list.mPool->release(list);
+		
+		list.mPool = this;
+		list.mStart = (int)mMass.size();
+		list.mCount = count;
+		
+		mMass.resize(mMass.size() + count, 0.0f);
+		mPosition.resize(mPosition.size() + count, Vector2::Zero);
+		mVelocity.resize(mVelocity.size() + count, Vector2::Zero);
+		mForce.resize(mForce.size() + count, Vector2::Zero);
+		
+		// new ranges always go at the end, so the list stays ordered by start.
+		mLists.push_back(&list);
+	}
+	
+	void PointMassPool::release( PointMassList& list )
 	{
-		Mass = mass;
-		Position = pos;
-		Velocity = Force = Vector2::Zero;
-		lastElapsed = 0;
-		lastElapMass = 1;
+		if (list.mPool != this)
+			return;
+		
+		int start = list.mStart;
+		int end = start + list.mCount;
+		
+		mMass.erase(mMass.begin() + start, mMass.begin() + end);
+		mPosition.erase(mPosition.begin() + start, mPosition.begin() + end);
+		mVelocity.erase(mVelocity.begin() + start, mVelocity.begin() + end);
+		mForce.erase(mForce.begin() + start, mForce.begin() + end);
+		
+		std::vector<PointMassList*>::iterator it = std::find(mLists.begin(), mLists.end(), &list);
+		it = mLists.erase(it);
+		for (; it != mLists.end(); it++)
+			(*it)->mStart -= list.mCount;
+		
+		list.mPool = 0;
+		list.mStart = 0;
+		list.mCount = 0;
 	}
 	
-	void PointMass::integrateForce( float elapsed )
+	void PointMassPool::integrate( int start, int count, float elapsed )
 	{
-		if (Mass != 0.0f)
+		float* mass = getMasses() + start;
+		Vector2* pos = getPositions() + start;
+		Vector2* vel = getVelocities() + start;
+		Vector2* force = getForces() + start;
+		
+		// massless points are masked to a step of zero rather than skipped, which leaves them where they are.
+		int i = 0;
+#ifdef JELLY_USE_SSE
+		// four point masses at a time, one divide for all of them, then two per register laid out (x, y, x, y)
+		// like the arrays.
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 elapsed4 = _mm_set1_ps(elapsed);
+		for (; i + 4 <= count; i += 4)
 		{
-			if (lastElapsed != elapsed)
+			__m128 m = _mm_loadu_ps(mass + i);
+			__m128 moving = _mm_cmpneq_ps(m, zero);
+			__m128 elapMass = _mm_and_ps(_mm_div_ps(elapsed4, _mm_or_ps(m, _mm_andnot_ps(moving, one))), moving);
+			__m128 step = _mm_and_ps(elapsed4, moving);
+			
+			__m128 elapMassPair[2] = { _mm_unpacklo_ps(elapMass, elapMass), _mm_unpackhi_ps(elapMass, elapMass) };
+			__m128 stepPair[2] = { _mm_unpacklo_ps(step, step), _mm_unpackhi_ps(step, step) };
+			for (int k = 0; k < 2; k++)
 			{
-				lastElapsed = elapsed;
-				lastElapMass = elapsed / Mass;
+				int n = i + (k * 2);
+				__m128 v = _mm_add_ps(_mm_loadu_ps(&vel[n].X), _mm_mul_ps(_mm_loadu_ps(&force[n].X), elapMassPair[k]));
+				__m128 p = _mm_add_ps(_mm_loadu_ps(&pos[n].X), _mm_mul_ps(v, stepPair[k]));
+				_mm_storeu_ps(&vel[n].X, v);
+				_mm_storeu_ps(&pos[n].X, p);
 			}
+		}
+#endif
+		for (; i < count; i++)
+		{
+			float moving = (mass[i] != 0.0f) ? 1.0f : 0.0f;
+			float elapMass = (elapsed / (mass[i] + (1.0f - moving))) * moving;
+			float step = elapsed * moving;
 			
-			Velocity += (Force * lastElapMass);
+			vel[i].X += force[i].X * elapMass;
+			vel[i].Y += force[i].Y * elapMass;
 			
-			Position += (Velocity * elapsed);
+			pos[i].X += vel[i].X * step;
+			pos[i].Y += vel[i].Y * step;
 		}
 		
-		Force = Vector2::Zero;
+		std::fill(force, force + count, Vector2::Zero);
 	}
 	
-}
+	void PointMassPool::dampenVelocity( int start, int count, float damping )
+	{
+		Vector2* vel = getVelocities() + start;
+		
+		for (int i = 0; i < count; i++)
+		{
+			vel[i].X *= damping;
+			vel[i].Y *= damping;
+		}
+	}
+	
+	void PointMassPool::setVelocity( int start, int count, const Vector2& velocity )
+	{
+		Vector2* vel = getVelocities() + start;
+		std::fill(vel, vel + count, velocity);
+	}
+	
+	// grows min and max to take in count points, and where they will be after elapsed if Expand is set.
+	template <bool Expand>
+	static void _growBounds( const Vector2* pos, const Vector2* vel, int count, float elapsed, Vector2& min, Vector2& max )
+	{
+		int i = 0;
+#ifdef JELLY_USE_SSE
+		// two points per register, (x, y, x, y), with the two halves folded together at the end.
+		__m128 lo = _mm_setr_ps(min.X, min.Y, min.X, min.Y);
+		__m128 hi = _mm_setr_ps(max.X, max.Y, max.X, max.Y);
+		const __m128 step = _mm_set1_ps(elapsed);
+		for (; i + 2 <= count; i += 2)
+		{
+			__m128 p = _mm_loadu_ps(&pos[i].X);
+			lo = _mm_min_ps(p, lo);
+			hi = _mm_max_ps(p, hi);
+			
+			if (Expand)
+			{
+				p = _mm_add_ps(p, _mm_mul_ps(_mm_loadu_ps(&vel[i].X), step));
+				lo = _mm_min_ps(p, lo);
+				hi = _mm_max_ps(p, hi);
+			}
+		}
+		
+		lo = _mm_min_ps(_mm_movehl_ps(lo, lo), lo);
+		hi = _mm_max_ps(_mm_movehl_ps(hi, hi), hi);
+		_mm_storel_pi((__m64*)&min.X, lo);
+		_mm_storel_pi((__m64*)&max.X, hi);
+#endif
+		float minX = min.X;
+		float minY = min.Y;
+		float maxX = max.X;
+		float maxY = max.Y;
+		
+		for (; i < count; i++)
+		{
+			float x = pos[i].X;
+			float y = pos[i].Y;
+			minX = std::min(minX, x);
+			minY = std::min(minY, y);
+			maxX = std::max(maxX, x);
+			maxY = std::max(maxY, y);
+			
+			if (Expand)
+			{
+				x += vel[i].X * elapsed;
+				y += vel[i].Y * elapsed;
+				minX = std::min(minX, x);
+				minY = std::min(minY, y);
+				maxX = std::max(maxX, x);
+				maxY = std::max(maxY, y);
+			}
+		}
+		
+		min = Vector2(minX, minY);
+		max = Vector2(maxX, maxY);
+	}
+	
+	void PointMassPool::getBounds( int start, int count, float elapsed, bool expandForVelocity, AABB& box )
+	{
+		box.clear();
+		if (count == 0)
+			return;
+		
+		Vector2* pos = getPositions() + start;
+		Vector2* vel = getVelocities() + start;
+		
+		Vector2 min = pos[0];
+		Vector2 max = pos[0];
+		if (expandForVelocity)
+			_growBounds<true>(pos, vel, count, elapsed, min, max);
+		else
+			_growBounds<false>(pos, vel, count, elapsed, min, max);
+		
+		box = AABB(min, max);
+	}
+	
+	float PointMassPool::getKineticEnergy( int start, int count, float& totalMass )
+	{
+		float* mass = getMasses() + start;
+		Vector2* vel = getVelocities() + start;
+		
+		float energy = 0.0f;
+		totalMass = 0.0f;
+		for (int i = 0; i < count; i++)
+		{
+			energy += mass[i] * ((vel[i].X * vel[i].X) + (vel[i].Y * vel[i].Y));
+			totalMass += mass[i];
+		}
+		
+		return energy * 0.5f;
+	}
 
+}
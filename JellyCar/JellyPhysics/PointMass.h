@@ -2,27 +2,102 @@
 #define _POINT_MASS_H
 
 #include "Vector2.h"
+#include "AABB.h"
 
-namespace JellyPhysics 
+#include <vector>
+
+namespace JellyPhysics
 {
+	class PointMassPool;
+	class PointMassList;
 	
+	// one point mass, referring to its slot in the world's PointMassPool.  only valid until the next body
+	// is added to or removed from the world, so look it up again rather than holding on to it.
 	class PointMass
 	{
 	public:
-		float		Mass;
-		Vector2		Position;
-		Vector2		Velocity;
-		Vector2		Force;
+		float&		Mass;
+		Vector2&	Position;
+		Vector2&	Velocity;
+		Vector2&	Force;
+		
+		PointMass( PointMassPool& pool, int index );
+	};
+	
+	// every point mass in a world, stored one array per field.  each body owns one contiguous range, and
+	// the per-step passes below run straight down those arrays.
+	class PointMassPool
+	{
+	public:
+		PointMassPool() { }
+		
+		// add count point masses at the end of the pool, and hand them to list in place of any it had.
+		void allocate( PointMassList& list, int count );
 		
-		PointMass() : Mass(0), Position(Vector2::Zero), Velocity(Vector2::Zero), Force(Vector2::Zero), lastElapsed(0), lastElapMass(1) { }
-		PointMass( float mass, const Vector2& pos);
+		// remove the point masses of list, moving later ranges down to close the gap.
+		void release( PointMassList& list );
 		
-		void integrateForce( float elapsed );
+		int size() { return (int)mMass.size(); }
 		
+		float* getMasses() { return mMass.data(); }
+		Vector2* getPositions() { return mPosition.data(); }
+		Vector2* getVelocities() { return mVelocity.data(); }
+		Vector2* getForces() { return mForce.data(); }
+		
+		// velocity and position from the accumulated forces, then clear the forces.  point masses with no mass
+		// do not move.
+		void integrate( int start, int count, float elapsed );
+		
+		void dampenVelocity( int start, int count, float damping );
+		void setVelocity( int start, int count, const Vector2& velocity );
+		
+		// box around the positions, and also around where they will be after elapsed if expandForVelocity is set.
+		void getBounds( int start, int count, float elapsed, bool expandForVelocity, AABB& box );
+		
+		// kinetic energy of the point masses, and their total mass.
+		float getKineticEnergy( int start, int count, float& totalMass );
+	
 	private:
-		float		lastElapsed;
-		float		lastElapMass;
+		friend class PointMass;
+		
+		std::vector<float>			mMass;
+		std::vector<Vector2>		mPosition;
+		std::vector<Vector2>		mVelocity;
+		std::vector<Vector2>		mForce;
+		
+		std::vector<PointMassList*>	mLists;		// ordered by start.
 	};
+	
+	// a body's range in the pool, indexed like the std::vector<PointMass> it replaces.
+	class PointMassList
+	{
+	public:
+		PointMassList() : mPool(0), mStart(0), mCount(0) { }
+		
+		PointMass operator[]( int index ) const { return PointMass(*mPool, mStart + index); }
+		
+		unsigned int size() const { return (unsigned int)mCount; }
+		bool empty() const { return (mCount == 0); }
+		
+		int getStart() const { return mStart; }
+		PointMassPool* getPool() const { return mPool; }
+	
+	private:
+		friend class PointMassPool;
+		
+		// the pool keeps a pointer to each list, so they cannot be copied.
+		PointMassList( const PointMassList& );
+		PointMassList& operator=( const PointMassList& );
+		
+		PointMassPool*	mPool;
+		int				mStart;
+		int				mCount;
+	};
+	
+	inline PointMass::PointMass( PointMassPool& pool, int index ) :
+		Mass(pool.mMass[index]), Position(pool.mPosition[index]), Velocity(pool.mVelocity[index]), Force(pool.mForce[index])
+	{
+	}
 }
 
 #endif // _POINT_MASS_H
@@ -22,9 +22,9 @@ namespace JellyPhysics
 			int prev = (i > 0) ? i-1 : mPointCount-1;
 			int next = (i < mPointCount - 1) ? i + 1 : 0;
 			
-			PointMass& pmP = mPointMasses[prev];
-			PointMass& pmI = mPointMasses[i];
-			PointMass& pmN = mPointMasses[next];
+			PointMass pmP = mPointMasses[prev];
+			PointMass pmI = mPointMasses[i];
+			PointMass pmN = mPointMasses[next];
 			
 			// currently we are talking about the edge from i --> j.
 			// first calculate the volume of the body, and cache normals as we go.
@@ -64,4 +64,21 @@ namespace JellyPhysics
 			mPointMasses[j].Force += mNormalList[j] * pressureV;
 		}
 	}
+	
+	void PressureBody::saveState( std::vector<unsigned char>& buffer )
+	{
+		SpringBody::saveState(buffer);
+		writeState(buffer, mGasAmount);
+	}
+	
+	bool PressureBody::restoreState( StateReader& reader, bool apply )
+	{
+		float gasAmount = 0.0f;
+		if ((!SpringBody::restoreState(reader, apply)) || (!reader.read(gasAmount)))
+			return false;
+		
+		if (apply)
+			mGasAmount = gasAmount;
+		return true;
+	}
 }
@@ -34,6 +34,10 @@ namespace JellyPhysics
 		
 		void accumulateInternalForces();
 		
+		// the spring body's state and the gas amount.
+		void saveState( std::vector<unsigned char>& buffer );
+		bool restoreState( StateReader& reader, bool apply );
+		
 	};
 }
 
@@ -115,8 +115,8 @@ namespace JellyPhysics
 		for (SpringList::iterator it = mSprings.begin(); it != mSprings.end(); it++)
 		{
 			InternalSpring& s = (*it);
-			PointMass& pmA = mPointMasses[s.pointMassA];
-			PointMass& pmB = mPointMasses[s.pointMassB];
+			PointMass pmA = mPointMasses[s.pointMassA];
+			PointMass pmB = mPointMasses[s.pointMassB];
 			
 			if (i < mPointCount)
 			{
@@ -144,7 +144,7 @@ namespace JellyPhysics
 			mBaseShape.transformVertices(mDerivedPos, mDerivedAngle, mScale, mGlobalShape);
 			for (int i = 0; i < mPointCount; i++)
 			{
-				PointMass& pmA = mPointMasses[i];
+				PointMass pmA = mPointMasses[i];
 				
 				if (mShapeSpringK > 0)
 				{
@@ -164,5 +164,65 @@ namespace JellyPhysics
 			}
 		}
 	}
+	
+	void SpringBody::saveState( std::vector<unsigned char>& buffer )
+	{
+		Vector2List& baseVerts = mBaseShape.getVertices();
+		
+		writeState(buffer, (int)mShapeMatchingOn);
+		writeState(buffer, mEdgeSpringK);
+		writeState(buffer, mEdgeSpringDamp);
+		writeState(buffer, mShapeSpringK);
+		writeState(buffer, mShapeSpringDamp);
+		
+		writeState(buffer, (int)baseVerts.size());
+		writeState(buffer, baseVerts.data(), (int)baseVerts.size());
+		
+		writeState(buffer, (int)mSprings.size());
+		writeState(buffer, mSprings.data(), (int)mSprings.size());
+	}
+	
+	bool SpringBody::restoreState( StateReader& reader, bool apply )
+	{
+		Vector2List& baseVerts = mBaseShape.getVertices();
+		
+		int shapeMatchingOn = 0;
+		float constants[4];
+		if ((!reader.read(shapeMatchingOn)) || (!reader.read(constants, 4)))
+			return false;
+		
+		int vertexCount = 0;
+		if ((!reader.read(vertexCount)) || (vertexCount != (int)baseVerts.size()) ||
+			(!reader.read((apply) ? baseVerts.data() : (Vector2*)0, vertexCount)))
+			return false;
+		
+		int springCount = 0;
+		if ((!reader.read(springCount)) || (springCount != (int)mSprings.size()))
+			return false;
+		
+		// the springs are read through a copy, so a bad point index is caught before anything changes.
+		SpringList springs(springCount);
+		if (!reader.read(springs.data(), springCount))
+			return false;
+		
+		for (int i = 0; i < springCount; i++)
+		{
+			if ((springs[i].pointMassA < 0) || (springs[i].pointMassA >= mPointCount) ||
+				(springs[i].pointMassB < 0) || (springs[i].pointMassB >= mPointCount))
+				return false;
+		}
+		
+		if (apply)
+		{
+			mShapeMatchingOn = (shapeMatchingOn != 0);
+			mEdgeSpringK = constants[0];
+			mEdgeSpringDamp = constants[1];
+			mShapeSpringK = constants[2];
+			mShapeSpringDamp = constants[3];
+			mSprings.swap(springs);
+		}
+		
+		return true;
+	}
 }
 
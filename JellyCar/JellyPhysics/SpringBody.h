@@ -45,6 +45,10 @@ namespace JellyPhysics
 		float getSpringDamping( int springID );
 		
 		void accumulateInternalForces();
+		
+		// the springs, the base shape and the spring constants.
+		void saveState( std::vector<unsigned char>& buffer );
+		bool restoreState( StateReader& reader, bool apply );
 	};
 }
 
@@ -0,0 +1,104 @@
+#include "TaskPool.h"
+
+namespace JellyPhysics
+{
+	
+	TaskPool::TaskPool( int threads ) : mFunction(0), mContext(0), mTaskCount(0), mQuit(false)
+	{
+		mNextTask = 0;
+		mBusy = 0;
+		mBatch = 0;
+		
+		for (int i = 1; i < threads; i++)
+			mWorkers.push_back(std::thread(&TaskPool::_work, this, i));
+	}
+	
+	TaskPool::~TaskPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQuit = true;
+		}
+		mWake.notify_all();
+		
+		for (unsigned int i = 0; i < mWorkers.size(); i++)
+			mWorkers[i].join();
+	}
+	
+	void TaskPool::run( TaskFunction function, void* context, int taskCount )
+	{
+		if (mWorkers.empty())
+		{
+			for (int i = 0; i < taskCount; i++)
+				function(context, i, 0);
+			return;
+		}
+		
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mFunction = function;
+			mContext = context;
+			mTaskCount = taskCount;
+			mNextTask = 0;
+			mBusy = (int)mWorkers.size();
+			mBatch++;
+		}
+		mWake.notify_all();
+		
+		_runTasks(0);
+		
+		// every worker has to check in before the next batch can reuse the fields above.  they are usually
+		// only a task behind, so poll for a little while before going to sleep.
+		for (int i = 0; (i < SpinCount) && (mBusy > 0); i++)
+			std::this_thread::yield();
+		
+		std::unique_lock<std::mutex> lock(mMutex);
+		while (mBusy > 0)
+			mDone.wait(lock);
+	}
+	
+	void TaskPool::_work( int thread )
+	{
+		unsigned int lastBatch = 0;
+		
+		while (true)
+		{
+			// the caller often hands out batches back to back, catch those without a trip through the mutex.
+			for (int i = 0; (i < SpinCount) && (mBatch == lastBatch); i++)
+				std::this_thread::yield();
+			
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				while ((!mQuit) && (mBatch == lastBatch))
+					mWake.wait(lock);
+				
+				if (mQuit)
+					return;
+				
+				lastBatch = mBatch;
+			}
+			
+			_runTasks(thread);
+			
+			// the caller may already be asleep, take the lock so the notify can't slip in before its wait.
+			if (--mBusy == 0)
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mDone.notify_one();
+			}
+		}
+	}
+	
+	void TaskPool::_runTasks( int thread )
+	{
+		while (true)
+		{
+			int task = mNextTask.fetch_add(1);
+			if (task >= mTaskCount)
+				return;
+			
+			mFunction(mContext, task, thread);
+		}
+	}
+
+}
@@ -0,0 +1,56 @@
+#ifndef _TASK_POOL_H
+#define _TASK_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace JellyPhysics
+{
+	// a few worker threads that share numbered tasks with the thread calling run().  tasks are handed out
+	// in order to whichever thread is free, so callers wanting a fixed result should give each task its own
+	// output and combine them in task order afterwards.
+	class TaskPool
+	{
+	public:
+		typedef void (*TaskFunction)( void* context, int task, int thread );
+		
+		// threads counts the calling thread, so 1 starts no workers and runs everything on the caller.
+		TaskPool( int threads );
+		~TaskPool();
+		
+		int getThreadCount() { return (int)mWorkers.size() + 1; }
+		
+		// run function for tasks 0 to taskCount-1 and wait for them all.  thread is 0 for the calling thread,
+		// 1 to getThreadCount()-1 for the workers.
+		void run( TaskFunction function, void* context, int taskCount );
+	
+	private:
+		TaskPool( const TaskPool& );
+		TaskPool& operator=( const TaskPool& );
+		
+		void _work( int thread );
+		void _runTasks( int thread );
+		
+		// batches are often only tens of microseconds long, about what a condition variable wake-up costs.
+		// both sides poll for this many yields before they fall back to sleeping on the condition variables.
+		static const int			SpinCount = 256;
+		
+		std::vector<std::thread>	mWorkers;
+		std::mutex					mMutex;
+		std::condition_variable		mWake;
+		std::condition_variable		mDone;
+		
+		TaskFunction				mFunction;
+		void*						mContext;
+		int							mTaskCount;
+		std::atomic<int>			mNextTask;
+		std::atomic<int>			mBusy;			// workers not finished with the current batch.
+		std::atomic<unsigned int>	mBatch;			// bumped for every run(), so workers can tell a new batch from a spurious wake-up.
+		bool						mQuit;
+	};
+}
+
+#endif	// _TASK_POOL_H
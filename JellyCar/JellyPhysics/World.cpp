@@ -1,5 +1,8 @@
 #include "World.h"
 
+#include <algorithm>
+#include <string.h>
+
 namespace JellyPhysics 
 {
 	World::World()
@@ -12,6 +15,28 @@ namespace JellyPhysics
 		
 		mMaterialPairs[0] = mDefaultMatPair;
 		
+		mBroadphase = BroadphaseSweepAndPrune;
+		mGridColumns = 32;
+		mGridRows = 32;
+		
+		mUseEdgeIndex = true;
+		
+		mTaskPool = 0;
+		mBlockSize = NarrowphaseBlockSize;
+		mNearbyPoints.resize(1);
+		
+		mSleeping = false;
+		mSleepVelocity = 0.1f;
+		mSleepEnergy = 0.01f;
+		mSleepTime = 1.0f;
+		
+		mStats.awakeBodies = 0;
+		mStats.asleepBodies = 0;
+		mStats.islands = 0;
+		
+		mPhaseTiming = false;
+		resetPhaseTimes();
+		
 		setWorldLimits(Vector2(-20,-20), Vector2(20,20));
 		
 		mPenetrationThreshold = 0.3f;
@@ -20,6 +45,7 @@ namespace JellyPhysics
 	
 	World::~World()
 	{
+		delete mTaskPool;
 		
 		delete[] mMaterialPairs;
 	}
@@ -59,6 +85,8 @@ namespace JellyPhysics
 		mWorldSize = max - min;
 		mWorldGridStep = mWorldSize / 32;
 		
+		_updateGridCellSize();
+		
 		// update bitmasks for all bodies.
 		for (BodyList::iterator it = mBodies.begin(); it != mBodies.end(); it++)
 			updateBodyBitmask((*it));
@@ -188,6 +216,9 @@ namespace JellyPhysics
 		{
 			if ((*it) == b)
 			{
+				// take it out of its island's ring.
+				b->wake();
+				
 				mBodies.erase( it );
 				_removeBoundary(&b->mBoundStart);
 				_removeBoundary(&b->mBoundEnd);
@@ -278,28 +309,44 @@ namespace JellyPhysics
 	{
 		mPenetrationCount = 0;
 		
+		std::chrono::steady_clock::time_point lap;
+		if (mPhaseTiming)
+			lap = std::chrono::steady_clock::now();
+		
 		// first, accumulate all forces acting on PointMasses.
 		for (BodyList::iterator it = mBodies.begin(); it != mBodies.end(); it++)
 		{
-			if ((*it)->getIsStatic() || (*it)->getIgnoreMe()) { continue; }
+			if ((*it)->getIsStatic() || (*it)->getIgnoreMe() || (*it)->getIsAsleep()) { continue; }
 			
 			(*it)->derivePositionAndAngle(elapsed);
 			(*it)->accumulateExternalForces();
 			(*it)->accumulateInternalForces();
 		}
 		
-		// now integrate.
+		// now integrate.  bodies added one after another sit next to each other in the pool, so each run of
+		// them is integrated in one pass.
+		int runStart = 0;
+		int runCount = 0;
 		for (BodyList::iterator it = mBodies.begin(); it != mBodies.end(); it++)
 		{
-			//if ((*it)->getIsStatic()) { continue; }
+			if ((*it)->getIsStatic() || (*it)->getIgnoreMe() || (*it)->getIsAsleep()) { continue; }
 			
-			(*it)->integrate(elapsed);
+			int start = (*it)->mPointMasses.getStart();
+			if (start != (runStart + runCount))
+			{
+				mPointMassPool.integrate(runStart, runCount, elapsed);
+				runStart = start;
+				runCount = 0;
+			}
+			
+			runCount += (*it)->getPointMassCount();
 		}
+		mPointMassPool.integrate(runStart, runCount, elapsed);
 		
 		// update all bounding boxes, and then bitmasks.
 		for (BodyList::iterator it = mBodies.begin(); it != mBodies.end(); it++)
 		{
-			if ((*it)->getIsStatic() || (*it)->getIgnoreMe()) { continue; }
+			if ((*it)->getIsStatic() || (*it)->getIgnoreMe() || (*it)->getIsAsleep()) { continue; }
 			
 			(*it)->updateAABB(elapsed);
 			updateBodyBitmask((*it));
@@ -307,10 +354,91 @@ namespace JellyPhysics
 			(*it)->updateBoundaryValues();
 		}
 		
+		_lapPhase(mPhaseTimes.integration, lap);
+		
+		// find the body pairs that might be colliding.
+		if (mBroadphase == BroadphaseUniformGrid)
+			_gridBroadphase();
+		else
+			_sweepBroadphase();
+		
+		_lapPhase(mPhaseTimes.broadphase, lap);
+		
+		// now check for collision.
+		_narrowphase();
+		
+		_lapPhase(mPhaseTimes.narrowphase, lap);
+		
+		//printf("\n\n");
+		
+		if (mSleeping)
+			_linkIslands();
+		
+		// now handle all collisions found during the update at once.
+		_handleCollisions();
+		
+		_lapPhase(mPhaseTimes.collisionResponse, lap);
+		
+		// now dampen velocities.
+		for (BodyList::iterator it = mBodies.begin(); it != mBodies.end(); it++)
+		{
+			//if ((*it)->getIsStatic()) { continue; }
+			(*it)->dampenVelocity();
+			
+			// collisions have moved the points of dynamic bodies since their edge index was built.
+			if ((!(*it)->getIsStatic()) && (!(*it)->getIsAsleep()))
+				(*it)->mEdgeIndex.invalidate();
+		}
+		
+		_updateSleeping(elapsed);
+		
+		_lapPhase(mPhaseTimes.integration, lap);
+	}
+	
+	void World::resetPhaseTimes()
+	{
+		mPhaseTimes.integration = 0.0;
+		mPhaseTimes.broadphase = 0.0;
+		mPhaseTimes.narrowphase = 0.0;
+		mPhaseTimes.collisionResponse = 0.0;
+	}
+	
+	void World::_lapPhase( double& phase, std::chrono::steady_clock::time_point& lap )
+	{
+		if (!mPhaseTiming)
+			return;
+		
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		phase += std::chrono::duration<double>(now - lap).count();
+		lap = now;
+	}
+	
+	
+	void World::setBroadphase( BroadphaseType type )
+	{
+		mBroadphase = type;
+	}
+	
+	void World::setBroadphaseGridSize( int columns, int rows )
+	{
+		mGridColumns = (columns < 1) ? 1 : columns;
+		mGridRows = (rows < 1) ? 1 : rows;
+		
+		_updateGridCellSize();
+	}
+	
+	void World::_updateGridCellSize()
+	{
+		mGridCellSize = Vector2(mWorldSize.X / mGridColumns, mWorldSize.Y / mGridRows);
+	}
+	
+	void World::_sweepBroadphase()
+	{
+		mBroadphasePairs.clear();
+		
 		// sort body boundaries for broadphase collision checks
 		sortBodyBoundaries();
 		
-		// now check for collision.
 		for (unsigned int i = 0; i < mBodies.size(); i++)
 		{
 			Body* bA = mBodies[i];
@@ -329,6 +457,9 @@ namespace JellyPhysics
 			Body::BodyBoundary* bE = &bA->mBoundEnd;
 			Body::BodyBoundary* cur = bS->next;
 			
+			BodyPair pair;
+			pair.bodyA = bA;
+			
 			bool passedMyEnd = false;
 			while (cur)
 			{
@@ -339,7 +470,8 @@ namespace JellyPhysics
 				else if ((cur->type == Body::BodyBoundary::Begin) && (!passedMyEnd))
 				{
 					// overlapping, do narrow-phase check on this body pair.
-					_goNarrowCheck(bA, cur->body);
+					pair.bodyB = cur->body;
+					mBroadphasePairs.push_back(pair);
 				}
 				else if (cur->type == Body::BodyBoundary::End)
 				{
@@ -348,7 +480,8 @@ namespace JellyPhysics
 					if (cur->body->mBoundStart.value <= bS->value)
 					{
 						// overlapping, do narrow-phase check on this body pair.
-						_goNarrowCheck(bA, cur->body);
+						pair.bodyB = cur->body;
+						mBroadphasePairs.push_back(pair);
 					}
 				}
 				else if (cur->type == Body::BodyBoundary::VoidMarker)
@@ -359,25 +492,180 @@ namespace JellyPhysics
 				cur = cur->next;
 			}
 		}
+	}
+	
+	World::GridRange World::_getGridRange( const AABB& box )
+	{
+		GridRange r;
+		r.minX = (int)floor((box.Min.X - mWorldLimits.Min.X) / mGridCellSize.X);
+		r.minY = (int)floor((box.Min.Y - mWorldLimits.Min.Y) / mGridCellSize.Y);
+		r.maxX = (int)floor((box.Max.X - mWorldLimits.Min.X) / mGridCellSize.X);
+		r.maxY = (int)floor((box.Max.Y - mWorldLimits.Min.Y) / mGridCellSize.Y);
 		
-		//printf("\n\n");
+		// anything outside the world limits goes into the border cells.
+		if (r.minX < 0) { r.minX = 0; } else if (r.minX >= mGridColumns) { r.minX = mGridColumns - 1; }
+		if (r.maxX < 0) { r.maxX = 0; } else if (r.maxX >= mGridColumns) { r.maxX = mGridColumns - 1; }
+		if (r.minY < 0) { r.minY = 0; } else if (r.minY >= mGridRows) { r.minY = mGridRows - 1; }
+		if (r.maxY < 0) { r.maxY = 0; } else if (r.maxY >= mGridRows) { r.maxY = mGridRows - 1; }
 		
-		// now handle all collisions found during the update at once.
-		_handleCollisions();
+		return r;
+	}
+	
+	void World::_gridBroadphase()
+	{
+		mBroadphasePairs.clear();
 		
-		// now dampen velocities.
+		int cellCount = mGridColumns * mGridRows;
+		mGridCellStart.assign(cellCount + 1, 0);
+		mGridRanges.resize(mBodies.size());
+		
+		// count the bodies touching each cell...
+		for (unsigned int i = 0; i < mBodies.size(); i++)
+		{
+			GridRange& r = mGridRanges[i];
+			const AABB& box = mBodies[i]->getAABB();
+			if (box.Validity == AABB::Invalid)
+			{
+				r.minX = r.minY = 0;
+				r.maxX = r.maxY = -1;
+				continue;
+			}
+			
+			r = _getGridRange(box);
+			for (int y = r.minY; y <= r.maxY; y++)
+				for (int x = r.minX; x <= r.maxX; x++)
+					mGridCellStart[(y * mGridColumns) + x]++;
+		}
+		
+		// ...turn the counts into the end of each cell's run...
+		for (int c = 1; c < cellCount; c++)
+			mGridCellStart[c] += mGridCellStart[c - 1];
+		mGridCellStart[cellCount] = mGridCellStart[cellCount - 1];
+		
+		// ...and fill the runs back to front, which leaves every cell in mBodies order with its start in place.
+		mGridCellBodies.resize(mGridCellStart[cellCount]);
+		for (int i = (int)mBodies.size() - 1; i >= 0; i--)
+		{
+			const GridRange& r = mGridRanges[i];
+			for (int y = r.minY; y <= r.maxY; y++)
+				for (int x = r.minX; x <= r.maxX; x++)
+					mGridCellBodies[--mGridCellStart[(y * mGridColumns) + x]] = i;
+		}
+		
+		for (int y = 0; y < mGridRows; y++)
+		{
+			for (int x = 0; x < mGridColumns; x++)
+			{
+				int c = (y * mGridColumns) + x;
+				int end = mGridCellStart[c + 1];
+				
+				for (int a = mGridCellStart[c]; a < end; a++)
+				{
+					int iA = mGridCellBodies[a];
+					Body* bA = mBodies[iA];
+					bool activeA = !(bA->getIsStatic() || bA->getIgnoreMe());
+					
+					for (int b = a + 1; b < end; b++)
+					{
+						int iB = mGridCellBodies[b];
+						Body* bB = mBodies[iB];
+						bool activeB = !(bB->getIsStatic() || bB->getIgnoreMe());
+						
+						// same rule as the sweep: at least one of the pair must be moving.
+						if (!activeA && !activeB)
+							continue;
+						
+						if (!bA->getAABB().intersects(bB->getAABB()))
+							continue;
+						
+						// bodies sharing several cells are only paired in the cell holding the corner of their overlap.
+						const GridRange& rA = mGridRanges[iA];
+						const GridRange& rB = mGridRanges[iB];
+						if ((x != ((rA.minX > rB.minX) ? rA.minX : rB.minX)) || (y != ((rA.minY > rB.minY) ? rA.minY : rB.minY)))
+							continue;
+						
+						BodyPair pair;
+						pair.bodyA = activeA ? bA : bB;
+						pair.bodyB = activeA ? bB : bA;
+						mBroadphasePairs.push_back(pair);
+					}
+				}
+			}
+		}
+	}
+	
+	void World::setThreadCount( int count )
+	{
+		if (count == getThreadCount())
+			return;
+		
+		delete mTaskPool;
+		mTaskPool = (count > 1) ? new TaskPool(count) : 0;
+		
+		mNearbyPoints.resize(getThreadCount());
+	}
+	
+	void World::setSleeping( bool val )
+	{
+		mSleeping = val;
+		
+		if (!mSleeping)
+		{
+			for (BodyList::iterator it = mBodies.begin(); it != mBodies.end(); it++)
+				(*it)->wake();
+		}
+	}
+	
+	void World::_narrowphase()
+	{
+		int pairCount = (int)mBroadphasePairs.size();
+		
+		// a single block isn't worth waking the workers for.
+		if ((!mTaskPool) || (pairCount <= NarrowphaseBlockSize))
+		{
+			for (int i = 0; i < pairCount; i++)
+				_goNarrowCheck(mBroadphasePairs[i].bodyA, mBroadphasePairs[i].bodyB, mCollisionList, mNearbyPoints[0]);
+			return;
+		}
+		
+		// edge indices are brought up to date the first time they are asked for, which can't happen from
+		// several threads at once.  refresh them all up front, after that the narrowphase only reads bodies.
 		for (BodyList::iterator it = mBodies.begin(); it != mBodies.end(); it++)
+			(*it)->getEdgeIndex();
+		
+		mBlockSize = std::max(NarrowphaseBlockSize, pairCount / (mTaskPool->getThreadCount() * NarrowphaseBlocksPerThread));
+		
+		int blockCount = (pairCount + mBlockSize - 1) / mBlockSize;
+		if ((int)mBlockCollisions.size() < blockCount)
+			mBlockCollisions.resize(blockCount);
+		
+		mTaskPool->run(&World::_narrowphaseBlock, this, blockCount);
+		
+		for (int b = 0; b < blockCount; b++)
 		{
-			//if ((*it)->getIsStatic()) { continue; }
-			(*it)->dampenVelocity();
+			mCollisionList.insert(mCollisionList.end(), mBlockCollisions[b].begin(), mBlockCollisions[b].end());
+			mBlockCollisions[b].clear();
 		}
 	}
 	
+	void World::_narrowphaseBlock( void* world, int block, int thread )
+	{
+		World* w = (World*)world;
+		
+		int first = block * w->mBlockSize;
+		int last = std::min(first + w->mBlockSize, (int)w->mBroadphasePairs.size());
+		for (int i = first; i < last; i++)
+			w->_goNarrowCheck(w->mBroadphasePairs[i].bodyA, w->mBroadphasePairs[i].bodyB, w->mBlockCollisions[block], w->mNearbyPoints[thread]);
+	}
 	
-	void World::_goNarrowCheck( Body* bI, Body* bJ )
+	void World::_goNarrowCheck( Body* bI, Body* bJ, std::vector<BodyCollisionInfo>& infoList, std::vector<int>& nearbyPoints )
 	{
 		//printf("goNarrow %d vs. %d\n", bI, bJ);
 		
+		// asleep bodies haven't moved, they can only have been hit by something awake.
+		if ((bI->getIsAsleep() || bI->getIsStatic()) && (bJ->getIsAsleep() || bJ->getIsStatic()))
+			return;
+		
 		// grid-based early out.
 		if ( /*((bI->mBitMaskX.mask & bJ->mBitMaskX.mask) == 0) && */
 			((bI->mBitMaskY.mask &bJ->mBitMaskY.mask) == 0))
@@ -405,10 +693,10 @@ namespace JellyPhysics
 		}
 		
 		// okay, the AABB's of these 2 are intersecting.  now check for collision of A against B.
-		bodyCollide(bI, bJ, mCollisionList);
+		bodyCollide(bI, bJ, infoList, nearbyPoints);
 		
 		// and the opposite case, B colliding with A
-		bodyCollide(bJ, bI, mCollisionList);
+		bodyCollide(bJ, bI, infoList, nearbyPoints);
 	}
 	
 	void World::updateBodyBitmask( Body* body )
@@ -618,19 +906,36 @@ namespace JellyPhysics
 				
 				
 	
-	void World::bodyCollide( Body* bA, Body* bB, std::vector<BodyCollisionInfo>& infoList )
+	void World::bodyCollide( Body* bA, Body* bB, std::vector<BodyCollisionInfo>& infoList, std::vector<int>& nearbyPoints )
 	{
 		int bApmCount = bA->getPointMassCount();
 		int bBpmCount = bB->getPointMassCount();
 		
 		AABB boxB = bB->getAABB();
 		
+		Vector2* positionsA = mPointMassPool.getPositions() + bA->mPointMasses.getStart();
+		EdgeIndex* edgesA = bA->getEdgeIndex();
+		EdgeIndex* edgesB = bB->getEdgeIndex();
+		
+		// only the points of a big bodyA near bodyB need checking.  every point starts an edge, so the edges
+		// near bodyB's box give them, sorted so they are checked in the same order as the full loop.
+		int checkCount = bApmCount;
+		if (edgesA)
+		{
+			nearbyPoints.clear();
+			edgesA->queryBox(boxB, nearbyPoints);
+			std::sort(nearbyPoints.begin(), nearbyPoints.end());
+			nearbyPoints.erase(std::unique(nearbyPoints.begin(), nearbyPoints.end()), nearbyPoints.end());
+			checkCount = (int)nearbyPoints.size();
+		}
+		
 		// check all PointMasses on bodyA for collision against bodyB.  if there is a collision, return detailed info.
 		BodyCollisionInfo infoAway;
 		BodyCollisionInfo infoSame;
-		for (int i = 0; i < bApmCount; i++)
+		for (int c = 0; c < checkCount; c++)
 		{
-			Vector2 pt = bA->getPointMass(i)->Position;
+			int i = (edgesA) ? nearbyPoints[c] : c;
+			Vector2 pt = positionsA[i];
 			
 			// early out - if this point is outside the bounding box for bodyB, skip it!
 			if (!boxB.contains(pt))
@@ -649,8 +954,8 @@ namespace JellyPhysics
 			int prevPt = (i>0) ? i-1 : bApmCount-1;
 			int nextPt = (i < bApmCount - 1) ? i + 1 : 0;
 			
-			Vector2 prev = bA->getPointMass(prevPt)->Position;
-			Vector2 next = bA->getPointMass(nextPt)->Position;
+			Vector2 prev = positionsA[prevPt];
+			Vector2 next = positionsA[nextPt];
 			
 			// now get the normal for this point. (NOT A UNIT VECTOR)
 			Vector2 fromPrev = pt - prev;
@@ -660,9 +965,6 @@ namespace JellyPhysics
 			ptNorm.makePerpendicular();
 			
 			// this point is inside the other body.  now check if the edges on either side intersect with and edges on bodyB.          
-			float closestAway = 100000.0f;
-			float closestSame = 100000.0f;
-			
 			infoAway.Clear();
 			infoAway.bodyA = bA;
 			infoAway.bodyApm = i;
@@ -673,80 +975,29 @@ namespace JellyPhysics
 			infoSame.bodyApm = i;
 			infoSame.bodyB = bB;
 			
-			bool found = false;
+			EdgeSearch search;
+			search.body = bB;
+			search.edgeCount = bBpmCount;
+			search.pt = pt;
+			search.ptNorm = ptNorm;
+			search.closestAway = 100000.0f;
+			search.closestSame = 100000.0f;
+			search.found = false;
+			search.infoAway = &infoAway;
+			search.infoSame = &infoSame;
 			
-			int b1 = 0;
-			int b2 = 1;
-			for (int j = 0; j < bBpmCount; j++)
+			if (edgesB)
 			{
-				Vector2 hitPt;
-				Vector2 norm;
-				float edgeD;
-				
-				b1 = j;
-				
-				if (j < bBpmCount - 1)
-					b2 = j + 1;
-				else
-					b2 = 0;
-				
-				//Vector2 pt1 = bB->getPointMass(b1)->Position;
-				//Vector2 pt2 = bB->getPointMass(b2)->Position;
-				
-				// quick test of distance to each point on the edge, if both are greater than current mins, we can skip!
-				//float distToA = (pt1 - pt).lengthSquared();
-				//float distToB = (pt2 - pt).lengthSquared();				
-				
-				/*if ((distToA > closestAway) && (distToA > closestSame) && (distToB > closestAway) && (distToB > closestSame))
-				{
-					//printf("bodyCollide - not close enough\n");
-					continue;
-				}*/
-				
-				// test against this edge.
-				float dist = bB->getClosestPointOnEdgeSquared(pt, j, hitPt, norm, edgeD);
-				//printf("bodyCollide - dist:%f\n", dist);
-				
-				
-				// only perform the check if the normal for this edge is facing AWAY from the point normal.
-				float dot = ptNorm.dotProduct(norm);
-				if (dot <= 0.0f)
-				{
-					if (dist < closestAway)
-					{
-						closestAway = dist;
-						infoAway.bodyBpmA = b1;
-						infoAway.bodyBpmB = b2;
-						infoAway.edgeD = edgeD;
-						infoAway.hitPt = hitPt;
-						infoAway.norm = norm;
-						infoAway.penetration = dist;
-						found = true;
-						
-						//printf("bodyCollide - set away.\n");
-						infoAway.Log();
-					}
-				}
-				else
-				{
-					if (dist < closestSame)
-					{
-						closestSame = dist;
-						infoSame.bodyBpmA = b1;
-						infoSame.bodyBpmB = b2;
-						infoSame.edgeD = edgeD;
-						infoSame.hitPt = hitPt;
-						infoSame.norm = norm;
-						infoSame.penetration = dist;
-						
-						//printf("bodyCollide - set same\n");
-						infoSame.Log();
-					}
-				}
+				edgesB->queryNearest(pt, search);
+			}
+			else
+			{
+				for (int j = 0; j < bBpmCount; j++)
+					search.visit(j);
 			}
 			
 			// we've checked all edges on BodyB.  add the collision info to the stack.
-			if ((found) && (closestAway > mPenetrationThreshold) && (closestSame < closestAway))
+			if ((search.found) && (search.closestAway > mPenetrationThreshold) && (search.closestSame < search.closestAway))
 			{
 				infoSame.penetration = (float)sqrt(infoSame.penetration);
 				infoList.push_back(infoSame);
@@ -762,6 +1013,50 @@ namespace JellyPhysics
 		
 	}
 	
+	void World::EdgeSearch::visit( int edge )
+	{
+		Vector2 hitPt;
+		Vector2 norm;
+		float edgeD;
+		
+		int b1 = edge;
+		int b2 = (edge < (edgeCount - 1)) ? edge + 1 : 0;
+		
+		// test against this edge.
+		float dist = body->getClosestPointOnEdgeSquared(pt, edge, hitPt, norm, edgeD);
+		
+		// only perform the check if the normal for this edge is facing AWAY from the point normal.  the edge index
+		// hands edges over out of order, so ties go to the lowest edge like they would in order.
+		float dot = ptNorm.dotProduct(norm);
+		if (dot <= 0.0f)
+		{
+			if ((dist < closestAway) || ((dist == closestAway) && (b1 < infoAway->bodyBpmA)))
+			{
+				closestAway = dist;
+				infoAway->bodyBpmA = b1;
+				infoAway->bodyBpmB = b2;
+				infoAway->edgeD = edgeD;
+				infoAway->hitPt = hitPt;
+				infoAway->norm = norm;
+				infoAway->penetration = dist;
+				found = true;
+			}
+		}
+		else
+		{
+			if ((dist < closestSame) || ((dist == closestSame) && (b1 < infoSame->bodyBpmA)))
+			{
+				closestSame = dist;
+				infoSame->bodyBpmA = b1;
+				infoSame->bodyBpmB = b2;
+				infoSame->edgeD = edgeD;
+				infoSame->hitPt = hitPt;
+				infoSame->norm = norm;
+				infoSame->penetration = dist;
+			}
+		}
+	}
+	
 	void World::_handleCollisions()
 	{
 		//printf("handleCollisions - count %d\n", mCollisionList.size());
@@ -771,13 +1066,13 @@ namespace JellyPhysics
 		{
 			BodyCollisionInfo info = mCollisionList[i];
 			
-			PointMass* A = info.bodyA->getPointMass(info.bodyApm);
-			PointMass* B1 = info.bodyB->getPointMass(info.bodyBpmA);
-			PointMass* B2 = info.bodyB->getPointMass(info.bodyBpmB);
+			PointMass A = info.bodyA->getPointMass(info.bodyApm);
+			PointMass B1 = info.bodyB->getPointMass(info.bodyBpmA);
+			PointMass B2 = info.bodyB->getPointMass(info.bodyBpmB);
 			
 			// velocity changes as a result of collision.
-			Vector2 bVel = (B1->Velocity + B2->Velocity) * 0.5f;
-			Vector2 relVel = A->Velocity - bVel;
+			Vector2 bVel = (B1.Velocity + B2.Velocity) * 0.5f;
+			Vector2 relVel = A.Velocity - bVel;
 			
 			float relDot = relVel.dotProduct(info.norm);
 			
@@ -808,13 +1103,13 @@ namespace JellyPhysics
 			float b1inf = 1.0f - info.edgeD;
 			float b2inf = info.edgeD;
 			
-			float b2MassSum = ((B1->Mass == 0.0f) || (B2->Mass == 0.0f)) ? 0.0f : (B1->Mass + B2->Mass);
+			float b2MassSum = ((B1.Mass == 0.0f) || (B2.Mass == 0.0f)) ? 0.0f : (B1.Mass + B2.Mass);
 			
-			float massSum = A->Mass + b2MassSum;
+			float massSum = A.Mass + b2MassSum;
 			
 			float Amove;
 			float Bmove;
-			if (A->Mass == 0.0f)
+			if (A.Mass == 0.0f)
 			{
 				Amove = 0.0f;
 				Bmove = (info.penetration) + 0.001f;
@@ -827,7 +1122,7 @@ namespace JellyPhysics
 			else
 			{
 				Amove = (info.penetration * (b2MassSum / massSum));
-				Bmove = (info.penetration * (A->Mass / massSum));
+				Bmove = (info.penetration * (A.Mass / massSum));
 			}
 			
 			float B1move = Bmove * b1inf;
@@ -835,22 +1130,22 @@ namespace JellyPhysics
 			
 			//printf("handleCollisions - Amove:%f B1move:%f B2move:%f\n",
 			//	   Amove, B1move, B2move)
-			if (A->Mass != 0.0f)
+			if (A.Mass != 0.0f)
 			{
-				A->Position += info.norm * Amove;
+				A.Position += info.norm * Amove;
 			}
 			
-			if (B1->Mass != 0.0f)
+			if (B1.Mass != 0.0f)
 			{
-				B1->Position -= info.norm * B1move;
+				B1.Position -= info.norm * B1move;
 			}
 			
-			if (B2->Mass != 0.0f)
+			if (B2.Mass != 0.0f)
 			{
-				B2->Position -= info.norm * B2move;
+				B2.Position -= info.norm * B2move;
 			}
 			
-			float AinvMass = (A->Mass == 0.0f) ? 0.0f : 1.0f / A->Mass;
+			float AinvMass = (A.Mass == 0.0f) ? 0.0f : 1.0f / A.Mass;
 			float BinvMass = (b2MassSum == 0.0f) ? 0.0f : 1.0f / b2MassSum;
 			
 			float jDenom = AinvMass + BinvMass;
@@ -872,25 +1167,161 @@ namespace JellyPhysics
 			// adjust velocity if relative velocity is moving toward each other.
 			if (relDot <= 0.0001f)
 			{
-				if (A->Mass != 0.0f)
+				if (A.Mass != 0.0f)
 				{
-					A->Velocity += (info.norm * (j / A->Mass)) - (tangent * (f / A->Mass));
+					A.Velocity += (info.norm * (j / A.Mass)) - (tangent * (f / A.Mass));
 				}
 				
 				if (b2MassSum != 0.0f)
 				{
-					B1->Velocity -= (info.norm * (j / b2MassSum) * b1inf) - (tangent * (f / b2MassSum) * b1inf);
+					B1.Velocity -= (info.norm * (j / b2MassSum) * b1inf) - (tangent * (f / b2MassSum) * b1inf);
 				}
 				
 				if (b2MassSum != 0.0f)
 				{
-					B2->Velocity -= (info.norm * (j / b2MassSum) * b2inf) - (tangent * (f / b2MassSum) * b2inf);
+					B2.Velocity -= (info.norm * (j / b2MassSum) * b2inf) - (tangent * (f / b2MassSum) * b2inf);
 				}
 			}
 		}
 		
 		mCollisionList.clear();
 	}
+	
+	void World::_linkIslands()
+	{
+		// every body starts out as an island of its own.
+		int count = (int)mBodies.size();
+		mIslandParent.resize(count);
+		for (int i = 0; i < count; i++)
+		{
+			mBodies[i]->mIndex = i;
+			mIslandParent[i] = i;
+		}
+		
+		// the narrowphase only checks asleep bodies against awake ones, so any collision wakes them.
+		for (unsigned int c = 0; c < mCollisionList.size(); c++)
+		{
+			mCollisionList[c].bodyA->wake();
+			mCollisionList[c].bodyB->wake();
+		}
+		
+		// soft bodies resting on each other only collide every few steps, so islands are joined wherever the
+		// bounding boxes of two bodies that collide with each other overlap, not just where a collision was found.
+		// resting on the same static body doesn't tie two bodies together.
+		for (unsigned int p = 0; p < mBroadphasePairs.size(); p++)
+		{
+			Body* bA = mBroadphasePairs[p].bodyA;
+			Body* bB = mBroadphasePairs[p].bodyB;
+			
+			if (bA->getIsStatic() || bB->getIsStatic() || bA->getIgnoreMe() || bB->getIgnoreMe())
+				continue;
+			
+			if (!mMaterialPairs[(bA->getMaterial() * mMaterialCount) + bB->getMaterial()].Collide)
+				continue;
+			
+			if (!bA->getAABB().intersects(bB->getAABB()))
+				continue;
+			
+			int a = _findIsland(bA->mIndex);
+			int b = _findIsland(bB->mIndex);
+			if (a != b)
+				mIslandParent[std::max(a, b)] = std::min(a, b);
+		}
+	}
+	
+	int World::_findIsland( int body )
+	{
+		while (mIslandParent[body] != body)
+		{
+			mIslandParent[body] = mIslandParent[mIslandParent[body]];
+			body = mIslandParent[body];
+		}
+		
+		return body;
+	}
+	
+	void World::_updateSleeping( float elapsed )
+	{
+		mStats.awakeBodies = 0;
+		mStats.asleepBodies = 0;
+		mStats.islands = 0;
+		
+		int count = (int)mBodies.size();
+		if (mSleeping)
+		{
+			mIslandAwake.assign(count, 0);
+			mIslandFirst.assign(count, -1);
+			mIslandLast.assign(count, -1);
+		}
+		
+		// count bodies, update rest times, and find the islands that have to stay awake.
+		for (int i = 0; i < count; i++)
+		{
+			Body* b = mBodies[i];
+			if (b->getIsStatic() || b->getIgnoreMe()) { continue; }
+			
+			if (b->getIsAsleep())
+			{
+				mStats.asleepBodies++;
+				continue;
+			}
+			
+			mStats.awakeBodies++;
+			if (!mSleeping) { continue; }
+			
+			float totalMass = 0.0f;
+			float energy = mPointMassPool.getKineticEnergy(b->mPointMasses.getStart(), b->getPointMassCount(), totalMass);
+			
+			bool resting = ((!b->getIsKinematic()) &&
+				(b->getDerivedVelocity().lengthSquared() < (mSleepVelocity * mSleepVelocity)) &&
+				(energy < (mSleepEnergy * totalMass)));
+			b->mRestTime = (resting) ? (b->mRestTime + elapsed) : 0.0f;
+			
+			int island = _findIsland(i);
+			if (mIslandFirst[island] == -1)
+			{
+				mIslandFirst[island] = i;
+				mStats.islands++;
+			}
+			
+			if (b->mRestTime < mSleepTime)
+				mIslandAwake[island] = 1;
+		}
+		
+		if (!mSleeping)
+			return;
+		
+		// put the other islands to sleep, each linked into a ring so that waking one body wakes them all.
+		for (int i = 0; i < count; i++)
+		{
+			Body* b = mBodies[i];
+			if (b->getIsStatic() || b->getIgnoreMe() || b->getIsAsleep()) { continue; }
+			
+			int island = _findIsland(i);
+			if (mIslandAwake[island]) { continue; }
+			
+			// the island's first body going to sleep takes it out of the awake island count.
+			if (mIslandLast[island] >= 0)
+				mBodies[mIslandLast[island]]->mSleepNext = b;
+			else
+				mStats.islands--;
+			mIslandLast[island] = i;
+			
+			b->mIsAsleep = true;
+			b->mDerivedVel = Vector2::Zero;
+			b->mDerivedOmega = 0.0f;
+			mPointMassPool.setVelocity(b->mPointMasses.getStart(), b->getPointMassCount(), Vector2::Zero);
+			
+			mStats.awakeBodies--;
+			mStats.asleepBodies++;
+		}
+		
+		for (int i = 0; i < count; i++)
+		{
+			if (mIslandLast[i] >= 0)
+				mBodies[mIslandLast[i]]->mSleepNext = mBodies[mIslandFirst[i]];
+		}
+	}
 
 	
 	void World::_removeBoundary( Body::BodyBoundary* me )
@@ -923,6 +1354,372 @@ namespace JellyPhysics
 	}
 	
 	
+	// saved state, see saveState().  everything is 4 bytes wide so the structs have no padding.
+	static const unsigned int StateMagic = 0x5350454a;		// "JEPS"
+	static const unsigned int StateVersion = 2;				// bumped whenever the layout changes.
+	
+	struct SavedBody
+	{
+		Vector2		derivedPos;
+		Vector2		derivedVel;
+		float		derivedAngle;
+		float		derivedOmega;
+		float		lastAngle;
+		Vector2		scale;
+		AABB		aabb;
+		int			bitmaskY;
+		int			asleep;
+		float		restTime;
+		int			sleepNext;		// body index, or -1.
+		int			globalShapeCount;
+		int			edgeInfoCount;
+	};
+	
+	struct SavedBoundary
+	{
+		int			body;			// body index, or -1 for void markers.
+		int			type;
+		float		value;
+	};
+	
+	struct SavedCollision
+	{
+		int			bodyA;
+		int			bodyB;
+		int			bodyApm;
+		int			bodyBpmA;
+		int			bodyBpmB;
+		Vector2		hitPt;
+		float		edgeD;
+		Vector2		norm;
+		float		penetration;
+	};
+	
+	void World::_indexBodies()
+	{
+		for (unsigned int i = 0; i < mBodies.size(); i++)
+			mBodies[i]->mIndex = (int)i;
+	}
+	
+	void World::saveState( std::vector<unsigned char>& buffer )
+	{
+		buffer.clear();
+		_indexBodies();
+		
+		std::vector<unsigned char> bodyState;
+		
+		int bodyCount = (int)mBodies.size();
+		int poolSize = mPointMassPool.size();
+		
+		// header, with enough of the layout to check it against the world it is restored into.
+		Body::writeState(buffer, StateMagic);
+		Body::writeState(buffer, StateVersion);
+		Body::writeState(buffer, bodyCount);
+		Body::writeState(buffer, poolSize);
+		for (int i = 0; i < bodyCount; i++)
+			Body::writeState(buffer, mBodies[i]->getPointMassCount());
+		
+		Body::writeState(buffer, mPenetrationCount);
+		Body::writeState(buffer, mStats);
+		
+		Body::writeState(buffer, mPointMassPool.getMasses(), poolSize);
+		Body::writeState(buffer, mPointMassPool.getPositions(), poolSize);
+		Body::writeState(buffer, mPointMassPool.getVelocities(), poolSize);
+		Body::writeState(buffer, mPointMassPool.getForces(), poolSize);
+		
+		for (int i = 0; i < bodyCount; i++)
+		{
+			Body* b = mBodies[i];
+			
+			SavedBody s;
+			s.derivedPos = b->mDerivedPos;
+			s.derivedVel = b->mDerivedVel;
+			s.derivedAngle = b->mDerivedAngle;
+			s.derivedOmega = b->mDerivedOmega;
+			s.lastAngle = b->mLastAngle;
+			s.scale = b->mScale;
+			s.aabb = b->mAABB;
+			s.bitmaskY = b->mBitMaskY.mask;
+			s.asleep = (b->mIsAsleep) ? 1 : 0;
+			s.restTime = b->mRestTime;
+			s.sleepNext = (b->mSleepNext) ? b->mSleepNext->mIndex : -1;
+			s.globalShapeCount = (int)b->mGlobalShape.size();
+			s.edgeInfoCount = (int)b->mEdgeInfo.size();
+			Body::writeState(buffer, s);
+			
+			// asleep bodies keep the shape and edges they had when they stopped, which the points alone don't give.
+			Body::writeState(buffer, b->mGlobalShape.data(), s.globalShapeCount);
+			Body::writeState(buffer, b->mEdgeInfo.data(), s.edgeInfoCount);
+			
+			// then whatever the body's class keeps, sized so each body can be held to reading exactly its own.
+			bodyState.clear();
+			b->saveState(bodyState);
+			Body::writeState(buffer, (int)bodyState.size());
+			Body::writeState(buffer, bodyState.data(), (int)bodyState.size());
+		}
+		
+		// the boundary list in order, void markers included, since the order pairs are found in is the order
+		// collisions are handled in.
+		std::vector<SavedBoundary> boundaries;
+		if (bodyCount > 0)
+		{
+			Body::BodyBoundary* bb = &mBodies[0]->mBoundStart;
+			while (bb->prev)
+				bb = bb->prev;
+			
+			for (; bb; bb = bb->next)
+			{
+				SavedBoundary s;
+				s.body = (bb->body) ? bb->body->mIndex : -1;
+				s.type = (int)bb->type;
+				s.value = bb->value;
+				boundaries.push_back(s);
+			}
+		}
+		Body::writeState(buffer, (int)boundaries.size());
+		Body::writeState(buffer, boundaries.data(), (int)boundaries.size());
+		
+		// empty between updates, unless a state is saved from inside one.
+		Body::writeState(buffer, (int)mCollisionList.size());
+		for (unsigned int i = 0; i < mCollisionList.size(); i++)
+		{
+			const BodyCollisionInfo& info = mCollisionList[i];
+			
+			SavedCollision s;
+			s.bodyA = info.bodyA->mIndex;
+			s.bodyB = info.bodyB->mIndex;
+			s.bodyApm = info.bodyApm;
+			s.bodyBpmA = info.bodyBpmA;
+			s.bodyBpmB = info.bodyBpmB;
+			s.hitPt = info.hitPt;
+			s.edgeD = info.edgeD;
+			s.norm = info.norm;
+			s.penetration = info.penetration;
+			Body::writeState(buffer, s);
+		}
+	}
+	
+	bool World::restoreState( const std::vector<unsigned char>& buffer )
+	{
+		// read it all once without changing anything, so a bad buffer leaves the world as it was.
+		Body::StateReader check = { buffer.data(), buffer.data() + buffer.size() };
+		if ((!_readState(check, false)) || (check.pos != check.end))
+			return false;
+		
+		Body::StateReader reader = { buffer.data(), buffer.data() + buffer.size() };
+		_readState(reader, true);
+		return true;
+	}
+	
+	bool World::_readState( Body::StateReader& reader, bool apply )
+	{
+		int bodyCount = (int)mBodies.size();
+		int poolSize = mPointMassPool.size();
+		
+		unsigned int magic = 0;
+		unsigned int version = 0;
+		int savedBodyCount = 0;
+		int savedPoolSize = 0;
+		if ((!reader.read(magic)) || (!reader.read(version)) || (!reader.read(savedBodyCount)) || (!reader.read(savedPoolSize)))
+			return false;
+		
+		if ((magic != StateMagic) || (version != StateVersion) || (savedBodyCount != bodyCount) || (savedPoolSize != poolSize))
+			return false;
+		
+		for (int i = 0; i < bodyCount; i++)
+		{
+			int pointCount = 0;
+			if ((!reader.read(pointCount)) || (pointCount != mBodies[i]->getPointMassCount()))
+				return false;
+		}
+		
+		int penetrationCount = 0;
+		Stats stats;
+		if ((!reader.read(penetrationCount)) || (!reader.read(stats)))
+			return false;
+		
+		if (apply)
+		{
+			mPenetrationCount = penetrationCount;
+			mStats = stats;
+		}
+		
+		if ((!reader.read((apply) ? mPointMassPool.getMasses() : (float*)0, poolSize)) ||
+			(!reader.read((apply) ? mPointMassPool.getPositions() : (Vector2*)0, poolSize)) ||
+			(!reader.read((apply) ? mPointMassPool.getVelocities() : (Vector2*)0, poolSize)) ||
+			(!reader.read((apply) ? mPointMassPool.getForces() : (Vector2*)0, poolSize)))
+			return false;
+		
+		for (int i = 0; i < bodyCount; i++)
+		{
+			Body* b = mBodies[i];
+			
+			SavedBody s;
+			if (!reader.read(s))
+				return false;
+			
+			if ((s.sleepNext < -1) || (s.sleepNext >= bodyCount) ||
+				(s.globalShapeCount != (int)b->mGlobalShape.size()) || (s.edgeInfoCount != (int)b->mEdgeInfo.size()))
+				return false;
+			
+			if ((!reader.read((apply) ? b->mGlobalShape.data() : (Vector2*)0, s.globalShapeCount)) ||
+				(!reader.read((apply) ? b->mEdgeInfo.data() : (Body::EdgeInfo*)0, s.edgeInfoCount)))
+				return false;
+			
+			int bodyStateSize = 0;
+			if ((!reader.read(bodyStateSize)) || (bodyStateSize < 0) || ((size_t)(reader.end - reader.pos) < (size_t)bodyStateSize))
+				return false;
+			
+			Body::StateReader bodyState = { reader.pos, reader.pos + bodyStateSize };
+			if ((!b->restoreState(bodyState, apply)) || (bodyState.pos != bodyState.end))
+				return false;
+			reader.pos = bodyState.end;
+			
+			if (apply)
+			{
+				b->mDerivedPos = s.derivedPos;
+				b->mDerivedVel = s.derivedVel;
+				b->mDerivedAngle = s.derivedAngle;
+				b->mDerivedOmega = s.derivedOmega;
+				b->mLastAngle = s.lastAngle;
+				b->mScale = s.scale;
+				b->mAABB = s.aabb;
+				b->mBitMaskY.mask = s.bitmaskY;
+				b->mIsAsleep = (s.asleep != 0);
+				b->mRestTime = s.restTime;
+				b->mSleepNext = (s.sleepNext >= 0) ? mBodies[s.sleepNext] : 0;
+				
+				// the points have moved under the edge index.
+				b->mEdgeIndex.invalidate();
+			}
+		}
+		
+		int boundaryCount = 0;
+		if (!reader.read(boundaryCount))
+			return false;
+		
+		std::vector<SavedBoundary> boundaries(std::max(boundaryCount, 0));
+		if (!reader.read(boundaries.data(), boundaryCount))
+			return false;
+		
+		// every body's begin and then its end, once each, plus any number of void markers.
+		std::vector<unsigned char> boundariesSeen(bodyCount, 0);
+		for (int i = 0; i < boundaryCount; i++)
+		{
+			const SavedBoundary& s = boundaries[i];
+			if (s.body == -1)
+			{
+				if (s.type != Body::BodyBoundary::VoidMarker)
+					return false;
+			}
+			else if ((s.body < 0) || (s.body >= bodyCount))
+			{
+				return false;
+			}
+			else if (s.type == Body::BodyBoundary::Begin)
+			{
+				if (boundariesSeen[s.body] != 0)
+					return false;
+				boundariesSeen[s.body] = 1;
+			}
+			else if (s.type == Body::BodyBoundary::End)
+			{
+				if (boundariesSeen[s.body] != 1)
+					return false;
+				boundariesSeen[s.body] = 2;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		
+		for (int i = 0; i < bodyCount; i++)
+		{
+			if (boundariesSeen[i] != 2)
+				return false;
+		}
+		
+		if (apply && (bodyCount > 0))
+		{
+			// drop the current void markers, then link the boundaries up again in the saved order.
+			Body::BodyBoundary* bb = &mBodies[0]->mBoundStart;
+			while (bb->prev)
+				bb = bb->prev;
+			
+			while (bb)
+			{
+				Body::BodyBoundary* next = bb->next;
+				if (bb->type == Body::BodyBoundary::VoidMarker)
+					delete bb;
+				bb = next;
+			}
+			
+			Body::BodyBoundary* prev = 0;
+			for (int i = 0; i < boundaryCount; i++)
+			{
+				const SavedBoundary& s = boundaries[i];
+				
+				if (s.body == -1)
+				{
+					bb = new Body::BodyBoundary(0, Body::BodyBoundary::VoidMarker, s.value);
+				}
+				else
+				{
+					bb = (s.type == Body::BodyBoundary::Begin) ? &mBodies[s.body]->mBoundStart : &mBodies[s.body]->mBoundEnd;
+					bb->value = s.value;
+				}
+				
+				bb->prev = prev;
+				bb->next = 0;
+				if (prev)
+					prev->next = bb;
+				prev = bb;
+			}
+		}
+		
+		int collisionCount = 0;
+		if (!reader.read(collisionCount) || (collisionCount < 0))
+			return false;
+		
+		if (apply)
+			mCollisionList.clear();
+		
+		for (int i = 0; i < collisionCount; i++)
+		{
+			SavedCollision s;
+			if (!reader.read(s))
+				return false;
+			
+			if ((s.bodyA < 0) || (s.bodyA >= bodyCount) || (s.bodyB < 0) || (s.bodyB >= bodyCount))
+				return false;
+			
+			// the points are looked up without checks when the collision is handled.
+			int countA = mBodies[s.bodyA]->getPointMassCount();
+			int countB = mBodies[s.bodyB]->getPointMassCount();
+			if ((s.bodyApm < 0) || (s.bodyApm >= countA) ||
+				(s.bodyBpmA < 0) || (s.bodyBpmA >= countB) || (s.bodyBpmB < 0) || (s.bodyBpmB >= countB))
+				return false;
+			
+			if (apply)
+			{
+				BodyCollisionInfo info;
+				info.bodyA = mBodies[s.bodyA];
+				info.bodyB = mBodies[s.bodyB];
+				info.bodyApm = s.bodyApm;
+				info.bodyBpmA = s.bodyBpmA;
+				info.bodyBpmB = s.bodyBpmB;
+				info.hitPt = s.hitPt;
+				info.edgeD = s.edgeD;
+				info.norm = s.norm;
+				info.penetration = s.penetration;
+				mCollisionList.push_back(info);
+			}
+		}
+		
+		return true;
+	}
+	
 	void World::_logBoundaries()
 	{
 		// first, find the "first" boundary in the list...
@@ -4,6 +4,9 @@
 #include "JellyPrerequisites.h"
 #include "Vector2.h"
 #include "Body.h"
+#include "TaskPool.h"
+
+#include <chrono>
 
 
 namespace JellyPhysics 
@@ -27,10 +30,55 @@ namespace JellyPhysics
 			CollisionCallback*	Callback;
 		};
 		
+		// broadphase used to find the body pairs handed to the narrowphase.
+		enum BroadphaseType
+		{
+			// sorted list of body X extents, kept up to date incrementally (default).
+			BroadphaseSweepAndPrune,
+			
+			// uniform grid over the world limits, each overlapping pair reported once.
+			BroadphaseUniformGrid
+		};
+		
+		// body counts from the last update.  static and ignored bodies are not counted.
+		struct Stats
+		{
+			int		awakeBodies;
+			int		asleepBodies;
+			int		islands;		// groups of awake bodies touching each other, only counted while sleeping is on.
+		};
+		
+		// seconds spent in each phase of update(), summed since the times were last reset.  integration also covers
+		// force accumulation, bounding boxes, damping and sleep bookkeeping; collision response covers linking
+		// islands and resolving the collisions the narrowphase found.
+		struct PhaseTimes
+		{
+			double	integration;
+			double	broadphase;
+			double	narrowphase;
+			double	collisionResponse;
+		};
+		
 	private:
 		typedef std::vector<Body*>	BodyList;
 		
+		struct BodyPair
+		{
+			Body*	bodyA;
+			Body*	bodyB;
+		};
+		
+		// cells covered by a body's AABB, inclusive.
+		struct GridRange
+		{
+			int		minX;
+			int		minY;
+			int		maxX;
+			int		maxY;
+		};
+		
 		BodyList		mBodies;
+		PointMassPool	mPointMassPool;
 		AABB			mWorldLimits;
 		Vector2			mWorldSize;
 		Vector2			mWorldGridStep;
@@ -67,6 +115,62 @@ namespace JellyPhysics
 		
 		std::vector<BodyCollisionInfo>		mCollisionList;
 		
+		// nearest edges of one body to a point of another that has gone inside it, see bodyCollide().
+		struct EdgeSearch
+		{
+			Body*				body;
+			int					edgeCount;
+			Vector2				pt;
+			Vector2				ptNorm;
+			float				closestAway;
+			float				closestSame;
+			bool				found;
+			BodyCollisionInfo*	infoAway;
+			BodyCollisionInfo*	infoSame;
+			
+			// edges further away than this can't change the result.
+			float getLimit() { return closestAway; }
+			void visit( int edge );
+		};
+		
+		BroadphaseType			mBroadphase;
+		std::vector<BodyPair>	mBroadphasePairs;
+		
+		int						mGridColumns;
+		int						mGridRows;
+		Vector2					mGridCellSize;
+		std::vector<GridRange>	mGridRanges;		// per body, parallel to mBodies.
+		std::vector<int>		mGridCellStart;		// first entry of each cell in mGridCellBodies, plus an end marker.
+		std::vector<int>		mGridCellBodies;	// body indices, grouped by cell.
+		
+		bool					mUseEdgeIndex;
+		
+		// the narrowphase splits mBroadphasePairs into blocks, each with its own collision list, and joins the lists
+		// back up in block order so any thread count or block size gives the same result.  blocks hold at least
+		// NarrowphaseBlockSize pairs, and grow so each thread gets about NarrowphaseBlocksPerThread of them - enough
+		// to even out uneven pairs without paying a task hand-out and a list merge every few pairs.
+		static const int		NarrowphaseBlockSize = 32;
+		static const int		NarrowphaseBlocksPerThread = 8;
+		
+		TaskPool*				mTaskPool;			// null when the narrowphase runs on the calling thread only.
+		int						mBlockSize;			// pairs per block for the current narrowphase.
+		std::vector< std::vector<BodyCollisionInfo> >	mBlockCollisions;
+		std::vector< std::vector<int> >	mNearbyPoints;		// scratch for bodyCollide(), one per thread.
+		
+		bool					mSleeping;
+		float					mSleepVelocity;
+		float					mSleepEnergy;
+		float					mSleepTime;
+		std::vector<int>		mIslandParent;		// union-find over mBodies, joined by this update's collisions.
+		std::vector<char>		mIslandAwake;		// per island root, set when a body in it has not rested long enough.
+		std::vector<int>		mIslandFirst;		// per island root, first and last bodies of its sleep ring.
+		std::vector<int>		mIslandLast;
+		
+		Stats					mStats;
+		
+		bool					mPhaseTiming;
+		PhaseTimes				mPhaseTimes;
+		
 	public:
 		
 		World();
@@ -93,13 +197,90 @@ namespace JellyPhysics
 		
 		void update( float elapsed );
 		
+		// point masses of every body in the world.
+		PointMassPool& getPointMassPool() { return mPointMassPool; }
+		
+		void setBroadphase( BroadphaseType type );
+		BroadphaseType getBroadphase() { return mBroadphase; }
+		
+		void setBroadphaseGridSize( int columns, int rows );
+		
+		// number of body pairs the broadphase handed to the narrowphase during the last update.
+		int getBroadphasePairCount() { return (int)mBroadphasePairs.size(); }
+		
+		// look up nearby edges through each body's EdgeIndex instead of testing every edge (default on).
+		bool getUseEdgeIndex() { return mUseEdgeIndex; }
+		void setUseEdgeIndex( bool val ) { mUseEdgeIndex = val; }
+		
+		// threads the narrowphase runs on, counting the one calling update() (default 1).  the collisions found,
+		// and so the whole simulation, are the same for any count.
+		void setThreadCount( int count );
+		int getThreadCount() { return (mTaskPool) ? mTaskPool->getThreadCount() : 1; }
+		
+		// let islands of touching bodies that have been at rest for a while go to sleep (default off).  asleep
+		// bodies get no forces, are not integrated and only collide with awake bodies, which wakes them.  so do
+		// Body::addGlobalForce(), setVelocity() and setPositionAngle().  forces a body applies to itself in
+		// accumulateExternalForces() can't wake it, Body::wake() has to be called for those.
+		void setSleeping( bool val );
+		bool getSleeping() { return mSleeping; }
+		
+		// a body is at rest while its derived velocity is under the sleep velocity and its kinetic energy per
+		// unit mass is under the sleep energy.  an island goes to sleep once all its bodies have been at rest
+		// for the sleep time, in seconds.  kinematic bodies never rest.
+		float getSleepVelocity() { return mSleepVelocity; }
+		void setSleepVelocity( float val ) { mSleepVelocity = val; }
+		
+		float getSleepEnergy() { return mSleepEnergy; }
+		void setSleepEnergy( float val ) { mSleepEnergy = val; }
+		
+		float getSleepTime() { return mSleepTime; }
+		void setSleepTime( float val ) { mSleepTime = val; }
+		
+		const Stats& getStats() { return mStats; }
+		
+		// time the phases of every update (default off), which reads the clock a few times per update.
+		void setPhaseTiming( bool val ) { mPhaseTiming = val; }
+		bool getPhaseTiming() { return mPhaseTiming; }
+		
+		const PhaseTimes& getPhaseTimes() { return mPhaseTimes; }
+		void resetPhaseTimes();
+		
+		// replace the contents of buffer with the state of the simulation: every point mass, the derived state of
+		// every body along with what its class adds through Body::saveState(), the broadphase ordering and the
+		// collision list.  restoring it into this world, or one built the same way, carries on exactly like this
+		// one would.  the layout is the machine's own, meant for replays and rollback rather than files passed
+		// between platforms.  world settings and materials are not saved.
+		void saveState( std::vector<unsigned char>& buffer );
+		
+		// false, leaving the world untouched, if buffer was saved by another version or from a world with different
+		// bodies or point counts.
+		bool restoreState( const std::vector<unsigned char>& buffer );
+		
 	private:
 		void updateBodyBitmask( Body* b );
 		void sortBodyBoundaries();
 		
-		void _goNarrowCheck( Body* bI, Body* bJ );
-		void bodyCollide( Body* bA, Body* bB, std::vector<BodyCollisionInfo>& infoList );
+		void _sweepBroadphase();
+		void _gridBroadphase();
+		void _updateGridCellSize();
+		GridRange _getGridRange( const AABB& box );
+		
+		void _narrowphase();
+		static void _narrowphaseBlock( void* world, int block, int thread );
+		
+		void _goNarrowCheck( Body* bI, Body* bJ, std::vector<BodyCollisionInfo>& infoList, std::vector<int>& nearbyPoints );
+		void bodyCollide( Body* bA, Body* bB, std::vector<BodyCollisionInfo>& infoList, std::vector<int>& nearbyPoints );
 		void _handleCollisions();
+		
+		int _findIsland( int body );
+		void _linkIslands();
+		void _updateSleeping( float elapsed );
+		
+		// add the time since lap to phase and restart lap from now, if phase timing is on.
+		void _lapPhase( double& phase, std::chrono::steady_clock::time_point& lap );
+		
+		void _indexBodies();
+		bool _readState( Body::StateReader& reader, bool apply );
 
 		void _checkAndMoveBoundary( Body::BodyBoundary* bb );
 		void _removeBoundary( Body::BodyBoundary* me );
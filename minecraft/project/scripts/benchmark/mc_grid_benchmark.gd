@@ -0,0 +1,68 @@
+# Headless MCGrid rebuild benchmark.
+# Run with: make bench_mc
+extends SceneTree
+
+const GRID := Vector3i(4, 2, 4)
+const CHUNK := Vector3i(16, 16, 16)
+const EDITS := 4000
+const SEED := 1337
+const EDIT_BENCH := 500
+const MODE_NAMES := ["per_cell", "baked_chunk", "instanced"]
+
+func _initialize() -> void:
+	var mc_node := MCNode.new()
+	mc_node.mesh_library_path = "res://assets/Marching/Cube.glb"
+	root.add_child(mc_node)
+	mc_node.initialize_library()
+
+	var grid := MCGrid.new()
+	root.add_child(grid)
+	grid.set_mc_node(mc_node)
+	# Baked mode only marks chunks dirty, so filling the grid does not spawn per-cell nodes
+	grid.render_mode = MCGrid.RENDER_BAKED_CHUNK
+	grid.initialize_grid(GRID.x, GRID.y, GRID.z, CHUNK.x, CHUNK.y, CHUNK.z, false)
+	_fill_terrain(grid)
+
+	print("MCGrid benchmark: %d chunks of %s" % [GRID.x * GRID.y * GRID.z, CHUNK])
+	for mode in [MCGrid.RENDER_PER_CELL, MCGrid.RENDER_BAKED_CHUNK, MCGrid.RENDER_INSTANCED]:
+		grid.render_mode = mode
+		var r: Dictionary = grid.benchmark_chunk_rebuild()
+		print("  %-12s nodes=%6d meshes=%6d total=%8.2f ms avg=%7.1f us max=%7d us edit=%6.1f us" % [
+			MODE_NAMES[mode], r.node_count, r.mc_meshes, r.total_usec / 1000.0, r.avg_usec, r.max_usec,
+			_time_edits(grid),
+		])
+		grid.refresh_grid()
+		var t: Dictionary = grid.get_refresh_timings()
+		print("  %-12s parallel refresh: hash=%6.2f ms build=%7.2f ms commit=%7.2f ms" % [
+			"", t.hash_usec / 1000.0, t.build_usec / 1000.0, t.commit_usec / 1000.0,
+		])
+
+	quit()
+
+# Average cost of one modify_corner, including the end-of-frame flush for baked chunks.
+func _time_edits(grid: MCGrid) -> float:
+	var rng := RandomNumberGenerator.new()
+	rng.seed = SEED + 1
+	var size := GRID * CHUNK
+	var t_start := Time.get_ticks_usec()
+	for i in EDIT_BENCH:
+		var p := Vector3i(rng.randi_range(1, size.x - 1), rng.randi_range(1, size.y - 1), rng.randi_range(1, size.z - 1))
+		grid.modify_corner(p, rng.randf() < 0.5)
+	grid.flush_dirty_chunks()
+	return float(Time.get_ticks_usec() - t_start) / EDIT_BENCH
+
+# Rolling heightfield plus random carving so every chunk has mixed cell configurations.
+func _fill_terrain(grid: MCGrid) -> void:
+	var rng := RandomNumberGenerator.new()
+	rng.seed = SEED
+	var size := GRID * CHUNK
+
+	for x in range(1, size.x):
+		for z in range(1, size.z):
+			var h := int(size.y * 0.35 + sin(x * 0.21) * 4.0 + cos(z * 0.17) * 4.0)
+			for y in range(1, clampi(h, 1, size.y - 1)):
+				grid.modify_corner(Vector3i(x, y, z), true)
+
+	for i in EDITS:
+		var p := Vector3i(rng.randi_range(1, size.x - 1), rng.randi_range(1, size.y - 1), rng.randi_range(1, size.z - 1))
+		grid.modify_corner(p, rng.randf() < 0.5)
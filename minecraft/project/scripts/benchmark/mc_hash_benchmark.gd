@@ -0,0 +1,17 @@
+# Headless microbenchmark: scalar get_cell_hash vs. word-parallel compute_cell_hashes.
+# Run with: make bench_mc_hash
+extends SceneTree
+
+const SIZES := [16, 32, 64]
+const ITERATIONS := 50
+
+func _initialize() -> void:
+	var grid := MCGrid.new()
+	print("MC cell hash benchmark (%d passes per size)" % ITERATIONS)
+	for size in SIZES:
+		var r: Dictionary = grid.benchmark_cell_hashes(size, ITERATIONS)
+		print("  %2d^3 cells=%6d scalar=%8.1f us bulk=%8.1f us speedup=%4.1fx match=%s" % [
+			size, r.cells, r.scalar_usec, r.bulk_usec, r.speedup, r.match,
+		])
+	grid.free()
+	quit()
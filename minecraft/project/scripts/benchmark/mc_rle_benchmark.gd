@@ -0,0 +1,18 @@
+# Headless microbenchmark and round-trip fuzz: callback bit RLE vs. packed-word RLE.
+# Run with: make bench_mc_rle
+extends SceneTree
+
+const SIZES := [16, 32, 64]
+const ITERATIONS := 50
+
+func _initialize() -> void:
+	var grid := MCGrid.new()
+	print("MC bit RLE benchmark (%d passes per size)" % ITERATIONS)
+	for size in SIZES:
+		var r: Dictionary = grid.benchmark_rle(size, ITERATIONS)
+		print("  %2d^3 bytes=%6d encode %8.1f -> %7.1f us  decode %8.1f -> %7.1f us  match=%s" % [
+			size, r.bytes, r.encode_reference_usec, r.encode_fast_usec,
+			r.decode_reference_usec, r.decode_fast_usec, r.match,
+		])
+	grid.free()
+	quit()
@@ -0,0 +1,32 @@
+# Headless microbenchmark: SNChunk serialize_rle vs. serialize_quantized size and speed, plus a save/load round trip.
+# Run with: make bench_sn_codec
+extends SceneTree
+
+const CHUNK_SIZES := [16, 32]
+const ITERATIONS := 20
+const SAVE_PATH := "user://sn_codec_benchmark.sngrid"
+
+func _initialize() -> void:
+	var grid := SNGrid.new()
+	print("SN codec benchmark (%d passes per size, 4x2x4 chunks of noise SDF)" % ITERATIONS)
+	for size in CHUNK_SIZES:
+		grid.initialize_grid(4, 2, 4, size, size, size, false)
+		grid.generate_noise_sdf()
+		var r: Dictionary = grid.benchmark_chunk_codec(ITERATIONS)
+		print("  %2d^3 chunks=%d uniform=%d raw=%d rle=%d quantized=%d bytes (%.1f%% of rle) match=%s" % [
+			size, r.chunks, r.uniform_chunks, r.raw_bytes, r.rle_bytes, r.quantized_bytes,
+			100.0 * r.quantized_bytes / max(r.rle_bytes, 1), r.match,
+		])
+		print("       encode rle=%8.1f us quantized=%8.1f us | decode rle=%8.1f us quantized=%8.1f us" % [
+			r.rle_encode_usec, r.quantized_encode_usec, r.rle_decode_usec, r.quantized_decode_usec,
+		])
+
+		grid.save_grid(SAVE_PATH)
+		var t_start := Time.get_ticks_usec()
+		grid.load_grid(SAVE_PATH)
+		print("       save file=%d bytes load_grid=%d us" % [
+			FileAccess.get_file_as_bytes(SAVE_PATH).size(), Time.get_ticks_usec() - t_start,
+		])
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(SAVE_PATH))
+	grid.free()
+	quit()
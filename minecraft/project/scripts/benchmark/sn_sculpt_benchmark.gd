@@ -0,0 +1,37 @@
+# Headless benchmark: brush strokes on 32^3 SNGrid chunks, timed from edit to applied remesh.
+# Run with: make bench_sn_sculpt
+extends SceneTree
+
+const CHUNK := 32
+const STROKES := 20
+const RADIUS := 4
+const FRAME_USEC := 16666
+
+func _initialize() -> void:
+	var grid := SNGrid.new()
+	grid.initialize_grid(2, 2, 2, CHUNK, CHUNK, CHUNK, false)
+	grid.generate_test_sdf()
+
+	var worst := 0
+	var total := 0
+	var center := Vector3i(CHUNK, CHUNK, CHUNK)
+	for s in STROKES:
+		# Each stroke straddles the chunk corner, so up to 8 chunks share the edit
+		var pos := center + Vector3i(s % 3 - 1, s % 5 - 2, s % 7 - 3)
+		var t := Time.get_ticks_usec()
+		for y in range(-RADIUS, RADIUS + 1):
+			for z in range(-RADIUS, RADIUS + 1):
+				for x in range(-RADIUS, RADIUS + 1):
+					if x * x + y * y + z * z <= RADIUS * RADIUS:
+						grid.modify_density(pos + Vector3i(x, y, z), -64 if s % 2 == 0 else 64)
+		grid.flush_dirty_chunks()
+		var elapsed := Time.get_ticks_usec() - t
+		worst = max(worst, elapsed)
+		total += elapsed
+
+	print("SN sculpt benchmark (%d strokes, radius %d, %d^3 chunks)" % [STROKES, RADIUS, CHUNK])
+	print("  avg stroke=%8.1f us  worst=%8d us  last remesh=%8d us  under one frame=%s" % [
+		float(total) / STROKES, worst, grid.get_last_remesh_usec(), worst < FRAME_USEC,
+	])
+	grid.free()
+	quit()
@@ -0,0 +1,239 @@
+/**
+ * @file mc_chunk_baker.cpp
+ * @brief Merges every cell mesh of a marching cubes chunk into a single ArrayMesh.
+ * Module Path: src/marching_cubes/mc_chunk_baker.cpp
+ * Build Dependencies: godot-cpp, mc.h, mc_grid.h, mc_chunk_baker.h
+ */
+
+#include "marching_cubes/mc_chunk_baker.h"
+#include "marching_cubes/mc.h"
+#include "marching_cubes/mc_grid.h"
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <cstring>
+
+namespace godot {
+
+void MCChunkBaker::clear_cache() {
+	for (MCBakeSource &source : sources) {
+		source.mesh.unref();
+		source.surfaces.clear();
+		source.flipped_mesh.unref();
+	}
+}
+
+const MCBakeSource &MCChunkBaker::_get_source(const MeshConfig &p_conf) {
+	MCBakeSource &source = sources[p_conf.source_mesh];
+	if (source.mesh == p_conf.mesh) {
+		return source;
+	}
+
+	source.mesh = p_conf.mesh;
+	source.surfaces.clear();
+	source.flipped_mesh.unref();
+
+	Ref<ArrayMesh> array_mesh = p_conf.mesh;
+	for (int s = 0; s < p_conf.mesh->get_surface_count(); s++) {
+		// Only triangle lists can be merged; lines/points in the library are skipped
+		if (array_mesh.is_valid() && array_mesh->surface_get_primitive_type(s) != Mesh::PRIMITIVE_TRIANGLES) {
+			continue;
+		}
+
+		Array arrays = p_conf.mesh->surface_get_arrays(s);
+		if (arrays[Mesh::ARRAY_VERTEX].get_type() != Variant::PACKED_VECTOR3_ARRAY) {
+			continue;
+		}
+		PackedVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+
+		MCBakeSurface surface;
+		surface.material = p_conf.mesh->surface_get_material(s);
+		surface.vertices.assign(vertices.ptr(), vertices.ptr() + vertices.size());
+
+		if (arrays[Mesh::ARRAY_NORMAL].get_type() == Variant::PACKED_VECTOR3_ARRAY) {
+			PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+			if (normals.size() == vertices.size()) {
+				surface.normals.assign(normals.ptr(), normals.ptr() + normals.size());
+			}
+		}
+
+		if (arrays[Mesh::ARRAY_TEX_UV].get_type() == Variant::PACKED_VECTOR2_ARRAY) {
+			PackedVector2Array uvs = arrays[Mesh::ARRAY_TEX_UV];
+			if (uvs.size() == vertices.size()) {
+				surface.uvs.assign(uvs.ptr(), uvs.ptr() + uvs.size());
+			}
+		}
+
+		if (arrays[Mesh::ARRAY_INDEX].get_type() == Variant::PACKED_INT32_ARRAY) {
+			PackedInt32Array indices = arrays[Mesh::ARRAY_INDEX];
+			surface.indices.assign(indices.ptr(), indices.ptr() + indices.size());
+		} else {
+			surface.indices.resize(surface.vertices.size());
+			for (size_t i = 0; i < surface.indices.size(); i++) {
+				surface.indices[i] = static_cast<int32_t>(i);
+			}
+		}
+
+		source.surfaces.push_back(std::move(surface));
+	}
+
+	return source;
+}
+
+MCBakeBucket &MCChunkBaker::_get_bucket(std::vector<MCBakeBucket> &r_buckets, const Ref<Material> &p_material) {
+	for (MCBakeBucket &bucket : r_buckets) {
+		if (bucket.material == p_material) {
+			return bucket;
+		}
+	}
+	r_buckets.emplace_back();
+	r_buckets.back().material = p_material;
+	return r_buckets.back();
+}
+
+void MCChunkBaker::reset_buckets(std::vector<MCBakeBucket> &r_buckets) {
+	for (MCBakeBucket &bucket : r_buckets) {
+		bucket.vertices.clear();
+		bucket.normals.clear();
+		bucket.uvs.clear();
+		bucket.indices.clear();
+	}
+}
+
+void MCChunkBaker::_append_surface(std::vector<MCBakeBucket> &r_buckets, const MCBakeSurface &p_surface, const Transform3D &p_xform, bool p_flip_winding) {
+	MCBakeBucket &bucket = _get_bucket(r_buckets, p_surface.material);
+	int32_t base = static_cast<int32_t>(bucket.vertices.size());
+
+	// Normals need the inverse-transpose so mirrored/scaled variants stay correct
+	Basis normal_basis = p_xform.basis.inverse().transposed();
+
+	for (size_t i = 0; i < p_surface.vertices.size(); i++) {
+		bucket.vertices.push_back(p_xform.xform(p_surface.vertices[i]));
+		if (p_surface.normals.empty()) {
+			bucket.normals.push_back(Vector3(0, 1, 0));
+		} else {
+			bucket.normals.push_back(normal_basis.xform(p_surface.normals[i]).normalized());
+		}
+		bucket.uvs.push_back(p_surface.uvs.empty() ? Vector2() : p_surface.uvs[i]);
+	}
+
+	const std::vector<int32_t> &indices = p_surface.indices;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		bucket.indices.push_back(base + indices[i]);
+		bucket.indices.push_back(base + indices[p_flip_winding ? i + 2 : i + 1]);
+		bucket.indices.push_back(base + indices[p_flip_winding ? i + 1 : i + 2]);
+	}
+}
+
+Ref<ArrayMesh> MCChunkBaker::commit_buckets(const std::vector<MCBakeBucket> &p_buckets) {
+	Ref<ArrayMesh> mesh;
+
+	for (const MCBakeBucket &bucket : p_buckets) {
+		if (bucket.indices.empty()) {
+			continue;
+		}
+		if (mesh.is_null()) {
+			mesh.instantiate();
+		}
+
+		PackedVector3Array vertices;
+		vertices.resize(static_cast<int64_t>(bucket.vertices.size()));
+		memcpy(vertices.ptrw(), bucket.vertices.data(), bucket.vertices.size() * sizeof(Vector3));
+
+		PackedVector3Array normals;
+		normals.resize(static_cast<int64_t>(bucket.normals.size()));
+		memcpy(normals.ptrw(), bucket.normals.data(), bucket.normals.size() * sizeof(Vector3));
+
+		PackedVector2Array uvs;
+		uvs.resize(static_cast<int64_t>(bucket.uvs.size()));
+		memcpy(uvs.ptrw(), bucket.uvs.data(), bucket.uvs.size() * sizeof(Vector2));
+
+		PackedInt32Array indices;
+		indices.resize(static_cast<int64_t>(bucket.indices.size()));
+		memcpy(indices.ptrw(), bucket.indices.data(), bucket.indices.size() * sizeof(int32_t));
+
+		Array arrays;
+		arrays.resize(Mesh::ARRAY_MAX);
+		arrays[Mesh::ARRAY_VERTEX] = vertices;
+		arrays[Mesh::ARRAY_NORMAL] = normals;
+		arrays[Mesh::ARRAY_TEX_UV] = uvs;
+		arrays[Mesh::ARRAY_INDEX] = indices;
+
+		mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+		if (bucket.material.is_valid()) {
+			mesh->surface_set_material(mesh->get_surface_count() - 1, bucket.material);
+		}
+	}
+
+	return mesh;
+}
+
+void MCChunkBaker::prepare_sources(const MCNode *p_mc_node) {
+	if (!p_mc_node) {
+		return;
+	}
+	for (int h = 1; h < 256; h++) {
+		MeshConfig conf = p_mc_node->get_mesh_config(static_cast<uint8_t>(h));
+		if (conf.mesh.is_valid()) {
+			_get_source(conf);
+		}
+	}
+}
+
+void MCChunkBaker::build_chunk(const Chunk &p_chunk, const uint8_t *p_hashes, const MCNode *p_mc_node, std::vector<MCBakeBucket> &r_buckets, int &r_cell_count) const {
+	r_cell_count = 0;
+	reset_buckets(r_buckets);
+
+	if (!p_mc_node) {
+		return;
+	}
+
+	for (int ly = 0; ly < p_chunk.size_y; ly++) {
+		for (int lz = 0; lz < p_chunk.size_z; lz++) {
+			for (int lx = 0; lx < p_chunk.size_x; lx++) {
+				uint8_t hash = *p_hashes++;
+				if (hash == 0) {
+					continue;
+				}
+
+				MeshConfig conf = p_mc_node->get_mesh_config(hash);
+				const MCBakeSource &source = sources[conf.source_mesh];
+				if (conf.mesh.is_null() || source.mesh != conf.mesh) {
+					continue;
+				}
+
+				// Cell center relative to the chunk origin
+				Transform3D cell_t;
+				cell_t.origin = Vector3(
+						static_cast<float>(lx) + 0.5f,
+						static_cast<float>(ly) + 0.5f,
+						static_cast<float>(lz) + 0.5f);
+				Transform3D xform = cell_t * conf.transform;
+
+				// A MeshInstance3D flips culling for negative-determinant transforms; baked triangles must do it by hand
+				bool mirrored = xform.basis.determinant() < 0.0f;
+				for (const MCBakeSurface &surface : source.surfaces) {
+					_append_surface(r_buckets, surface, xform, mirrored);
+				}
+				r_cell_count++;
+			}
+		}
+	}
+}
+
+Ref<ArrayMesh> MCChunkBaker::get_flipped_mesh(const MeshConfig &p_conf) {
+	_get_source(p_conf);
+	MCBakeSource &source = sources[p_conf.source_mesh];
+	if (source.flipped_mesh.is_valid()) {
+		return source.flipped_mesh;
+	}
+
+	std::vector<MCBakeBucket> buckets;
+	for (const MCBakeSurface &surface : source.surfaces) {
+		_append_surface(buckets, surface, Transform3D(), true);
+	}
+	source.flipped_mesh = commit_buckets(buckets);
+	return source.flipped_mesh;
+}
+
+} // namespace godot
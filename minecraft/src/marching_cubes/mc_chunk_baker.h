@@ -0,0 +1,102 @@
+/**
+ * @file mc_chunk_baker.h
+ * @brief Merges every cell mesh of a marching cubes chunk into a single ArrayMesh.
+ * Module Path: src/marching_cubes/mc_chunk_baker.h
+ * Build Dependencies: godot-cpp, mc.h
+ */
+
+#ifndef MC_CHUNK_BAKER_H
+#define MC_CHUNK_BAKER_H
+
+#include <cstdint>
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/material.hpp>
+#include <godot_cpp/classes/ref.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+#include <vector>
+
+namespace godot {
+
+class MCNode;
+struct Chunk;
+struct MeshConfig;
+
+// Triangle geometry of one source mesh surface, flattened once and reused for every cell.
+struct MCBakeSurface {
+	Ref<Material> material; // Material assigned to the source surface
+	std::vector<Vector3> vertices; // Vertex positions in mesh space
+	std::vector<Vector3> normals; // Vertex normals in mesh space (empty if the source has none)
+	std::vector<Vector2> uvs; // Primary UV channel (empty if the source has none)
+	std::vector<int32_t> indices; // Triangle list, generated sequentially for unindexed sources
+};
+
+// Cached geometry for one base mesh of the MCNode library.
+struct MCBakeSource {
+	Ref<Mesh> mesh; // Mesh the surfaces were extracted from, used to detect stale entries
+	std::vector<MCBakeSurface> surfaces; // Flattened triangle surfaces of the mesh
+	Ref<ArrayMesh> flipped_mesh; // Lazily built copy with reversed winding, for mirrored instances
+};
+
+// Output geometry accumulated for a single material of the baked chunk.
+struct MCBakeBucket {
+	Ref<Material> material; // Material shared by every triangle in this bucket
+	std::vector<Vector3> vertices; // Chunk space vertex positions
+	std::vector<Vector3> normals; // Chunk space vertex normals
+	std::vector<Vector2> uvs; // Primary UV channel
+	std::vector<int32_t> indices; // Triangle list into the bucket vertex arrays
+};
+
+class MCChunkBaker {
+private:
+	MCBakeSource sources[256]; // Geometry cache indexed by MeshConfig::source_mesh
+
+	// Returns the cached surfaces for a mesh config, extracting them on first use.
+	const MCBakeSource &_get_source(const MeshConfig &p_conf);
+	// Returns the output bucket for a material, creating it when missing.
+	static MCBakeBucket &_get_bucket(std::vector<MCBakeBucket> &r_buckets, const Ref<Material> &p_material);
+	// Appends one source surface transformed into chunk space, optionally reversing triangle winding.
+	static void _append_surface(std::vector<MCBakeBucket> &r_buckets, const MCBakeSurface &p_surface, const Transform3D &p_xform, bool p_flip_winding);
+
+public:
+	/*
+	 * Drops all cached source geometry.
+	 * Call after the MCNode library has been reloaded or regenerated.
+	 */
+	void clear_cache();
+
+	/*
+	 * Extracts the geometry of every mesh in the library up front.
+	 * Must run on the main thread before build_chunk is used from workers.
+	 */
+	void prepare_sources(const MCNode *p_mc_node);
+
+	/*
+	 * Appends every non-empty cell of the chunk to r_buckets, one bucket per material.
+	 * Vertices are expressed relative to the chunk origin, with each cell's
+	 * MeshConfig::transform applied on top of its cell center. Only reads the
+	 * prepared cache, so concurrent calls with separate buckets are safe;
+	 * meshes missing from the cache are skipped.
+	 * r_cell_count receives the number of cells that contributed geometry.
+	 */
+	void build_chunk(const Chunk &p_chunk, const uint8_t *p_hashes, const MCNode *p_mc_node, std::vector<MCBakeBucket> &r_buckets, int &r_cell_count) const;
+
+	/*
+	 * Converts the non-empty buckets into ArrayMesh surfaces (main thread).
+	 * Returns a null reference when there is no geometry.
+	 */
+	static Ref<ArrayMesh> commit_buckets(const std::vector<MCBakeBucket> &p_buckets);
+
+	// Empties the buckets while keeping their allocations.
+	static void reset_buckets(std::vector<MCBakeBucket> &r_buckets);
+
+	/*
+	 * Returns the config's mesh with every triangle's winding reversed.
+	 * Instances can't flip face culling individually, so mirrored cells
+	 * drawn through a MultiMesh use this copy to stay front-facing.
+	 */
+	Ref<ArrayMesh> get_flipped_mesh(const MeshConfig &p_conf);
+};
+
+} // namespace godot
+
+#endif // MC_CHUNK_BAKER_H
@@ -0,0 +1,133 @@
+/**
+ * @file mc_chunk_hash.cpp
+ * @brief Word-parallel extraction of marching cubes cell hashes from bit-packed corners.
+ * Module Path: src/marching_cubes/mc_chunk_hash.cpp
+ * Build Dependencies: mc_grid.h
+ *
+ * A row of cells along X reads four corner rows: (y, z), (y, z+1), (y+1, z) and
+ * (y+1, z+1). Each is pulled out of corner_states as a 64-bit window, and groups
+ * of 8 cells are assembled at once by spreading 8 corner bits into 8 bytes
+ * through a lookup table. The resulting 64-bit word holds the hashes of 8
+ * consecutive cells, one per byte.
+ */
+
+#include "mc_grid.h"
+#include <cstring>
+
+namespace godot {
+
+namespace {
+
+// Number of cells covered by one 64-bit window (the last group also needs bit +1).
+constexpr int WINDOW_CELLS = 56;
+
+// SPREAD[b] has byte k set to bit k of b, so 8 corner bits become 8 per-cell flags.
+struct SpreadTable {
+	uint64_t values[256];
+
+	SpreadTable() {
+		for (int b = 0; b < 256; b++) {
+			uint64_t v = 0;
+			for (int k = 0; k < 8; k++) {
+				if (b & (1 << k)) {
+					v |= uint64_t(1) << (k * 8);
+				}
+			}
+			values[b] = v;
+		}
+	}
+};
+
+const SpreadTable SPREAD;
+
+inline uint64_t spread(uint64_t p_bits) {
+	return SPREAD.values[p_bits & 0xFF];
+}
+
+// Returns the 64 corner bits starting at p_bit, zero-padded past the end of the array.
+inline uint64_t load_bits(const uint8_t *p_data, size_t p_size, size_t p_bit) {
+	size_t byte = p_bit >> 3;
+	unsigned shift = p_bit & 7;
+
+	uint8_t window[9] = { 0 };
+	if (byte + 9 <= p_size) {
+		memcpy(window, p_data + byte, 9);
+	} else if (byte < p_size) {
+		memcpy(window, p_data + byte, p_size - byte);
+	}
+
+	// corner_states is little-endian bit order: corner i lives in byte i / 8, bit i % 8
+	uint64_t lo = 0;
+	for (int i = 7; i >= 0; i--) {
+		lo = (lo << 8) | window[i];
+	}
+	uint64_t bits = lo >> shift;
+	if (shift) {
+		bits |= uint64_t(window[8]) << (64 - shift);
+	}
+	return bits;
+}
+
+} // namespace
+
+void Chunk::compute_row_hashes(int p_y, int p_z, uint8_t *r_hashes) const {
+	if (corner_states.empty()) {
+		memset(r_hashes, 0, static_cast<size_t>(size_x));
+		return;
+	}
+
+	const uint8_t *data = corner_states.data();
+	size_t size = corner_states.size();
+	size_t nx = static_cast<size_t>(size_x + 1);
+	size_t nz = static_cast<size_t>(size_z + 1);
+
+	size_t row_yz = (static_cast<size_t>(p_y) * nz + p_z) * nx;
+	size_t row_yz1 = row_yz + nx;
+	size_t row_y1z = row_yz + nx * nz;
+	size_t row_y1z1 = row_y1z + nx;
+
+	for (int x0 = 0; x0 < size_x; x0 += WINDOW_CELLS) {
+		uint64_t r0 = load_bits(data, size, row_yz + x0); // (x, y, z)
+		uint64_t r1 = load_bits(data, size, row_yz1 + x0); // (x, y, z+1)
+		uint64_t r2 = load_bits(data, size, row_y1z + x0); // (x, y+1, z)
+		uint64_t r3 = load_bits(data, size, row_y1z1 + x0); // (x, y+1, z+1)
+
+		int cells = MIN(WINDOW_CELLS, size_x - x0);
+		for (int g = 0; g < cells; g += 8) {
+			// Bit order matches get_cell_hash: c0..c7
+			uint64_t hashes = spread(r1 >> g) |
+					(spread(r1 >> (g + 1)) << 1) |
+					(spread(r0 >> (g + 1)) << 2) |
+					(spread(r0 >> g) << 3) |
+					(spread(r3 >> g) << 4) |
+					(spread(r3 >> (g + 1)) << 5) |
+					(spread(r2 >> (g + 1)) << 6) |
+					(spread(r2 >> g) << 7);
+
+			uint8_t bytes[8];
+			for (int k = 0; k < 8; k++) {
+				bytes[k] = static_cast<uint8_t>(hashes >> (k * 8));
+			}
+			if (cells - g >= 8) {
+				memcpy(r_hashes + x0 + g, bytes, 8);
+			} else {
+				memcpy(r_hashes + x0 + g, bytes, static_cast<size_t>(cells - g));
+			}
+		}
+	}
+}
+
+void Chunk::compute_cell_hashes(std::vector<uint8_t> &r_hashes) const {
+	size_t row = static_cast<size_t>(size_x);
+	r_hashes.resize(row * size_y * size_z);
+
+	uint8_t *out = r_hashes.data();
+	for (int y = 0; y < size_y; y++) {
+		for (int z = 0; z < size_z; z++) {
+			compute_row_hashes(y, z, out);
+			out += row;
+		}
+	}
+}
+
+} // namespace godot
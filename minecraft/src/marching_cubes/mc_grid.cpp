@@ -11,6 +11,7 @@
 #include <godot_cpp/classes/shader_material.hpp>
 #include <godot_cpp/classes/standard_material3d.hpp>
 #include <godot_cpp/classes/static_body3d.hpp>
+#include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/classes/v_box_container.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
@@ -36,8 +37,24 @@ void MCGrid::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_mc_node", "node"), &MCGrid::set_mc_node);
 	ClassDB::bind_method(D_METHOD("get_mc_node"), &MCGrid::get_mc_node);
 
+	ClassDB::bind_method(D_METHOD("set_render_mode", "mode"), &MCGrid::set_render_mode);
+	ClassDB::bind_method(D_METHOD("get_render_mode"), &MCGrid::get_render_mode);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "render_mode", PROPERTY_HINT_ENUM, "PerCell,BakedChunk,Instanced"), "set_render_mode", "get_render_mode");
+
+	ClassDB::bind_method(D_METHOD("flush_dirty_chunks"), &MCGrid::flush_dirty_chunks);
+	ClassDB::bind_method(D_METHOD("benchmark_chunk_rebuild"), &MCGrid::benchmark_chunk_rebuild);
+	ClassDB::bind_method(D_METHOD("benchmark_cell_hashes", "size", "iterations"), &MCGrid::benchmark_cell_hashes);
+	ClassDB::bind_method(D_METHOD("benchmark_rle", "size", "iterations"), &MCGrid::benchmark_rle);
+	ClassDB::bind_method(D_METHOD("get_refresh_timings"), &MCGrid::get_refresh_timings);
+	ClassDB::bind_method(D_METHOD("_hash_chunk_task", "index"), &MCGrid::_hash_chunk_task);
+	ClassDB::bind_method(D_METHOD("_build_chunk_task", "index"), &MCGrid::_build_chunk_task);
+
 	ClassDB::bind_method(D_METHOD("save_grid", "path"), &MCGrid::save_grid);
 	ClassDB::bind_method(D_METHOD("load_grid", "path"), &MCGrid::load_grid);
+
+	BIND_ENUM_CONSTANT(RENDER_PER_CELL);
+	BIND_ENUM_CONSTANT(RENDER_BAKED_CHUNK);
+	BIND_ENUM_CONSTANT(RENDER_INSTANCED);
 }
 
 MCGrid::MCGrid() {
@@ -70,6 +87,16 @@ MCNode *MCGrid::get_mc_node() const {
 	return mc_node;
 }
 
+void MCGrid::set_render_mode(RenderMode p_mode) {
+	if (render_mode == p_mode) {
+		return;
+	}
+	render_mode = p_mode;
+	if (is_inside_tree() && !chunks.empty()) {
+		refresh_grid();
+	}
+}
+
 void MCGrid::_ready() {
 	if (Engine::get_singleton()->is_editor_hint()) {
 		return;
@@ -105,6 +132,8 @@ void MCGrid::initialize_grid(int p_chunks_x, int p_chunks_y, int p_chunks_z, int
 				
 				int num_cells = chunk_size.x * chunk_size.y * chunk_size.z;
 				c.cell_visuals.assign(static_cast<size_t>(num_cells), nullptr);
+				c.cell_batch_keys.assign(static_cast<size_t>(num_cells), 0);
+				c.cell_slots.assign(static_cast<size_t>(num_cells), -1);
 				
 				c.debug_visuals.assign(static_cast<size_t>(num_corners), nullptr);
 			}
@@ -131,11 +160,14 @@ void MCGrid::refresh_grid() {
 
 	int spawn_count = 0;
 
-	for (Chunk &chunk : chunks) {
-		if (mc_node) {
-			spawn_count += _spawn_marching_cubes(chunk, mc_node);
-		}
+	// The MCNode library may have been regenerated since the last bake
+	baker.clear_cache();
 
+	if (mc_node) {
+		spawn_count += _refresh_chunks();
+	}
+
+	for (Chunk &chunk : chunks) {
 		if (!debug_corners_container) {
 			debug_corners_container = memnew(Node3D);
 			debug_corners_container->set_name("DebugCorners");
@@ -150,53 +182,177 @@ void MCGrid::refresh_grid() {
 	UtilityFunctions::print("MCGrid Refresh: ", spawn_count, " visual nodes spawned.");
 }
 
-int MCGrid::_spawn_marching_cubes(const Chunk &p_chunk, MCNode *p_mc_node) {
-	int count = 0;
+int MCGrid::_commit_cell_visuals(Chunk &p_chunk, const MCChunkBuild &p_build) {
+	Vector3 chunk_origin = Vector3(
+			static_cast<float>(p_chunk.loc_x * p_chunk.size_x),
+			static_cast<float>(p_chunk.loc_y * p_chunk.size_y),
+			static_cast<float>(p_chunk.loc_z * p_chunk.size_z));
+
+	for (const MCCellSpawn &spawn : p_build.spawns) {
+		MeshConfig conf = mc_node->get_mesh_config(spawn.hash);
+
+		MeshInstance3D *mi = memnew(MeshInstance3D);
+		mi->set_mesh(conf.mesh);
+		Transform3D xform = spawn.xform;
+		xform.origin += chunk_origin;
+		mi->set_transform(xform);
+		mi->set_cast_shadows_setting(GeometryInstance3D::SHADOW_CASTING_SETTING_OFF);
+		add_child(mi);
+
+		if (is_inside_tree()) {
+			mi->set_owner(get_owner() ? get_owner() : this);
+		}
 
-	for (int ly = 0; ly < p_chunk.size_y; ly++) {
-		for (int lz = 0; lz < p_chunk.size_z; lz++) {
-			for (int lx = 0; lx < p_chunk.size_x; lx++) {
-				uint8_t hash = p_chunk.get_cell_hash(lx, ly, lz);
-				total_cells++;
+		// Store the pointer for granular updates
+		p_chunk.cell_visuals[spawn.cell_idx] = mi;
+		total_mc_meshes++;
+	}
+	return static_cast<int>(p_build.spawns.size());
+}
 
-				if (hash == 0) {
-					continue;
-				}
+int MCGrid::_commit_baked_chunk(Chunk &p_chunk, const MCChunkBuild &p_build) {
+	p_chunk.mesh_dirty = false;
 
-				MeshConfig conf = p_mc_node->get_mesh_config(hash);
-				if (conf.mesh.is_null()) {
-					continue;
-				}
+	Ref<ArrayMesh> mesh = MCChunkBaker::commit_buckets(p_build.buckets);
 
-				// Spawn at center of the 8 corners (cell center)
-				Vector3 world_pos = Vector3(
-						static_cast<float>((p_chunk.loc_x * p_chunk.size_x) + lx) + 0.5f,
-						static_cast<float>((p_chunk.loc_y * p_chunk.size_y) + ly) + 0.5f,
-						static_cast<float>((p_chunk.loc_z * p_chunk.size_z) + lz) + 0.5f);
-
-				MeshInstance3D *mi = memnew(MeshInstance3D);
-				mi->set_mesh(conf.mesh);
-				Transform3D cell_t;
-				cell_t.origin = world_pos;
-				mi->set_transform(cell_t * conf.transform);
-				mi->set_cast_shadows_setting(GeometryInstance3D::SHADOW_CASTING_SETTING_OFF);
-				add_child(mi);
-
-				if (is_inside_tree()) {
-					mi->set_owner(get_owner() ? get_owner() : this);
-				}
-				
-				// Store the pointer for granular updates
-				int cell_idx = (ly * p_chunk.size_x * p_chunk.size_z) + (lz * p_chunk.size_x) + lx;
-				const_cast<Chunk&>(p_chunk).cell_visuals[cell_idx] = mi;
+	if (mesh.is_null()) {
+		if (p_chunk.baked_visual) {
+			p_chunk.baked_visual->queue_free();
+			p_chunk.baked_visual = nullptr;
+			total_mc_meshes--;
+		}
+		return 0;
+	}
+
+	if (!p_chunk.baked_visual) {
+		MeshInstance3D *mi = memnew(MeshInstance3D);
+		mi->set_name("Chunk_" + String::num_int64(p_chunk.loc_x) + "_" + String::num_int64(p_chunk.loc_y) + "_" + String::num_int64(p_chunk.loc_z));
+		mi->set_position(Vector3(
+				static_cast<float>(p_chunk.loc_x * p_chunk.size_x),
+				static_cast<float>(p_chunk.loc_y * p_chunk.size_y),
+				static_cast<float>(p_chunk.loc_z * p_chunk.size_z)));
+		mi->set_cast_shadows_setting(GeometryInstance3D::SHADOW_CASTING_SETTING_OFF);
+		add_child(mi);
+
+		if (is_inside_tree()) {
+			mi->set_owner(get_owner() ? get_owner() : this);
+		}
+
+		p_chunk.baked_visual = mi;
+		total_mc_meshes++;
+	}
+
+	p_chunk.baked_visual->set_mesh(mesh);
+	return 1;
+}
+
+void MCGrid::_queue_dirty_flush() {
+	if (flush_queued) {
+		return;
+	}
+	flush_queued = true;
+	call_deferred("flush_dirty_chunks");
+}
 
-				count++;
-				total_mc_meshes++;
+void MCGrid::flush_dirty_chunks() {
+	flush_queued = false;
+	if (render_mode != RENDER_BAKED_CHUNK) {
+		return;
+	}
+
+	baker.prepare_sources(mc_node);
+	for (Chunk &chunk : chunks) {
+		if (chunk.mesh_dirty) {
+			_rebuild_chunk(chunk);
+		}
+	}
+}
+
+Dictionary MCGrid::benchmark_chunk_rebuild() {
+	Dictionary result;
+	if (!mc_node) {
+		UtilityFunctions::print("MCGrid: benchmark_chunk_rebuild requires an MCNode");
+		return result;
+	}
+
+	_clear_children();
+	baker.clear_cache();
+	baker.prepare_sources(mc_node);
+
+	uint64_t total_usec = 0;
+	uint64_t max_usec = 0;
+
+	for (Chunk &chunk : chunks) {
+		uint64_t t_start = Time::get_singleton()->get_ticks_usec();
+		_rebuild_chunk(chunk);
+		uint64_t elapsed = Time::get_singleton()->get_ticks_usec() - t_start;
+
+		total_usec += elapsed;
+		max_usec = MAX(max_usec, elapsed);
+	}
+
+	int chunk_count = static_cast<int>(chunks.size());
+	result["render_mode"] = static_cast<int>(render_mode);
+	result["chunks"] = chunk_count;
+	result["node_count"] = get_child_count();
+	result["mc_meshes"] = total_mc_meshes;
+	result["total_usec"] = static_cast<int64_t>(total_usec);
+	result["avg_usec"] = chunk_count > 0 ? static_cast<double>(total_usec) / chunk_count : 0.0;
+	result["max_usec"] = static_cast<int64_t>(max_usec);
+
+	UtilityFunctions::print("MCGrid Benchmark: ", result);
+	return result;
+}
+
+Dictionary MCGrid::benchmark_cell_hashes(int p_size, int p_iterations) {
+	Dictionary result;
+	if (p_size <= 0 || p_iterations <= 0) {
+		UtilityFunctions::print("MCGrid: benchmark_cell_hashes needs a positive size and iteration count");
+		return result;
+	}
+
+	Chunk chunk;
+	chunk.size_x = p_size;
+	chunk.size_y = p_size;
+	chunk.size_z = p_size;
+	int num_corners = (p_size + 1) * (p_size + 1) * (p_size + 1);
+	chunk.corner_states.resize(static_cast<size_t>((num_corners + 7) / 8));
+	for (uint8_t &byte : chunk.corner_states) {
+		byte = static_cast<uint8_t>(UtilityFunctions::randi() & 0xFF);
+	}
+
+	size_t num_cells = static_cast<size_t>(p_size) * p_size * p_size;
+	std::vector<uint8_t> scalar(num_cells);
+	std::vector<uint8_t> bulk;
+
+	uint64_t t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		uint8_t *out = scalar.data();
+		for (int y = 0; y < p_size; y++) {
+			for (int z = 0; z < p_size; z++) {
+				for (int x = 0; x < p_size; x++) {
+					*out++ = chunk.get_cell_hash(x, y, z);
+				}
 			}
 		}
 	}
-	return count;
+	uint64_t t_scalar = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		chunk.compute_cell_hashes(bulk);
+	}
+	uint64_t t_bulk = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	result["size"] = p_size;
+	result["cells"] = static_cast<int64_t>(num_cells);
+	result["scalar_usec"] = static_cast<double>(t_scalar) / p_iterations;
+	result["bulk_usec"] = static_cast<double>(t_bulk) / p_iterations;
+	result["speedup"] = t_bulk > 0 ? static_cast<double>(t_scalar) / t_bulk : 0.0;
+	result["match"] = scalar == bulk;
+	return result;
 }
+
 void MCGrid::_clear_children() {
 	TypedArray<Node> children = get_children();
 	for (int i = 0; i < children.size(); i++) {
@@ -221,6 +377,10 @@ void MCGrid::_clear_children() {
 	for (Chunk &chunk : chunks) {
 		std::fill(chunk.cell_visuals.begin(), chunk.cell_visuals.end(), nullptr);
 		std::fill(chunk.debug_visuals.begin(), chunk.debug_visuals.end(), nullptr);
+		chunk.baked_visual = nullptr;
+		chunk.mesh_dirty = false;
+		chunk.instance_batches.clear();
+		std::fill(chunk.cell_slots.begin(), chunk.cell_slots.end(), -1);
 	}
 
 	total_mc_meshes = 0;
@@ -244,6 +404,32 @@ void MCGrid::_update_visual_at(int gx, int gy, int gz) {
 	Chunk &chunk = chunks[_get_chunk_index(cx, cy, cz)];
 	int cell_idx = (ly * chunk.size_x * chunk.size_z) + (lz * chunk.size_x) + lx;
 
+	// Baked chunks are rebuilt once at the end of the frame, however many cells changed
+	if (render_mode == RENDER_BAKED_CHUNK) {
+		chunk.mesh_dirty = true;
+		_queue_dirty_flush();
+		return;
+	}
+
+	if (render_mode == RENDER_INSTANCED) {
+		_remove_cell_instance(chunk, cell_idx);
+		uint8_t hash = chunk.get_cell_hash(lx, ly, lz);
+		if (hash == 0 || !mc_node) {
+			return;
+		}
+		MeshConfig conf = mc_node->get_mesh_config(hash);
+		if (conf.mesh.is_null()) {
+			return;
+		}
+		Transform3D cell_t;
+		cell_t.origin = Vector3(
+				static_cast<float>(lx) + 0.5f,
+				static_cast<float>(ly) + 0.5f,
+				static_cast<float>(lz) + 0.5f);
+		_add_cell_instance(chunk, cell_idx, conf, cell_t * conf.transform);
+		return;
+	}
+
 	// Remove old visual if it exists
 	if (chunk.cell_visuals[cell_idx]) {
 		chunk.cell_visuals[cell_idx]->queue_free();
@@ -364,6 +550,7 @@ void MCGrid::modify_corner(const Vector3i &p_grid_pos, bool p_active) {
 				int idx = _get_chunk_index(cx, cy, cz);
 				Chunk &chunk = chunks[idx];
 				chunk.set_corner(gx - (cx * chunk_size.x), gy - (cy * chunk_size.y), gz - (cz * chunk_size.z), p_active);
+				chunk.save_dirty = true;
 				actual_modified = true;
 			}
 		}
@@ -1,12 +1,17 @@
 #ifndef MC_GRID_H
 #define MC_GRID_H
 
+#include "marching_cubes/mc_chunk_baker.h"
 #include "marching_cubes/mc_spatial.h"
+#include "utils/encoding/region_file.h"
 #include "utils/encoding/rle.h"
 #include <cstdint>
+#include <godot_cpp/classes/multi_mesh.hpp>
 #include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/vector3i.hpp>
+#include <unordered_map>
 #include <vector>
 
 namespace godot {
@@ -15,8 +20,32 @@ class Camera3D;
 class BoxMesh;
 class MCNode;
 class MeshInstance3D;
+class MultiMeshInstance3D;
 class StandardMaterial3D;
 
+// All cells of a chunk that share one source mesh (and handedness), drawn by a single MultiMesh.
+struct MCInstanceBatch {
+	MultiMeshInstance3D *visual = nullptr; // Node drawing the batch, positioned at the chunk origin
+	Ref<MultiMesh> multimesh; // Instance buffer; capacity grows by doubling, visible count tracks live slots
+	std::vector<Transform3D> transforms; // CPU copy of the live slots, chunk-local
+	std::vector<int> slot_cells; // Cell index owning each live slot
+};
+
+// A non-empty cell found by the build phase, in chunk-local space.
+struct MCCellSpawn {
+	int cell_idx = 0; // Index into Chunk::cell_visuals
+	uint8_t hash = 0; // Marching cubes configuration of the cell
+	Transform3D xform; // Cell center * MeshConfig::transform, relative to the chunk origin
+};
+
+// Output of the hash and build refresh phases for one chunk. Filled on worker threads,
+// consumed by the main-thread commit.
+struct MCChunkBuild {
+	std::vector<uint8_t> hashes; // Cell hashes, indexed like Chunk::cell_visuals
+	std::vector<MCCellSpawn> spawns; // Visible cells (RENDER_PER_CELL / RENDER_INSTANCED)
+	std::vector<MCBakeBucket> buckets; // Merged geometry per material (RENDER_BAKED_CHUNK)
+};
+
 struct Chunk {
 	int size_x = 0;
 	int size_y = 0;
@@ -92,6 +121,11 @@ struct Chunk {
 		return hash;
 	}
 
+	// Writes the hashes of the size_x cells in row (y, z), bit-identical to get_cell_hash (mc_chunk_hash.cpp).
+	void compute_row_hashes(int p_y, int p_z, uint8_t *r_hashes) const;
+	// Fills r_hashes with every cell hash of the chunk, indexed like cell_visuals.
+	void compute_cell_hashes(std::vector<uint8_t> &r_hashes) const;
+
 	bool has_active_neighbor(int x, int y, int z) const {
 		if (x > 0 && get_corner(x - 1, y, z))
 			return true;
@@ -126,6 +160,12 @@ struct Chunk {
 
 	std::vector<MeshInstance3D*> cell_visuals;
 	std::vector<MeshInstance3D*> debug_visuals;
+	MeshInstance3D *baked_visual = nullptr; // Single merged mesh used in RENDER_BAKED_CHUNK mode
+	bool mesh_dirty = false; // Baked mesh is stale and waits for the next flush
+	bool save_dirty = true; // Corners differ from the region file; set by edits, cleared once the chunk is written
+	std::unordered_map<uint16_t, MCInstanceBatch> instance_batches; // RENDER_INSTANCED batches keyed by source_mesh | mirrored << 8
+	std::vector<uint16_t> cell_batch_keys; // Batch key of each cell's instance
+	std::vector<int> cell_slots; // Slot of each cell in its batch, -1 when the cell has no instance
 
 	PackedByteArray serialize_rle() const;
 	void deserialize_rle(const PackedByteArray &p_data);
@@ -134,6 +174,13 @@ struct Chunk {
 class MCGrid : public Node3D {
 	GDCLASS(MCGrid, Node3D)
 
+public:
+	enum RenderMode {
+		RENDER_PER_CELL, // One MeshInstance3D per non-empty cell
+		RENDER_BAKED_CHUNK, // One merged ArrayMesh per chunk, rebuilt once per frame when edited
+		RENDER_INSTANCED, // One MultiMesh per source mesh per chunk, edited slot by slot
+	};
+
 private:
 	Vector3i grid_size = Vector3i(1, 1, 1);
 	Vector3i chunk_size = Vector3i(16, 16, 16);
@@ -145,6 +192,15 @@ private:
 	int total_debug_corners = 0;
 	int total_cells = 0;
 	Node3D *debug_corners_container = nullptr;
+	RenderMode render_mode = RENDER_PER_CELL;
+	MCChunkBaker baker; // Merges cell meshes for RENDER_BAKED_CHUNK mode
+	RegionFile region; // Save file last loaded or saved, kept open so later saves only rewrite changed chunks
+	bool flush_queued = false; // A deferred flush_dirty_chunks call is pending
+	std::vector<MCChunkBuild> chunk_builds; // One build slot per chunk for the parallel refresh
+	MCChunkBuild serial_build; // Build slot for single-chunk rebuilds on the main thread
+	uint64_t refresh_hash_usec = 0; // Wall time of the last refresh's hash phase
+	uint64_t refresh_build_usec = 0; // Wall time of the last refresh's build phase
+	uint64_t refresh_commit_usec = 0; // Wall time of the last refresh's commit phase
 
 	Ref<BoxMesh> _debug_box_mesh;
 	Ref<StandardMaterial3D> _debug_mat_blue;
@@ -165,7 +221,32 @@ private:
 	bool _is_boundary_corner(int gx, int gy, int gz, bool &r_required_state) const;
 	void _initialize_boundaries(Chunk &p_chunk) const;
 	int _spawn_debug_cubes(const Chunk &p_chunk, const Ref<BoxMesh> &p_box_mesh);
-	int _spawn_marching_cubes(const Chunk &p_chunk, MCNode *p_mc_node);
+	// Schedules flush_dirty_chunks at the end of the frame, once.
+	void _queue_dirty_flush();
+
+	// Refresh pipeline (mc_grid_refresh.cpp): hash and build are thread-safe, commit is main-thread only
+	void _hash_chunk(const Chunk &p_chunk, MCChunkBuild &r_build) const;
+	void _build_chunk(const Chunk &p_chunk, MCChunkBuild &r_build) const;
+	int _commit_chunk(Chunk &p_chunk, const MCChunkBuild &p_build);
+	// Runs all three phases for one chunk on the calling thread.
+	int _rebuild_chunk(Chunk &p_chunk);
+	// Rebuilds every chunk, spreading hash and build across WorkerThreadPool. Returns the number of visuals committed.
+	int _refresh_chunks();
+	// Runs p_method(index) for every chunk as a WorkerThreadPool group task, or serially without a pool.
+	void _run_chunk_tasks(const StringName &p_method, const String &p_task_name);
+	void _hash_chunk_task(int p_index);
+	void _build_chunk_task(int p_index);
+
+	int _commit_cell_visuals(Chunk &p_chunk, const MCChunkBuild &p_build);
+	// Sets the chunk's merged mesh, reusing its MeshInstance3D.
+	int _commit_baked_chunk(Chunk &p_chunk, const MCChunkBuild &p_build);
+
+	// RENDER_INSTANCED backend (mc_grid_instancing.cpp)
+	int _commit_instanced_chunk(Chunk &p_chunk, const MCChunkBuild &p_build);
+	MCInstanceBatch &_get_instance_batch(Chunk &p_chunk, const MeshConfig &p_conf, bool p_mirrored);
+	void _add_cell_instance(Chunk &p_chunk, int p_cell_idx, const MeshConfig &p_conf, const Transform3D &p_xform);
+	// Swap-removes the cell's slot so the batch stays dense.
+	void _remove_cell_instance(Chunk &p_chunk, int p_cell_idx);
 
 	void _initialize_hover_previews();
 
@@ -222,10 +303,45 @@ public:
 	void set_mc_node(MCNode *p_node);
 	MCNode *get_mc_node() const;
 
+	void set_render_mode(RenderMode p_mode);
+	RenderMode get_render_mode() const {
+		return render_mode;
+	}
+
+	// Rebakes every chunk marked dirty since the last flush (RENDER_BAKED_CHUNK only).
+	void flush_dirty_chunks();
+
+	/*
+	 * Clears all visuals and rebuilds every chunk in the current render mode,
+	 * timing each chunk. Returns chunk count, node count, mesh count and
+	 * total/avg/max rebuild time in microseconds.
+	 */
+	Dictionary benchmark_chunk_rebuild();
+
+	// Phase timings of the last refresh_grid in microseconds (hash, build, commit) plus the chunk count.
+	Dictionary get_refresh_timings() const;
+
+	/*
+	 * Compares get_cell_hash against compute_cell_hashes on a random chunk of
+	 * p_size^3 cells. Returns per-pass microseconds for both paths, the
+	 * speedup and whether the outputs matched.
+	 */
+	Dictionary benchmark_cell_hashes(int p_size, int p_iterations);
+
+	/*
+	 * Round-trip fuzzes the packed-word RLE codec against the callback one
+	 * (outputs must be byte-identical), then times both on a p_size^3
+	 * terrain-like chunk. Returns per-pass encode/decode microseconds,
+	 * the encoded size and whether every check matched.
+	 */
+	Dictionary benchmark_rle(int p_size, int p_iterations);
+
 	void set_show_debug_corners(bool p_show);
 	bool get_show_debug_corners() const;
 };
 
 } // namespace godot
 
+VARIANT_ENUM_CAST(godot::MCGrid::RenderMode);
+
 #endif // MC_GRID_H
@@ -0,0 +1,143 @@
+/**
+ * @file mc_grid_instancing.cpp
+ * @brief RENDER_INSTANCED backend of MCGrid: one MultiMesh per source mesh per chunk.
+ * Module Path: src/marching_cubes/mc_grid_instancing.cpp
+ * Build Dependencies: godot-cpp, mc.h, mc_grid.h, mc_chunk_baker.h
+ */
+
+#include "mc.h"
+#include "mc_grid.h"
+#include <godot_cpp/classes/geometry_instance3d.hpp>
+#include <godot_cpp/classes/multi_mesh_instance3d.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+
+namespace godot {
+
+// Uploads every live slot of the batch in one call, using the 12-float TRANSFORM_3D layout.
+static void upload_batch(MCInstanceBatch &p_batch, int p_capacity) {
+	p_batch.multimesh->set_instance_count(p_capacity);
+
+	PackedFloat32Array buffer_array;
+	buffer_array.resize(static_cast<int64_t>(p_capacity) * 12);
+	float *ptr = buffer_array.ptrw();
+	for (size_t i = 0; i < p_batch.transforms.size(); i++) {
+		const Transform3D &t = p_batch.transforms[i];
+		size_t base = i * 12;
+		ptr[base + 0] = t.basis[0][0];
+		ptr[base + 1] = t.basis[0][1];
+		ptr[base + 2] = t.basis[0][2];
+		ptr[base + 3] = t.origin.x;
+
+		ptr[base + 4] = t.basis[1][0];
+		ptr[base + 5] = t.basis[1][1];
+		ptr[base + 6] = t.basis[1][2];
+		ptr[base + 7] = t.origin.y;
+
+		ptr[base + 8] = t.basis[2][0];
+		ptr[base + 9] = t.basis[2][1];
+		ptr[base + 10] = t.basis[2][2];
+		ptr[base + 11] = t.origin.z;
+	}
+
+	p_batch.multimesh->set_buffer(buffer_array);
+	p_batch.multimesh->set_visible_instance_count(static_cast<int>(p_batch.transforms.size()));
+}
+
+MCInstanceBatch &MCGrid::_get_instance_batch(Chunk &p_chunk, const MeshConfig &p_conf, bool p_mirrored) {
+	uint16_t key = static_cast<uint16_t>(p_conf.source_mesh | (p_mirrored ? 0x100 : 0));
+	MCInstanceBatch &batch = p_chunk.instance_batches[key];
+	if (batch.visual) {
+		return batch;
+	}
+
+	batch.multimesh.instantiate();
+	batch.multimesh->set_transform_format(MultiMesh::TRANSFORM_3D);
+	// Instances can't flip culling individually, so mirrored cells use a winding-reversed copy
+	batch.multimesh->set_mesh(p_mirrored ? Ref<Mesh>(baker.get_flipped_mesh(p_conf)) : p_conf.mesh);
+
+	MultiMeshInstance3D *mmi = memnew(MultiMeshInstance3D);
+	mmi->set_multimesh(batch.multimesh);
+	mmi->set_position(Vector3(
+			static_cast<float>(p_chunk.loc_x * p_chunk.size_x),
+			static_cast<float>(p_chunk.loc_y * p_chunk.size_y),
+			static_cast<float>(p_chunk.loc_z * p_chunk.size_z)));
+	mmi->set_cast_shadows_setting(GeometryInstance3D::SHADOW_CASTING_SETTING_OFF);
+	add_child(mmi);
+
+	if (is_inside_tree()) {
+		mmi->set_owner(get_owner() ? get_owner() : this);
+	}
+
+	batch.visual = mmi;
+	total_mc_meshes++;
+	return batch;
+}
+
+int MCGrid::_commit_instanced_chunk(Chunk &p_chunk, const MCChunkBuild &p_build) {
+	// Collect every instance first so each MultiMesh receives a single buffer upload
+	for (const MCCellSpawn &spawn : p_build.spawns) {
+		MeshConfig conf = mc_node->get_mesh_config(spawn.hash);
+		bool mirrored = spawn.xform.basis.determinant() < 0.0f;
+
+		MCInstanceBatch &batch = _get_instance_batch(p_chunk, conf, mirrored);
+		p_chunk.cell_batch_keys[spawn.cell_idx] = static_cast<uint16_t>(conf.source_mesh | (mirrored ? 0x100 : 0));
+		p_chunk.cell_slots[spawn.cell_idx] = static_cast<int>(batch.transforms.size());
+		batch.transforms.push_back(spawn.xform);
+		batch.slot_cells.push_back(spawn.cell_idx);
+	}
+
+	for (auto &entry : p_chunk.instance_batches) {
+		upload_batch(entry.second, static_cast<int>(entry.second.transforms.size()));
+	}
+	return static_cast<int>(p_build.spawns.size());
+}
+
+void MCGrid::_add_cell_instance(Chunk &p_chunk, int p_cell_idx, const MeshConfig &p_conf, const Transform3D &p_xform) {
+	bool mirrored = p_xform.basis.determinant() < 0.0f;
+	MCInstanceBatch &batch = _get_instance_batch(p_chunk, p_conf, mirrored);
+
+	int slot = static_cast<int>(batch.transforms.size());
+	batch.transforms.push_back(p_xform);
+	batch.slot_cells.push_back(p_cell_idx);
+	p_chunk.cell_batch_keys[p_cell_idx] = static_cast<uint16_t>(p_conf.source_mesh | (mirrored ? 0x100 : 0));
+	p_chunk.cell_slots[p_cell_idx] = slot;
+
+	// set_instance_count discards the buffer, so growth re-uploads from the CPU copy
+	if (slot >= batch.multimesh->get_instance_count()) {
+		upload_batch(batch, MAX(16, batch.multimesh->get_instance_count() * 2));
+		return;
+	}
+
+	batch.multimesh->set_instance_transform(slot, p_xform);
+	batch.multimesh->set_visible_instance_count(slot + 1);
+}
+
+void MCGrid::_remove_cell_instance(Chunk &p_chunk, int p_cell_idx) {
+	int slot = p_chunk.cell_slots[p_cell_idx];
+	if (slot < 0) {
+		return;
+	}
+	p_chunk.cell_slots[p_cell_idx] = -1;
+
+	auto it = p_chunk.instance_batches.find(p_chunk.cell_batch_keys[p_cell_idx]);
+	if (it == p_chunk.instance_batches.end()) {
+		return;
+	}
+	MCInstanceBatch &batch = it->second;
+
+	// Move the last live slot into the hole so only one instance is rewritten
+	int last = static_cast<int>(batch.transforms.size()) - 1;
+	if (slot != last) {
+		int moved_cell = batch.slot_cells[last];
+		batch.transforms[slot] = batch.transforms[last];
+		batch.slot_cells[slot] = moved_cell;
+		p_chunk.cell_slots[moved_cell] = slot;
+		batch.multimesh->set_instance_transform(slot, batch.transforms[slot]);
+	}
+
+	batch.transforms.pop_back();
+	batch.slot_cells.pop_back();
+	batch.multimesh->set_visible_instance_count(last);
+}
+
+} // namespace godot
@@ -0,0 +1,147 @@
+/**
+ * @file mc_grid_refresh.cpp
+ * @brief Three-phase chunk refresh for MCGrid: hash and build on WorkerThreadPool, commit on the main thread.
+ * Module Path: src/marching_cubes/mc_grid_refresh.cpp
+ * Build Dependencies: godot-cpp, mc.h, mc_grid.h, mc_chunk_baker.h
+ *
+ * Hash and build only read corner data and the MCNode library and write into
+ * the chunk's own MCChunkBuild slot, so chunks can be processed in parallel.
+ * Everything that touches the scene tree or creates resources happens in the
+ * commit phase.
+ */
+
+#include "mc.h"
+#include "mc_grid.h"
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+namespace godot {
+
+void MCGrid::_hash_chunk(const Chunk &p_chunk, MCChunkBuild &r_build) const {
+	p_chunk.compute_cell_hashes(r_build.hashes);
+}
+
+void MCGrid::_build_chunk(const Chunk &p_chunk, MCChunkBuild &r_build) const {
+	r_build.spawns.clear();
+
+	if (render_mode == RENDER_BAKED_CHUNK) {
+		int cell_count = 0;
+		baker.build_chunk(p_chunk, r_build.hashes.data(), mc_node, r_build.buckets, cell_count);
+		return;
+	}
+
+	const uint8_t *hash_ptr = r_build.hashes.data();
+	for (int ly = 0; ly < p_chunk.size_y; ly++) {
+		for (int lz = 0; lz < p_chunk.size_z; lz++) {
+			for (int lx = 0; lx < p_chunk.size_x; lx++) {
+				uint8_t hash = *hash_ptr++;
+				if (hash == 0) {
+					continue;
+				}
+
+				MeshConfig conf = mc_node->get_mesh_config(hash);
+				if (conf.mesh.is_null()) {
+					continue;
+				}
+
+				// Cell center relative to the chunk origin
+				Transform3D cell_t;
+				cell_t.origin = Vector3(
+						static_cast<float>(lx) + 0.5f,
+						static_cast<float>(ly) + 0.5f,
+						static_cast<float>(lz) + 0.5f);
+
+				MCCellSpawn spawn;
+				spawn.cell_idx = (ly * p_chunk.size_x * p_chunk.size_z) + (lz * p_chunk.size_x) + lx;
+				spawn.hash = hash;
+				spawn.xform = cell_t * conf.transform;
+				r_build.spawns.push_back(spawn);
+			}
+		}
+	}
+}
+
+int MCGrid::_commit_chunk(Chunk &p_chunk, const MCChunkBuild &p_build) {
+	switch (render_mode) {
+		case RENDER_BAKED_CHUNK:
+			return _commit_baked_chunk(p_chunk, p_build);
+		case RENDER_INSTANCED:
+			return _commit_instanced_chunk(p_chunk, p_build);
+		default:
+			return _commit_cell_visuals(p_chunk, p_build);
+	}
+}
+
+int MCGrid::_rebuild_chunk(Chunk &p_chunk) {
+	_hash_chunk(p_chunk, serial_build);
+	_build_chunk(p_chunk, serial_build);
+	return _commit_chunk(p_chunk, serial_build);
+}
+
+void MCGrid::_hash_chunk_task(int p_index) {
+	_hash_chunk(chunks[p_index], chunk_builds[p_index]);
+}
+
+void MCGrid::_build_chunk_task(int p_index) {
+	_build_chunk(chunks[p_index], chunk_builds[p_index]);
+}
+
+void MCGrid::_run_chunk_tasks(const StringName &p_method, const String &p_task_name) {
+	int num_tasks = static_cast<int>(chunks.size());
+	if (num_tasks <= 0) {
+		return;
+	}
+
+	WorkerThreadPool *wtp = WorkerThreadPool::get_singleton();
+	if (wtp && num_tasks > 1) {
+		int group_id = wtp->add_group_task(Callable(this, p_method), num_tasks, -1, true, p_task_name);
+		wtp->wait_for_group_task_completion(group_id);
+	} else {
+		for (int i = 0; i < num_tasks; i++) {
+			call(p_method, i);
+		}
+	}
+}
+
+int MCGrid::_refresh_chunks() {
+	// Workers only read the geometry cache, so it must be complete before they start
+	if (render_mode == RENDER_BAKED_CHUNK) {
+		baker.prepare_sources(mc_node);
+	}
+	chunk_builds.resize(chunks.size());
+
+	uint64_t t_start = Time::get_singleton()->get_ticks_usec();
+	_run_chunk_tasks("_hash_chunk_task", "MCGrid_Hash");
+
+	uint64_t t_hashed = Time::get_singleton()->get_ticks_usec();
+	_run_chunk_tasks("_build_chunk_task", "MCGrid_Build");
+
+	uint64_t t_built = Time::get_singleton()->get_ticks_usec();
+	int count = 0;
+	for (size_t i = 0; i < chunks.size(); i++) {
+		Chunk &chunk = chunks[i];
+		count += _commit_chunk(chunk, chunk_builds[i]);
+		total_cells += chunk.size_x * chunk.size_y * chunk.size_z;
+	}
+	uint64_t t_committed = Time::get_singleton()->get_ticks_usec();
+
+	refresh_hash_usec = t_hashed - t_start;
+	refresh_build_usec = t_built - t_hashed;
+	refresh_commit_usec = t_committed - t_built;
+
+	UtilityFunctions::print("MCGrid Refresh: ", static_cast<int>(chunks.size()), " chunks | hash ", refresh_hash_usec / 1000.0,
+			" ms | build ", refresh_build_usec / 1000.0, " ms | commit ", refresh_commit_usec / 1000.0, " ms");
+	return count;
+}
+
+Dictionary MCGrid::get_refresh_timings() const {
+	Dictionary result;
+	result["chunks"] = static_cast<int>(chunks.size());
+	result["hash_usec"] = static_cast<int64_t>(refresh_hash_usec);
+	result["build_usec"] = static_cast<int64_t>(refresh_build_usec);
+	result["commit_usec"] = static_cast<int64_t>(refresh_commit_usec);
+	return result;
+}
+
+} // namespace godot
@@ -1,4 +1,6 @@
 #include "godot_cpp/classes/file_access.hpp"
+#include "godot_cpp/classes/time.hpp"
+#include "godot_cpp/core/math.hpp"
 #include "godot_cpp/variant/packed_byte_array.hpp"
 
 #include "mc_grid.h"
@@ -7,9 +9,7 @@ namespace godot {
 
 PackedByteArray Chunk::serialize_rle() const {
 	int num_corners = (size_x + 1) * (size_y + 1) * (size_z + 1);
-	return RLE::encode_bit_rle(num_corners, [this](int i) {
-		return get_corner_bit(i);
-	});
+	return RLE::encode_bit_rle(corner_states.empty() ? nullptr : corner_states.data(), num_corners);
 }
 
 void Chunk::deserialize_rle(const PackedByteArray &p_data) {
@@ -17,42 +17,162 @@ void Chunk::deserialize_rle(const PackedByteArray &p_data) {
 	int num_bytes = (num_corners + 7) / 8;
 	corner_states.assign(static_cast<size_t>(num_bytes), 0);
 
-	RLE::decode_bit_rle(p_data, num_corners, [this](int i, bool state) {
-		set_corner_bit(i, state);
-	});
+	RLE::decode_bit_rle(p_data, num_corners, corner_states.data());
 }
 
-void MCGrid::save_grid(const String &p_path) {
-	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
-	if (f.is_null()) {
-		UtilityFunctions::print("MCGrid: Failed to open file for writing: ", p_path);
-		return;
+Dictionary MCGrid::benchmark_rle(int p_size, int p_iterations) {
+	Dictionary result;
+	if (p_size <= 0 || p_iterations <= 0) {
+		UtilityFunctions::print("MCGrid: benchmark_rle needs a positive size and iteration count");
+		return result;
 	}
 
-	// 1. Header
-	f->store_32(0x4D435452); // Magic: 'MCTR'
-	f->store_32(1); // Version
+	// Round-trip fuzz: random run lengths around the 6-bit, 14-bit and byte boundaries, odd bit counts
+	const int run_lengths[] = { 1, 7, 8, 9, 63, 64, 65, 255, 256, 16382, 16383, 16384, 40000 };
+	bool match = true;
+	for (int round = 0; round < 200 && match; round++) {
+		int num_bits = 1 + static_cast<int>(UtilityFunctions::randi() % 100000);
+		std::vector<uint8_t> bits(static_cast<size_t>((num_bits + 7) / 8), 0);
+		bool state = UtilityFunctions::randi() & 1;
+		for (int pos = 0; pos < num_bits;) {
+			int run = (UtilityFunctions::randi() & 1) ? run_lengths[UtilityFunctions::randi() % 13] : 1 + static_cast<int>(UtilityFunctions::randi() % 200);
+			for (int i = pos; i < MIN(pos + run, num_bits); i++) {
+				if (state) {
+					bits[static_cast<size_t>(i / 8)] |= static_cast<uint8_t>(1 << (i % 8));
+				}
+			}
+			pos += run;
+			state = !state;
+		}
+
+		PackedByteArray reference = RLE::encode_bit_rle(num_bits, [&bits](int i) {
+			return (bits[static_cast<size_t>(i / 8)] & (1 << (i % 8))) != 0;
+		});
+		PackedByteArray fast = RLE::encode_bit_rle(bits.data(), num_bits);
+
+		std::vector<uint8_t> decoded(bits.size(), 0);
+		RLE::decode_bit_rle(fast, num_bits, decoded.data());
+		match = reference == fast && decoded == bits;
+	}
 
-	// 2. Metadata
-	f->store_32(grid_size.x);
-	f->store_32(grid_size.y);
-	f->store_32(grid_size.z);
-	f->store_32(chunk_size.x);
-	f->store_32(chunk_size.y);
-	f->store_32(chunk_size.z);
+	// Timing on a terrain-like chunk: solid below a wavy surface
+	Chunk chunk;
+	chunk.size_x = p_size;
+	chunk.size_y = p_size;
+	chunk.size_z = p_size;
+	int nx = p_size + 1;
+	int num_corners = nx * nx * nx;
+	chunk.corner_states.assign(static_cast<size_t>((num_corners + 7) / 8), 0);
+	for (int y = 0; y < nx; y++) {
+		for (int z = 0; z < nx; z++) {
+			for (int x = 0; x < nx; x++) {
+				float height = p_size * 0.5f + 3.0f * Math::sin(x * 0.4f) * Math::cos(z * 0.3f);
+				chunk.set_corner(x, y, z, y < height);
+			}
+		}
+	}
 
-	// 3. Chunk Data
-	f->store_32(static_cast<uint32_t>(chunks.size()));
-	for (const Chunk &chunk : chunks) {
-		PackedByteArray rle_data = chunk.serialize_rle();
-		f->store_32(static_cast<uint32_t>(rle_data.size()));
-		f->store_buffer(rle_data);
+	PackedByteArray reference;
+	uint64_t t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		reference = RLE::encode_bit_rle(num_corners, [&chunk](int p_index) {
+			return chunk.get_corner_bit(p_index);
+		});
+	}
+	uint64_t t_encode_reference = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	PackedByteArray fast;
+	t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		fast = chunk.serialize_rle();
+	}
+	uint64_t t_encode_fast = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	Chunk decoded = chunk;
+	t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		decoded.corner_states.assign(chunk.corner_states.size(), 0);
+		RLE::decode_bit_rle(reference, num_corners, [&decoded](int p_index, bool p_state) {
+			decoded.set_corner_bit(p_index, p_state);
+		});
 	}
+	uint64_t t_decode_reference = Time::get_singleton()->get_ticks_usec() - t_start;
 
-	UtilityFunctions::print("MCGrid: Saved state to ", p_path);
+	t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		decoded.deserialize_rle(fast);
+	}
+	uint64_t t_decode_fast = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	result["size"] = p_size;
+	result["bytes"] = static_cast<int64_t>(fast.size());
+	result["encode_reference_usec"] = static_cast<double>(t_encode_reference) / p_iterations;
+	result["encode_fast_usec"] = static_cast<double>(t_encode_fast) / p_iterations;
+	result["decode_reference_usec"] = static_cast<double>(t_decode_reference) / p_iterations;
+	result["decode_fast_usec"] = static_cast<double>(t_decode_fast) / p_iterations;
+	result["match"] = match && reference == fast && decoded.corner_states == chunk.corner_states;
+	return result;
+}
+
+void MCGrid::save_grid(const String &p_path) {
+	// Saving over the file the grid came from keeps the region open and only writes edited chunks
+	bool fresh = !region.matches(p_path, grid_size, chunk_size);
+	if (fresh) {
+		if (!region.create(p_path, 0x4D435452, grid_size, chunk_size, static_cast<uint32_t>(chunks.size()))) {
+			UtilityFunctions::print("MCGrid: Failed to open file for writing: ", p_path);
+			return;
+		}
+	}
+
+	int written = 0;
+	for (size_t i = 0; i < chunks.size(); i++) {
+		Chunk &chunk = chunks[i];
+		if ((fresh || chunk.save_dirty) && region.write_chunk(static_cast<uint32_t>(i), chunk.serialize_rle())) {
+			chunk.save_dirty = false;
+			written++;
+		}
+	}
+
+	UtilityFunctions::print("MCGrid: Saved state to ", p_path, " (", written, " of ", static_cast<int>(chunks.size()), " chunks written)");
 }
 
 void MCGrid::load_grid(const String &p_path) {
+	if (RegionFile::is_region_file(p_path)) {
+		if (!region.open(p_path, 0x4D435452)) {
+			UtilityFunctions::print("MCGrid: Invalid region file: ", p_path);
+			return;
+		}
+
+		Vector3i file_grid = region.get_grid_size();
+		Vector3i file_chunk = region.get_chunk_size();
+		if (grid_size != file_grid || chunk_size != file_chunk) {
+			initialize_grid(file_grid.x, file_grid.y, file_grid.z, file_chunk.x, file_chunk.y, file_chunk.z, false);
+		}
+		if (region.get_chunk_count() != chunks.size()) {
+			UtilityFunctions::print("MCGrid: Chunk count mismatch in file.");
+			region.close();
+			return;
+		}
+
+		// Chunks missing from the file, or that fail to read back, keep their contents and still need writing
+		for (size_t i = 0; i < chunks.size(); i++) {
+			PackedByteArray payload;
+			if (region.has_chunk(static_cast<uint32_t>(i))) {
+				payload = region.read_chunk(static_cast<uint32_t>(i));
+			}
+			if (!payload.is_empty()) {
+				chunks[i].deserialize_rle(payload);
+			}
+			chunks[i].save_dirty = payload.is_empty();
+		}
+
+		UtilityFunctions::print("MCGrid: Loaded state from ", p_path);
+		refresh_grid();
+		return;
+	}
+
+	// Legacy single-stream format ('MCTR'); the next save converts it to a region file
+	region.close();
 	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
 	if (f.is_null()) {
 		UtilityFunctions::print("MCGrid: Failed to open file for reading: ", p_path);
@@ -9,6 +9,10 @@
 #include "godot_cpp/classes/mesh_instance3d.hpp"
 #include "godot_cpp/classes/standard_material3d.hpp"
 #include "godot_cpp/classes/static_body3d.hpp"
+#include "godot_cpp/classes/time.hpp"
+#include "godot_cpp/classes/worker_thread_pool.hpp"
+
+#include <cstring>
 
 namespace godot {
 
@@ -31,6 +35,8 @@ void SNGrid::_clear_chunk_visuals(SNChunk &p_chunk) {
 		p_chunk.collision_body->queue_free();
 		p_chunk.collision_body = nullptr;
 	}
+	p_chunk.mesh.unref();
+	p_chunk.collision_shape.unref();
 }
 
 void SNGrid::_ready() {
@@ -45,6 +51,7 @@ void SNGrid::_ready() {
 	} else {
 		generate_test_sdf();
 	}
+	set_process(true);
 }
 
 void SNGrid::set_grid_size(const Vector3i &p_size) {
@@ -117,11 +124,14 @@ void SNGrid::initialize_grid(int p_chunks_x, int p_chunks_y, int p_chunks_z, int
 	for (SNChunk &chunk : chunks) {
 		_clear_chunk_visuals(chunk);
 	}
+	region.close(); // The old chunks are discarded, so there is nothing left to page from it
 
 	grid_size = Vector3i(p_chunks_x, p_chunks_y, p_chunks_z);
 	chunk_size = Vector3i(p_chunk_size_x, p_chunk_size_y, p_chunk_size_z);
 
 	chunks.clear();
+	dirty_chunks.clear();
+	lod_camera_valid = false;
 	chunks.resize(static_cast<size_t>(grid_size.x) * grid_size.y * grid_size.z);
 
 	int num_corners = (chunk_size.x + 1) * (chunk_size.y + 1) * (chunk_size.z + 1);
@@ -155,8 +165,9 @@ void SNGrid::initialize_grid(int p_chunks_x, int p_chunks_y, int p_chunks_z, int
 
 void SNGrid::refresh_grid() {
 	for (size_t i = 0; i < chunks.size(); ++i) {
-		_update_chunk_mesh(static_cast<int>(i));
+		_mark_chunk_dirty(static_cast<int>(i));
 	}
+	flush_dirty_chunks();
 }
 
 bool SNGrid::_is_boundary_corner(int gx, int gy, int gz, int8_t &r_required_density) const {
@@ -198,63 +209,143 @@ void SNGrid::_initialize_boundaries(SNChunk &p_chunk) const {
 	}
 }
 
-void SNGrid::_update_chunk_mesh(int p_chunk_idx) {
+void SNGrid::_mark_chunk_dirty(int p_chunk_idx) {
 	SNChunk &chunk = chunks[static_cast<size_t>(p_chunk_idx)];
-	_clear_chunk_visuals(chunk);
+	if (chunk.mesh_dirty || !chunk.is_resident()) {
+		return;
+	}
+	chunk.mesh_dirty = true;
+	dirty_chunks.push_back(p_chunk_idx);
+
+	if (!flush_queued) {
+		flush_queued = true;
+		call_deferred("flush_dirty_chunks");
+	}
+}
 
+void SNGrid::_remesh_chunk_task(int p_job_idx) {
+	// Every worker owns one scratch buffer, so concurrent jobs never share caches
+	static thread_local SurfaceNetsBuffer buffer;
+
+	SNRemeshJob &job = remesh_jobs[static_cast<size_t>(p_job_idx)];
+	const SNChunk &chunk = chunks[static_cast<size_t>(job.chunk_idx)];
 	Vector3i chunk_loc(chunk.loc_x, chunk.loc_y, chunk.loc_z);
 
-	SurfaceNets::MeshData data = SurfaceNets::generate_mesh(this, chunk_loc, chunk_size, mesh_buffer, cell_center, smooth_normal);
-	if (data.vertices.is_empty() || data.indices.is_empty()) {
+	job.data = SurfaceNets::generate_mesh(this, chunk_loc, chunk_size, buffer, cell_center, smooth_normal, job.lod);
+
+	const int32_t *indices = job.data.indices.ptr();
+	const Vector3 *vertices = job.data.vertices.ptr();
+	job.faces.resize(job.data.indices.size());
+	Vector3 *faces = job.faces.ptrw();
+	for (int i = 0; i < job.data.indices.size(); ++i) {
+		faces[i] = vertices[indices[i]];
+	}
+
+	// Skirts are render-only; the collider above keeps the plain surface
+	if (job.skirt_length > 0.0f) {
+		SurfaceNets::add_skirts(job.data, job.skirt_length);
+	}
+}
+
+void SNGrid::flush_dirty_chunks() {
+	flush_queued = false;
+	if (dirty_chunks.empty()) {
 		return;
 	}
 
-	// Assemble and Spawn Godot Mesh
-	Array arrays;
-	arrays.resize(Mesh::ARRAY_MAX);
-	arrays[Mesh::ARRAY_VERTEX] = data.vertices;
-	arrays[Mesh::ARRAY_NORMAL] = data.normals;
-	arrays[Mesh::ARRAY_INDEX] = data.indices;
+	uint64_t t_start = Time::get_singleton()->get_ticks_usec();
 
-	Ref<ArrayMesh> am;
-	am.instantiate();
-	am->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+	int job_count = static_cast<int>(dirty_chunks.size());
+	if (remesh_jobs.size() < dirty_chunks.size()) {
+		remesh_jobs.resize(dirty_chunks.size());
+	}
+	for (int i = 0; i < job_count; i++) {
+		SNRemeshJob &job = remesh_jobs[static_cast<size_t>(i)];
+		job.chunk_idx = dirty_chunks[static_cast<size_t>(i)];
+		job.lod = chunks[static_cast<size_t>(job.chunk_idx)].lod;
+		job.skirt_length = _get_skirt_length(job.chunk_idx);
+	}
 
-	MeshInstance3D *mi = memnew(MeshInstance3D);
-	mi->set_mesh(am);
-	if (terrain_material.is_valid()) {
-		mi->set_material_override(terrain_material);
+	// Densities are only written on the main thread, which waits here, so workers read them safely
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && job_count > 1) {
+		int64_t group_id = pool->add_group_task(Callable(this, "_remesh_chunk_task"), job_count, -1, true, "SNGrid Remesh");
+		pool->wait_for_group_task_completion(group_id);
+	} else {
+		for (int i = 0; i < job_count; i++) {
+			_remesh_chunk_task(i);
+		}
 	}
-	add_child(mi);
-	if (is_inside_tree()) {
-		mi->set_owner(get_owner() ? get_owner() : this);
+
+	for (int i = 0; i < job_count; i++) {
+		SNRemeshJob &job = remesh_jobs[static_cast<size_t>(i)];
+		SNChunk &chunk = chunks[static_cast<size_t>(job.chunk_idx)];
+		_apply_chunk_mesh(chunk, job);
+		chunk.mesh_dirty = false;
+
+		// Drop the mesh arrays but keep the slot for the next flush
+		job.data = SurfaceNets::MeshData();
+		job.faces = PackedVector3Array();
 	}
-	chunk.visual_node = mi;
+	dirty_chunks.clear();
 
-	// Generate Concave Collision Shape
-	StaticBody3D *sb = memnew(StaticBody3D);
-	CollisionShape3D *cs = memnew(CollisionShape3D);
-	Ref<ConcavePolygonShape3D> shape;
-	shape.instantiate();
+	last_remesh_usec = Time::get_singleton()->get_ticks_usec() - t_start;
+}
 
-	PackedVector3Array faces;
-	faces.resize(data.indices.size());
-	for (int i = 0; i < data.indices.size(); ++i) {
-		faces[i] = data.vertices[data.indices[i]];
+void SNGrid::_apply_chunk_mesh(SNChunk &p_chunk, const SNRemeshJob &p_job) {
+	if (p_job.data.vertices.is_empty() || p_job.data.indices.is_empty()) {
+		_clear_chunk_visuals(p_chunk);
+		return;
 	}
-	shape->set_faces(faces);
-	cs->set_shape(shape);
-	sb->add_child(cs);
 
-	sb->set_collision_layer(16); // Terrain layer
-	sb->set_collision_mask(0);
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = p_job.data.vertices;
+	arrays[Mesh::ARRAY_NORMAL] = p_job.data.normals;
+	arrays[Mesh::ARRAY_INDEX] = p_job.data.indices;
 
-	add_child(sb);
-	if (is_inside_tree()) {
-		sb->set_owner(get_owner() ? get_owner() : this);
-		cs->set_owner(get_owner() ? get_owner() : this);
+	// Replace the surface in place so the RenderingServer keeps the same mesh RID
+	if (p_chunk.mesh.is_null()) {
+		p_chunk.mesh.instantiate();
+	} else {
+		p_chunk.mesh->clear_surfaces();
+	}
+	p_chunk.mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+
+	if (!p_chunk.visual_node) {
+		MeshInstance3D *mi = memnew(MeshInstance3D);
+		mi->set_mesh(p_chunk.mesh);
+		add_child(mi);
+		if (is_inside_tree()) {
+			mi->set_owner(get_owner() ? get_owner() : this);
+		}
+		p_chunk.visual_node = mi;
+	}
+	if (terrain_material.is_valid()) {
+		p_chunk.visual_node->set_material_override(terrain_material);
+	}
+
+	if (p_chunk.collision_shape.is_null()) {
+		p_chunk.collision_shape.instantiate();
+	}
+	p_chunk.collision_shape->set_faces(p_job.faces);
+
+	if (!p_chunk.collision_body) {
+		StaticBody3D *sb = memnew(StaticBody3D);
+		CollisionShape3D *cs = memnew(CollisionShape3D);
+		cs->set_shape(p_chunk.collision_shape);
+		sb->add_child(cs);
+
+		sb->set_collision_layer(16); // Terrain layer
+		sb->set_collision_mask(0);
+
+		add_child(sb);
+		if (is_inside_tree()) {
+			sb->set_owner(get_owner() ? get_owner() : this);
+			cs->set_owner(get_owner() ? get_owner() : this);
+		}
+		p_chunk.collision_body = sb;
 	}
-	chunk.collision_body = sb;
 }
 
 void SNGrid::modify_density(const Vector3i &p_grid_pos, int8_t p_density) {
@@ -283,18 +374,22 @@ void SNGrid::modify_density(const Vector3i &p_grid_pos, int8_t p_density) {
 			for (int cx = start_cx; cx <= end_cx; cx++) {
 				int idx = _get_chunk_index(cx, cy, cz);
 				SNChunk &chunk = chunks[static_cast<size_t>(idx)];
+				if (!chunk.is_resident()) {
+					_load_chunk(idx);
+				}
 				chunk.set_corner(gx - (cx * chunk_size.x), gy - (cy * chunk_size.y), gz - (cz * chunk_size.z), p_density);
+				chunk.save_dirty = true;
 				actual_modified = true;
 			}
 		}
 	}
 
+	// Meshes are rebuilt once per frame in flush_dirty_chunks, however many corners a brush touches
 	if (actual_modified) {
 		for (int cy = start_cy; cy <= end_cy; cy++) {
 			for (int cz = start_cz; cz <= end_cz; cz++) {
 				for (int cx = start_cx; cx <= end_cx; cx++) {
-					int idx = _get_chunk_index(cx, cy, cz);
-					_update_chunk_mesh(idx);
+					_mark_chunk_dirty(_get_chunk_index(cx, cy, cz));
 				}
 			}
 		}
@@ -302,6 +397,12 @@ void SNGrid::modify_density(const Vector3i &p_grid_pos, int8_t p_density) {
 }
 
 int8_t SNGrid::get_density(const Vector3i &p_grid_pos) const {
+	// Integer division truncates toward zero, so negative corners must be rejected before the chunk lookup
+	if (p_grid_pos.x < 0 || p_grid_pos.y < 0 || p_grid_pos.z < 0 ||
+			p_grid_pos.x > grid_size.x * chunk_size.x || p_grid_pos.y > grid_size.y * chunk_size.y || p_grid_pos.z > grid_size.z * chunk_size.z) {
+		return 127; // Outside the grid boundaries is considered air
+	}
+
 	int cx = (p_grid_pos.x >= grid_size.x * chunk_size.x) ? grid_size.x - 1 : p_grid_pos.x / chunk_size.x;
 	int cy = (p_grid_pos.y >= grid_size.y * chunk_size.y) ? grid_size.y - 1 : p_grid_pos.y / chunk_size.y;
 	int cz = (p_grid_pos.z >= grid_size.z * chunk_size.z) ? grid_size.z - 1 : p_grid_pos.z / chunk_size.z;
@@ -311,9 +412,83 @@ int8_t SNGrid::get_density(const Vector3i &p_grid_pos) const {
 	}
 
 	int idx = _get_chunk_index(cx, cy, cz);
+	if (!chunks[static_cast<size_t>(idx)].is_resident()) {
+		return 127; // Streamed-out chunks read as air
+	}
 	return chunks[static_cast<size_t>(idx)].get_corner(p_grid_pos.x - (cx * chunk_size.x), p_grid_pos.y - (cy * chunk_size.y), p_grid_pos.z - (cz * chunk_size.z));
 }
 
+void SNGrid::copy_density_block(const Vector3i &p_origin, const Vector3i &p_size, int8_t *r_block, int p_step) const {
+	if (p_step > 1) {
+		// Decimated LOD blocks are a fraction of the size; gather them corner by corner
+		int8_t *out = r_block;
+		for (int z = 0; z < p_size.z; z++) {
+			for (int y = 0; y < p_size.y; y++) {
+				for (int x = 0; x < p_size.x; x++) {
+					*out++ = get_density(p_origin + Vector3i(x, y, z) * p_step);
+				}
+			}
+		}
+		return;
+	}
+
+	memset(r_block, 127, static_cast<size_t>(p_size.x) * p_size.y * p_size.z);
+
+	// Clip the box to the grid's corners; everything outside stays air
+	Vector3i lo(MAX(p_origin.x, 0), MAX(p_origin.y, 0), MAX(p_origin.z, 0));
+	Vector3i hi(
+			MIN(p_origin.x + p_size.x, grid_size.x * chunk_size.x + 1),
+			MIN(p_origin.y + p_size.y, grid_size.y * chunk_size.y + 1),
+			MIN(p_origin.z + p_size.z, grid_size.z * chunk_size.z + 1));
+	if (lo.x >= hi.x || lo.y >= hi.y || lo.z >= hi.z || chunks.empty()) {
+		return;
+	}
+
+	// Shared corners are read from the chunk get_density picks: the one where they are local 0, except on the far edge
+	auto chunk_span = [](int p_chunk, int p_lo, int p_hi, int p_chunk_size, int p_chunks, int &r_from, int &r_to) {
+		r_from = MAX(p_lo, p_chunk * p_chunk_size);
+		r_to = (p_chunk == p_chunks - 1) ? p_hi : MIN(p_hi, (p_chunk + 1) * p_chunk_size);
+	};
+
+	int nx = chunk_size.x + 1;
+	int nz = chunk_size.z + 1;
+	size_t block_y_stride = static_cast<size_t>(p_size.x);
+	size_t block_z_stride = static_cast<size_t>(p_size.x) * p_size.y;
+
+	for (int cy = MIN(lo.y / chunk_size.y, grid_size.y - 1); cy <= MIN((hi.y - 1) / chunk_size.y, grid_size.y - 1); cy++) {
+		int y0, y1;
+		chunk_span(cy, lo.y, hi.y, chunk_size.y, grid_size.y, y0, y1);
+		for (int cz = MIN(lo.z / chunk_size.z, grid_size.z - 1); cz <= MIN((hi.z - 1) / chunk_size.z, grid_size.z - 1); cz++) {
+			int z0, z1;
+			chunk_span(cz, lo.z, hi.z, chunk_size.z, grid_size.z, z0, z1);
+			for (int cx = MIN(lo.x / chunk_size.x, grid_size.x - 1); cx <= MIN((hi.x - 1) / chunk_size.x, grid_size.x - 1); cx++) {
+				int x0, x1;
+				chunk_span(cx, lo.x, hi.x, chunk_size.x, grid_size.x, x0, x1);
+				if (x0 >= x1) {
+					continue;
+				}
+
+				const SNChunk &chunk = chunks[static_cast<size_t>(_get_chunk_index(cx, cy, cz))];
+				if (!chunk.is_resident()) {
+					continue;
+				}
+				const int8_t *src = chunk.corner_densities.data();
+				int base_x = cx * chunk_size.x;
+				int base_y = cy * chunk_size.y;
+				int base_z = cz * chunk_size.z;
+
+				for (int gy = y0; gy < y1; gy++) {
+					for (int gz = z0; gz < z1; gz++) {
+						size_t src_idx = (static_cast<size_t>(gy - base_y) * nz + (gz - base_z)) * nx + (x0 - base_x);
+						size_t dst_idx = (gy - p_origin.y) * block_y_stride + (gz - p_origin.z) * block_z_stride + (x0 - p_origin.x);
+						memcpy(r_block + dst_idx, src + src_idx, static_cast<size_t>(x1 - x0));
+					}
+				}
+			}
+		}
+	}
+}
+
 bool SNGrid::is_solid(const Vector3i &p_grid_pos) const {
 	return get_density(p_grid_pos) < 0; // Negative values are inside/solid
 }
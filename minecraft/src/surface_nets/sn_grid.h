@@ -3,9 +3,13 @@
 
 #include "godot_cpp/classes/standard_material3d.hpp"
 #include "surface_nets/surface_nets.h"
+#include "utils/encoding/region_file.h"
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/concave_polygon_shape3d.hpp>
 #include <godot_cpp/classes/node3d.hpp>
 #include <godot_cpp/classes/noise.hpp>
 #include <godot_cpp/classes/ref.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/vector3i.hpp>
 
@@ -24,9 +28,15 @@ struct SNChunk {
 	int loc_y = 0;
 	int loc_z = 0;
 	std::vector<int8_t> corner_densities; // 8-bit signed density/SDF values (-128 to 127)
+	PackedByteArray packed_densities; // serialize_quantized() copy held while the chunk is compressed in memory
 
 	MeshInstance3D *visual_node = nullptr;
 	StaticBody3D *collision_body = nullptr;
+	Ref<ArrayMesh> mesh; // Reused across remeshes, surfaces are replaced in place
+	Ref<ConcavePolygonShape3D> collision_shape; // Reused across remeshes, faces are replaced in place
+	bool mesh_dirty = false; // Already listed in SNGrid::dirty_chunks for the next flush
+	bool save_dirty = true; // Densities differ from the region file; set by edits, cleared once the chunk is written
+	int lod = 0; // Detail level the chunk is meshed at; each level doubles the voxels per cell
 
 	int8_t get_corner(int x, int y, int z) const {
 		int nx = size_x + 1;
@@ -42,12 +52,37 @@ struct SNChunk {
 		corner_densities[index] = value;
 	}
 
+	// Streamed-out and memory-compressed chunks drop their densities and read as air until paged back in.
+	bool is_resident() const {
+		return !corner_densities.empty();
+	}
+
 	bool is_corner_active(int x, int y, int z) const {
 		return get_corner(x, y, z) < 0; // Negative values are inside/solid
 	}
 
 	PackedByteArray serialize_rle() const;
 	void deserialize_rle(const PackedByteArray &p_data);
+
+	/*
+	 * Compact codec for terrain densities. Uniform chunks take 3 bytes; otherwise a
+	 * bit-RLE "shell" map marks the corners that aren't saturated at 127/-128, a second
+	 * bit-RLE map tells solid from air among the saturated ones, and shell values follow
+	 * as zigzag varint deltas in corner order. Lossless.
+	 * Output starts with a 0 byte, which serialize_rle never produces.
+	 */
+	PackedByteArray serialize_quantized() const;
+	// Decodes either serialize_quantized or legacy serialize_rle data.
+	void deserialize(const PackedByteArray &p_data);
+};
+
+// One chunk remesh, produced on a worker thread and applied on the main thread.
+struct SNRemeshJob {
+	int chunk_idx = -1; // Chunk being remeshed
+	int lod = 0; // Detail level to mesh at
+	float skirt_length = 0.0f; // Seam skirt depth, 0 when every neighbour shares the chunk's LOD
+	SurfaceNets::MeshData data; // Render mesh arrays
+	PackedVector3Array faces; // Triangle soup for the concave collider
 };
 
 class SNGrid : public Node3D {
@@ -59,11 +94,22 @@ private:
 	std::vector<SNChunk> chunks;
 	Ref<Material> terrain_material;
 	Ref<Noise> terrain_noise;
-	SurfaceNetsBuffer mesh_buffer;
+	std::vector<int> dirty_chunks; // Chunks edited since the last flush, each listed once
+	std::vector<SNRemeshJob> remesh_jobs; // Per-flush job slots, reused across frames
+	bool flush_queued = false; // A deferred flush_dirty_chunks call is pending
+	uint64_t last_remesh_usec = 0; // Wall time of the last flush, meshing plus scene updates
 
 	bool cell_center = false;
 	bool smooth_normal = true;
 
+	int max_lod = 3; // Coarsest detail level, 3 = every 8th corner
+	float lod_distance = 64.0f; // Camera distance where LOD 1 starts; each further level starts at twice the distance
+	Vector3 lod_camera_pos; // Grid-local camera position the current LODs were chosen for
+	bool lod_camera_valid = false; // lod_camera_pos holds a real sample
+
+	RegionFile region; // Save file chunks are paged from, kept open for write-back and incremental saves
+	float stream_radius = 0.0f; // Chunks within this camera distance stay resident; 0 keeps every chunk resident
+
 	int _get_chunk_index(int x, int y, int z) const {
 		return (y * grid_size.x * grid_size.z) + (z * grid_size.x) + x;
 	}
@@ -71,9 +117,28 @@ private:
 	bool _is_boundary_corner(int gx, int gy, int gz, int8_t &r_required_density) const;
 	void _initialize_boundaries(SNChunk &p_chunk) const;
 
-	void _update_chunk_mesh(int p_chunk_idx);
+	// Queues a chunk for the end-of-frame remesh; repeated edits to the same chunk coalesce.
+	void _mark_chunk_dirty(int p_chunk_idx);
+	// Worker entry point: meshes remesh_jobs[p_job_idx] with this thread's SurfaceNetsBuffer.
+	void _remesh_chunk_task(int p_job_idx);
+	// Uploads a finished job into the chunk's mesh and collider, creating nodes only on first use.
+	void _apply_chunk_mesh(SNChunk &p_chunk, const SNRemeshJob &p_job);
 	void _clear_chunk_visuals(SNChunk &p_chunk);
 
+	// Pages a chunk in from its in-memory copy or the region file, or fills it with the default boundaries.
+	void _load_chunk(int p_chunk_idx);
+	// Writes a chunk back to the region file if it changed (or compresses it in memory without one), then frees its densities and visuals.
+	void _unload_chunk(int p_chunk_idx);
+	// Loads every streamed-out chunk and detaches the region file, before the whole grid is regenerated.
+	void _stop_streaming();
+	// Pages chunks in and out around the grid-local camera position.
+	void _update_streaming(const Vector3 &p_camera_pos);
+
+	// Coarsest level allowed by max_lod whose step divides every chunk axis.
+	int _get_max_chunk_lod() const;
+	// Seam skirt depth for a chunk: the coarsest cell size around it, or 0 when all 26 neighbours share its LOD.
+	float _get_skirt_length(int p_chunk_idx) const;
+
 protected:
 	static void _bind_methods();
 
@@ -82,12 +147,26 @@ public:
 	~SNGrid() override;
 
 	void _ready() override;
+	void _process(double p_delta) override;
 
 	void initialize_grid(int p_chunks_x, int p_chunks_y, int p_chunks_z, int p_chunk_size_x, int p_chunk_size_y, int p_chunk_size_z, bool p_refresh = true);
 	void refresh_grid();
 
+	// Remeshes every dirty chunk in parallel and applies the results. Runs deferred once per frame after edits.
+	void flush_dirty_chunks();
+	int get_last_remesh_usec() const {
+		return static_cast<int>(last_remesh_usec);
+	}
+
 	void modify_density(const Vector3i &p_grid_pos, int8_t p_density);
 	int8_t get_density(const Vector3i &p_grid_pos) const;
+	/*
+	 * Copies p_size corner densities starting at p_origin into r_block, x fastest, then y,
+	 * then z, taking every p_step-th corner along each axis. At step 1 each run of corners
+	 * owned by one chunk is a single row copy; corners outside the grid read as air,
+	 * matching get_density.
+	 */
+	void copy_density_block(const Vector3i &p_origin, const Vector3i &p_size, int8_t *r_block, int p_step = 1) const;
 	bool is_solid(const Vector3i &p_grid_pos) const;
 
 	void save_grid(const String &p_path);
@@ -109,6 +188,24 @@ public:
 	void set_terrain_noise(const Ref<Noise> &p_noise);
 	Ref<Noise> get_terrain_noise() const;
 
+	/*
+	 * Picks a detail level for every chunk from its distance to p_camera_pos (grid-local),
+	 * and queues chunks whose level changed, together with their neighbours' skirts, for remeshing.
+	 * Called from _process whenever the camera has moved a quarter of lod_distance.
+	 */
+	void update_lods(const Vector3 &p_camera_pos);
+	int get_chunk_lod(int p_chunk_idx) const;
+
+	void set_stream_radius(float p_radius);
+	float get_stream_radius() const { return stream_radius; }
+	int get_resident_chunk_count() const;
+
+	void set_max_lod(int p_lod);
+	int get_max_lod() const { return max_lod; }
+
+	void set_lod_distance(float p_distance);
+	float get_lod_distance() const { return lod_distance; }
+
 	void set_cell_center(bool p_enabled);
 	bool is_cell_center() const { return cell_center; }
 
@@ -117,6 +214,12 @@ public:
 
 	void generate_test_sdf();
 	void generate_noise_sdf();
+
+	// Encodes every resident chunk with serialize_rle and serialize_quantized and reports bytes and timings for both.
+	Dictionary benchmark_chunk_codec(int p_iterations);
+
+	// Meshes every chunk with the reference and fast surface nets paths and reports cells/sec for both.
+	Dictionary benchmark_surface_nets(int p_iterations);
 };
 
 } // namespace godot
@@ -0,0 +1,141 @@
+#include "surface_nets/sn_grid.h"
+
+#include "godot_cpp/classes/camera3d.hpp"
+#include "godot_cpp/classes/engine.hpp"
+#include "godot_cpp/classes/viewport.hpp"
+
+namespace godot {
+
+void SNGrid::_process(double p_delta) {
+	if (Engine::get_singleton()->is_editor_hint() || chunks.empty()) {
+		return;
+	}
+
+	Viewport *viewport = get_viewport();
+	Camera3D *camera = viewport ? viewport->get_camera_3d() : nullptr;
+	if (!camera) {
+		return;
+	}
+
+	// LOD bands are lod_distance wide at minimum, so small camera moves can't change any chunk's level much
+	Vector3 camera_pos = to_local(camera->get_global_position());
+	if (lod_camera_valid && camera_pos.distance_to(lod_camera_pos) < lod_distance * 0.25f) {
+		return;
+	}
+	update_lods(camera_pos);
+	_update_streaming(camera_pos);
+}
+
+int SNGrid::_get_max_chunk_lod() const {
+	int lod = max_lod;
+	while (lod > 0) {
+		int step = 1 << lod;
+		if (chunk_size.x % step == 0 && chunk_size.y % step == 0 && chunk_size.z % step == 0) {
+			break;
+		}
+		lod--;
+	}
+	return lod;
+}
+
+float SNGrid::_get_skirt_length(int p_chunk_idx) const {
+	const SNChunk &chunk = chunks[static_cast<size_t>(p_chunk_idx)];
+	int coarsest = chunk.lod;
+	bool mixed = false;
+
+	for (int dy = -1; dy <= 1; dy++) {
+		for (int dz = -1; dz <= 1; dz++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				int nx = chunk.loc_x + dx;
+				int ny = chunk.loc_y + dy;
+				int nz = chunk.loc_z + dz;
+				if (nx < 0 || ny < 0 || nz < 0 || nx >= grid_size.x || ny >= grid_size.y || nz >= grid_size.z) {
+					continue;
+				}
+				int neighbour_lod = chunks[static_cast<size_t>(_get_chunk_index(nx, ny, nz))].lod;
+				if (neighbour_lod != chunk.lod) {
+					mixed = true;
+					coarsest = MAX(coarsest, neighbour_lod);
+				}
+			}
+		}
+	}
+
+	// The crack between two levels is at most one coarse cell deep
+	return mixed ? static_cast<float>(1 << coarsest) : 0.0f;
+}
+
+void SNGrid::update_lods(const Vector3 &p_camera_pos) {
+	lod_camera_pos = p_camera_pos;
+	lod_camera_valid = true;
+
+	int top_lod = _get_max_chunk_lod();
+	std::vector<int> changed;
+
+	for (size_t i = 0; i < chunks.size(); i++) {
+		SNChunk &chunk = chunks[i];
+		Vector3 center(
+				(static_cast<float>(chunk.loc_x) + 0.5f) * chunk_size.x,
+				(static_cast<float>(chunk.loc_y) + 0.5f) * chunk_size.y,
+				(static_cast<float>(chunk.loc_z) + 0.5f) * chunk_size.z);
+		float dist = center.distance_to(p_camera_pos);
+
+		// LOD 0 inside lod_distance, then one level per doubling of the distance
+		int lod = 0;
+		float limit = lod_distance;
+		while (lod < top_lod && lod_distance > 0.0f && dist >= limit) {
+			lod++;
+			limit *= 2.0f;
+		}
+
+		if (lod != chunk.lod) {
+			chunk.lod = lod;
+			changed.push_back(static_cast<int>(i));
+		}
+	}
+
+	// A level change also adds or removes the skirts of every chunk around it
+	for (int idx : changed) {
+		const SNChunk &chunk = chunks[static_cast<size_t>(idx)];
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dz = -1; dz <= 1; dz++) {
+				for (int dx = -1; dx <= 1; dx++) {
+					int nx = chunk.loc_x + dx;
+					int ny = chunk.loc_y + dy;
+					int nz = chunk.loc_z + dz;
+					if (nx < 0 || ny < 0 || nz < 0 || nx >= grid_size.x || ny >= grid_size.y || nz >= grid_size.z) {
+						continue;
+					}
+					_mark_chunk_dirty(_get_chunk_index(nx, ny, nz));
+				}
+			}
+		}
+	}
+}
+
+int SNGrid::get_chunk_lod(int p_chunk_idx) const {
+	if (p_chunk_idx < 0 || p_chunk_idx >= static_cast<int>(chunks.size())) {
+		return 0;
+	}
+	return chunks[static_cast<size_t>(p_chunk_idx)].lod;
+}
+
+void SNGrid::set_max_lod(int p_lod) {
+	p_lod = CLAMP(p_lod, 0, 3);
+	if (max_lod == p_lod) {
+		return;
+	}
+	max_lod = p_lod;
+	if (lod_camera_valid) {
+		update_lods(lod_camera_pos);
+	}
+}
+
+void SNGrid::set_lod_distance(float p_distance) {
+	lod_distance = MAX(p_distance, 0.0f);
+	if (lod_camera_valid) {
+		update_lods(lod_camera_pos);
+	}
+}
+
+} //namespace godot
@@ -1,39 +1,94 @@
 #include "surface_nets/sn_grid.h"
 #include <godot_cpp/classes/file_access.hpp>
+#include "utils/encoding/rle.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SN_USE_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace godot {
 
 void SNGrid::save_grid(const String &p_path) {
-	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
-	if (f.is_null()) {
-		UtilityFunctions::print("SNGrid: Failed to open file for writing: ", p_path);
+	// Saving over the streamed file only writes resident chunks edited since their last write; the rest are already on disk
+	if (region.matches(p_path, grid_size, chunk_size)) {
+		int written = 0;
+		for (size_t i = 0; i < chunks.size(); i++) {
+			SNChunk &chunk = chunks[i];
+			if (chunk.is_resident() && chunk.save_dirty && region.write_chunk(static_cast<uint32_t>(i), chunk.serialize_quantized())) {
+				chunk.save_dirty = false;
+				written++;
+			}
+		}
+		UtilityFunctions::print("SNGrid: Saved state to ", p_path, " (", written, " of ", static_cast<int>(chunks.size()), " chunks written)");
 		return;
 	}
 
-	// 1. Header
-	f->store_32(0x534E5452); // Magic: 'SNTR'
-	f->store_32(1); // Version
-
-	// 2. Metadata
-	f->store_32(grid_size.x);
-	f->store_32(grid_size.y);
-	f->store_32(grid_size.z);
-	f->store_32(chunk_size.x);
-	f->store_32(chunk_size.y);
-	f->store_32(chunk_size.z);
+	RegionFile target;
+	if (!target.create(p_path, 0x534E5452, grid_size, chunk_size, static_cast<uint32_t>(chunks.size()))) {
+		UtilityFunctions::print("SNGrid: Failed to open file for writing: ", p_path);
+		return;
+	}
 
-	// 3. Chunk Data
-	f->store_32(static_cast<uint32_t>(chunks.size()));
-	for (const SNChunk &chunk : chunks) {
-		PackedByteArray rle_data = chunk.serialize_rle();
-		f->store_32(static_cast<uint32_t>(rle_data.size()));
-		f->store_buffer(rle_data);
+	// Streamed-out chunks are copied across from memory or from the file they were paged out to
+	for (size_t i = 0; i < chunks.size(); i++) {
+		uint32_t idx = static_cast<uint32_t>(i);
+		SNChunk &chunk = chunks[i];
+		if (chunk.is_resident()) {
+			target.write_chunk(idx, chunk.serialize_quantized());
+		} else {
+			target.write_chunk(idx, chunk.packed_densities.is_empty() ? region.read_chunk(idx) : chunk.packed_densities);
+		}
+		chunk.save_dirty = false;
 	}
+	region = std::move(target);
 
 	UtilityFunctions::print("SNGrid: Saved state to ", p_path);
 }
 
 void SNGrid::load_grid(const String &p_path) {
+	if (RegionFile::is_region_file(p_path)) {
+		RegionFile file;
+		if (!file.open(p_path, 0x534E5452)) {
+			UtilityFunctions::print("SNGrid: Invalid region file: ", p_path);
+			return;
+		}
+
+		Vector3i gs = file.get_grid_size();
+		Vector3i cs = file.get_chunk_size();
+		initialize_grid(gs.x, gs.y, gs.z, cs.x, cs.y, cs.z, false);
+		if (file.get_chunk_count() != chunks.size()) {
+			UtilityFunctions::print("SNGrid: Chunk count mismatch in file.");
+			return;
+		}
+		region = std::move(file);
+
+		if (stream_radius > 0.0f) {
+			// Only the table has been read; _process pages in the chunks around the camera
+			for (SNChunk &chunk : chunks) {
+				chunk.corner_densities.clear();
+				chunk.corner_densities.shrink_to_fit();
+			}
+			lod_camera_valid = false;
+			UtilityFunctions::print("SNGrid: Streaming state from ", p_path);
+			return;
+		}
+
+		for (size_t i = 0; i < chunks.size(); i++) {
+			_load_chunk(static_cast<int>(i));
+		}
+		UtilityFunctions::print("SNGrid: Loaded state from ", p_path);
+		refresh_grid();
+		return;
+	}
+
+	// Legacy single-stream format ('SNTR'); the next save converts it to a region file
+	_stop_streaming();
 	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
 	if (f.is_null()) {
 		UtilityFunctions::print("SNGrid: Failed to open file for reading: ", p_path);
@@ -71,7 +126,7 @@ void SNGrid::load_grid(const String &p_path) {
 	for (uint32_t i = 0; i < num_chunks; i++) {
 		uint32_t data_size = f->get_32();
 		PackedByteArray arr = f->get_buffer(data_size);
-		chunks[i].deserialize_rle(arr);
+		chunks[i].deserialize(arr);
 	}
 
 	UtilityFunctions::print("SNGrid: Loaded state from ", p_path);
@@ -128,11 +183,404 @@ void SNChunk::deserialize_rle(const PackedByteArray &p_data) {
 	}
 }
 
+// --- Quantized density codec ---
+
+namespace {
+
+// Appends p_value as a little-endian 32-bit value.
+void write_u32(PackedByteArray &r_out, uint32_t p_value) {
+	for (int i = 0; i < 4; i++) {
+		r_out.push_back(static_cast<uint8_t>(p_value >> (i * 8)));
+	}
+}
+
+bool read_u32(const uint8_t *p_data, int64_t p_size, int64_t &r_pos, uint32_t &r_value) {
+	if (r_pos + 4 > p_size) {
+		return false;
+	}
+	r_value = 0;
+	for (int i = 0; i < 4; i++) {
+		r_value |= static_cast<uint32_t>(p_data[r_pos++]) << (i * 8);
+	}
+	return true;
+}
+
+inline int lowest_bit(uint64_t p_bits) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, p_bits);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(p_bits);
+#endif
+}
+
+inline int count_bits(uint64_t p_bits) {
+#if defined(_MSC_VER)
+	return static_cast<int>(__popcnt64(p_bits));
+#else
+	return __builtin_popcountll(p_bits);
+#endif
+}
+
+// Sets bit k of r_shell for densities strictly inside (-128, 127) and bit k of r_solid for negative ones.
+inline void classify_block(const int8_t *p_block, size_t p_count, uint64_t &r_shell, uint64_t &r_solid) {
+	uint64_t saturated = 0;
+	uint64_t solid = 0;
+	size_t k = 0;
+#ifdef SN_USE_SSE2
+	const __m128i max_value = _mm_set1_epi8(127);
+	const __m128i min_value = _mm_set1_epi8(-128);
+	for (; k + 16 <= p_count; k += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_block + k));
+		__m128i sat = _mm_or_si128(_mm_cmpeq_epi8(v, max_value), _mm_cmpeq_epi8(v, min_value));
+		saturated |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(sat))) << k;
+		solid |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(v))) << k;
+	}
+#endif
+	for (; k < p_count; k++) {
+		saturated |= static_cast<uint64_t>(p_block[k] == 127 || p_block[k] == -128) << k;
+		solid |= static_cast<uint64_t>(p_block[k] < 0) << k;
+	}
+	uint64_t valid = p_count == 64 ? ~0ULL : (1ULL << p_count) - 1;
+	r_shell = ~saturated & valid;
+	r_solid = solid;
+}
+
+// Bitmaps are kept as 64-bit words; on little-endian targets that is the byte layout RLE::encode_bit_rle expects.
+void append_bits(std::vector<uint64_t> &r_words, size_t p_pos, uint64_t p_bits, size_t p_count) {
+	size_t shift = p_pos & 63;
+	r_words[p_pos >> 6] |= p_bits << shift;
+	if (shift != 0 && shift + p_count > 64) {
+		r_words[(p_pos >> 6) + 1] |= p_bits >> (64 - shift);
+	}
+}
+
+uint64_t read_bits(const std::vector<uint64_t> &p_words, size_t p_pos) {
+	size_t shift = p_pos & 63;
+	uint64_t bits = p_words[p_pos >> 6] >> shift;
+	if (shift != 0) {
+		bits |= p_words[(p_pos >> 6) + 1] << (64 - shift);
+	}
+	return bits;
+}
+
+} // namespace
+
+PackedByteArray SNChunk::serialize_quantized() const {
+	PackedByteArray output;
+	output.push_back(0); // Marks the quantized format; serialize_rle never starts with a zero run
+	if (corner_densities.empty()) {
+		output.push_back(0);
+		output.push_back(static_cast<uint8_t>(127));
+		return output;
+	}
+
+	size_t n = corner_densities.size();
+	const int8_t *d = corner_densities.data();
+
+	// Mode 0: uniform chunk, stored as its single value
+	bool uniform = true;
+	for (size_t i = 1; i < n && uniform; i++) {
+		uniform = d[i] == d[0];
+	}
+	if (uniform) {
+		output.push_back(0);
+		output.push_back(static_cast<uint8_t>(d[0]));
+		return output;
+	}
+
+	// Mode 1: shell map, solid map over the saturated corners, then shell deltas
+	size_t words = (n + 63) / 64;
+	std::vector<uint64_t> shell_bits(words, 0);
+	std::vector<uint64_t> solid_bits(words + 1, 0);
+	std::vector<uint8_t> deltas(n * 2); // Worst case: every corner is shell with a two-byte delta
+	size_t delta_size = 0;
+
+	size_t saturated = 0;
+	int prev = 0;
+	for (size_t base = 0; base < n; base += 64) {
+		size_t count = MIN(n - base, static_cast<size_t>(64));
+		const int8_t *block = d + base;
+
+		uint64_t shell;
+		uint64_t solid;
+		classify_block(block, count, shell, solid);
+		shell_bits[base >> 6] = shell;
+
+		// Most words lie wholly inside solid ground or air and skip straight to the solid map
+		if (shell == 0) {
+			append_bits(solid_bits, saturated, solid, count);
+			saturated += count;
+			continue;
+		}
+
+		// Gather the solid bits of the saturated corners, then walk only the shell corners
+		uint64_t saturated_mask = ~shell & (count == 64 ? ~0ULL : (1ULL << count) - 1);
+		uint64_t packed = 0;
+		int packed_count = 0;
+		for (uint64_t m = saturated_mask; m != 0; m &= m - 1) {
+			packed |= ((solid >> lowest_bit(m)) & 1) << packed_count++;
+		}
+		append_bits(solid_bits, saturated, packed, static_cast<size_t>(packed_count));
+		saturated += static_cast<size_t>(packed_count);
+
+		for (uint64_t m = shell; m != 0; m &= m - 1) {
+			int8_t v = block[lowest_bit(m)];
+			int delta = v - prev;
+			prev = v;
+
+			// Zigzag keeps small negative steps small; deltas fit in 9 bits, so at most two varint bytes
+			uint32_t zigzag = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+			if (zigzag < 0x80) {
+				deltas[delta_size++] = static_cast<uint8_t>(zigzag);
+			} else {
+				deltas[delta_size++] = static_cast<uint8_t>(0x80 | (zigzag & 0x7F));
+				deltas[delta_size++] = static_cast<uint8_t>(zigzag >> 7);
+			}
+		}
+	}
+
+	PackedByteArray shell_rle = RLE::encode_bit_rle(reinterpret_cast<const uint8_t *>(shell_bits.data()), static_cast<int>(n));
+	PackedByteArray solid_rle = RLE::encode_bit_rle(reinterpret_cast<const uint8_t *>(solid_bits.data()), static_cast<int>(saturated));
+
+	output.push_back(1);
+	write_u32(output, static_cast<uint32_t>(shell_rle.size()));
+	output.append_array(shell_rle);
+	write_u32(output, static_cast<uint32_t>(solid_rle.size()));
+	output.append_array(solid_rle);
+
+	int64_t base = output.size();
+	output.resize(base + static_cast<int64_t>(delta_size));
+	if (delta_size > 0) {
+		memcpy(output.ptrw() + base, deltas.data(), delta_size);
+	}
+	return output;
+}
+
+void SNChunk::deserialize(const PackedByteArray &p_data) {
+	if (p_data.is_empty() || p_data[0] != 0) {
+		deserialize_rle(p_data);
+		return;
+	}
+
+	size_t n = static_cast<size_t>((size_x + 1) * (size_y + 1) * (size_z + 1));
+	corner_densities.assign(n, 127); // Default to empty air (127)
+
+	const uint8_t *data = p_data.ptr();
+	int64_t size = p_data.size();
+	if (size < 3) {
+		return;
+	}
+
+	if (data[1] == 0) {
+		std::fill(corner_densities.begin(), corner_densities.end(), static_cast<int8_t>(data[2]));
+		return;
+	}
+
+	int64_t pos = 2;
+	uint32_t shell_size = 0;
+	if (!read_u32(data, size, pos, shell_size) || pos + shell_size > size) {
+		return;
+	}
+	PackedByteArray shell_rle = p_data.slice(pos, pos + shell_size);
+	pos += shell_size;
+
+	uint32_t solid_size = 0;
+	if (!read_u32(data, size, pos, solid_size) || pos + solid_size > size) {
+		return;
+	}
+	PackedByteArray solid_rle = p_data.slice(pos, pos + solid_size);
+	pos += solid_size;
+
+	size_t words = (n + 63) / 64;
+	std::vector<uint64_t> shell_bits(words, 0);
+	RLE::decode_bit_rle(shell_rle, static_cast<int>(n), reinterpret_cast<uint8_t *>(shell_bits.data()));
+
+	size_t shell_count = 0;
+	for (uint64_t word : shell_bits) {
+		shell_count += static_cast<size_t>(count_bits(word));
+	}
+	std::vector<uint64_t> solid_bits(words + 1, 0);
+	RLE::decode_bit_rle(solid_rle, static_cast<int>(n - shell_count), reinterpret_cast<uint8_t *>(solid_bits.data()));
+
+	int8_t *d = corner_densities.data();
+	size_t sat_index = 0;
+	int prev = 0;
+	for (size_t base = 0; base < n; base += 64) {
+		size_t count = MIN(n - base, static_cast<size_t>(64));
+		uint64_t shell = shell_bits[base >> 6];
+		int8_t *block = d + base;
+
+		if (shell == 0) {
+			uint64_t solid = read_bits(solid_bits, sat_index);
+			uint64_t valid = count == 64 ? ~0ULL : (1ULL << count) - 1;
+			sat_index += count;
+			if ((solid & valid) == 0 || (solid & valid) == valid) {
+				memset(block, (solid & 1) ? -128 : 127, count);
+				continue;
+			}
+			for (size_t k = 0; k < count; k++) {
+				// 127 ^ 0xFF == -128
+				block[k] = static_cast<int8_t>(127 ^ (0xFF & -static_cast<int>((solid >> k) & 1)));
+			}
+			continue;
+		}
+
+		uint64_t solid = read_bits(solid_bits, sat_index);
+		for (size_t k = 0; k < count; k++) {
+			if (!((shell >> k) & 1)) {
+				block[k] = (solid & 1) ? -128 : 127;
+				solid >>= 1;
+				sat_index++;
+				continue;
+			}
+
+			if (pos >= size) {
+				return; // Truncated: remaining corners stay air
+			}
+			uint32_t zigzag = data[pos++];
+			if (zigzag & 0x80) {
+				if (pos >= size) {
+					return;
+				}
+				zigzag = (zigzag & 0x7F) | (static_cast<uint32_t>(data[pos++]) << 7);
+			}
+			int delta = static_cast<int>(zigzag >> 1) ^ -static_cast<int>(zigzag & 1);
+			prev += delta;
+			block[k] = static_cast<int8_t>(prev);
+		}
+	}
+}
+
+// --- Streaming ---
+
+void SNGrid::_load_chunk(int p_chunk_idx) {
+	SNChunk &chunk = chunks[static_cast<size_t>(p_chunk_idx)];
+	uint32_t idx = static_cast<uint32_t>(p_chunk_idx);
+	if (!chunk.packed_densities.is_empty()) {
+		chunk.deserialize(chunk.packed_densities);
+		chunk.packed_densities = PackedByteArray();
+		return;
+	}
+	if (region.has_chunk(idx)) {
+		PackedByteArray payload = region.read_chunk(idx);
+		if (!payload.is_empty()) {
+			chunk.deserialize(payload);
+			chunk.save_dirty = false;
+			return;
+		}
+	}
+
+	// Never written, or failed to read back: start from the initial boundaries and write it on the next save
+	int num_corners = (chunk.size_x + 1) * (chunk.size_y + 1) * (chunk.size_z + 1);
+	chunk.corner_densities.assign(static_cast<size_t>(num_corners), 127);
+	_initialize_boundaries(chunk);
+	chunk.save_dirty = true;
+}
+
+void SNGrid::_unload_chunk(int p_chunk_idx) {
+	SNChunk &chunk = chunks[static_cast<size_t>(p_chunk_idx)];
+	if (region.is_open()) {
+		// Clean chunks are already in the file, so only edited ones are written back
+		if (chunk.save_dirty && region.write_chunk(static_cast<uint32_t>(p_chunk_idx), chunk.serialize_quantized())) {
+			chunk.save_dirty = false;
+		}
+	} else {
+		chunk.packed_densities = chunk.serialize_quantized();
+	}
+	_clear_chunk_visuals(chunk);
+	chunk.corner_densities.clear();
+	chunk.corner_densities.shrink_to_fit();
+}
+
+void SNGrid::_stop_streaming() {
+	for (size_t i = 0; i < chunks.size(); i++) {
+		if (!chunks[i].is_resident()) {
+			_load_chunk(static_cast<int>(i));
+		}
+	}
+	region.close();
+}
+
+void SNGrid::_update_streaming(const Vector3 &p_camera_pos) {
+	// Without a region file, far chunks are kept compressed in memory instead
+	if (stream_radius <= 0.0f) {
+		return;
+	}
+
+	// Chunks unload a little further out than they load so ones on the edge don't thrash
+	float unload_radius = stream_radius * 1.25f;
+	std::vector<int> loaded;
+
+	for (size_t i = 0; i < chunks.size(); i++) {
+		const SNChunk &chunk = chunks[i];
+		Vector3 center(
+				(static_cast<float>(chunk.loc_x) + 0.5f) * chunk_size.x,
+				(static_cast<float>(chunk.loc_y) + 0.5f) * chunk_size.y,
+				(static_cast<float>(chunk.loc_z) + 0.5f) * chunk_size.z);
+		float dist = center.distance_to(p_camera_pos);
+
+		if (!chunk.is_resident() && dist <= stream_radius) {
+			_load_chunk(static_cast<int>(i));
+			loaded.push_back(static_cast<int>(i));
+		} else if (chunk.is_resident() && dist > unload_radius) {
+			_unload_chunk(static_cast<int>(i));
+		}
+	}
+
+	// Resident neighbours meshed their apron against air, so they need a remesh too
+	for (int idx : loaded) {
+		const SNChunk &chunk = chunks[static_cast<size_t>(idx)];
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dz = -1; dz <= 1; dz++) {
+				for (int dx = -1; dx <= 1; dx++) {
+					int nx = chunk.loc_x + dx;
+					int ny = chunk.loc_y + dy;
+					int nz = chunk.loc_z + dz;
+					if (nx < 0 || ny < 0 || nz < 0 || nx >= grid_size.x || ny >= grid_size.y || nz >= grid_size.z) {
+						continue;
+					}
+					_mark_chunk_dirty(_get_chunk_index(nx, ny, nz));
+				}
+			}
+		}
+	}
+}
+
+void SNGrid::set_stream_radius(float p_radius) {
+	stream_radius = MAX(p_radius, 0.0f);
+	if (stream_radius == 0.0f) {
+		// Streaming off: bring the whole file back in and keep it resident
+		for (size_t i = 0; i < chunks.size(); i++) {
+			if (!chunks[i].is_resident()) {
+				_load_chunk(static_cast<int>(i));
+				_mark_chunk_dirty(static_cast<int>(i));
+			}
+		}
+	} else {
+		lod_camera_valid = false;
+	}
+}
+
+int SNGrid::get_resident_chunk_count() const {
+	int count = 0;
+	for (const SNChunk &chunk : chunks) {
+		if (chunk.is_resident()) {
+			count++;
+		}
+	}
+	return count;
+}
+
 // --- SNGrid Implementation ---
 
 void SNGrid::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("initialize_grid", "chunks_x", "chunks_y", "chunks_z", "chunk_size_x", "chunk_size_y", "chunk_size_z"), &SNGrid::initialize_grid);
 	ClassDB::bind_method(D_METHOD("refresh_grid"), &SNGrid::refresh_grid);
+	ClassDB::bind_method(D_METHOD("flush_dirty_chunks"), &SNGrid::flush_dirty_chunks);
+	ClassDB::bind_method(D_METHOD("get_last_remesh_usec"), &SNGrid::get_last_remesh_usec);
+	ClassDB::bind_method(D_METHOD("_remesh_chunk_task", "job_idx"), &SNGrid::_remesh_chunk_task);
 	ClassDB::bind_method(D_METHOD("modify_density", "p_grid_pos", "p_density"), &SNGrid::modify_density);
 	ClassDB::bind_method(D_METHOD("get_density", "p_grid_pos"), &SNGrid::get_density);
 	ClassDB::bind_method(D_METHOD("is_solid", "p_grid_pos"), &SNGrid::is_solid);
@@ -161,8 +609,26 @@ void SNGrid::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_smooth_normal"), &SNGrid::is_smooth_normal);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "smooth_normal"), "set_smooth_normal", "is_smooth_normal");
 
+	ClassDB::bind_method(D_METHOD("set_stream_radius", "radius"), &SNGrid::set_stream_radius);
+	ClassDB::bind_method(D_METHOD("get_stream_radius"), &SNGrid::get_stream_radius);
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "stream_radius", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), "set_stream_radius", "get_stream_radius");
+	ClassDB::bind_method(D_METHOD("get_resident_chunk_count"), &SNGrid::get_resident_chunk_count);
+
+	ClassDB::bind_method(D_METHOD("set_max_lod", "lod"), &SNGrid::set_max_lod);
+	ClassDB::bind_method(D_METHOD("get_max_lod"), &SNGrid::get_max_lod);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_lod", PROPERTY_HINT_RANGE, "0,3,1"), "set_max_lod", "get_max_lod");
+
+	ClassDB::bind_method(D_METHOD("set_lod_distance", "distance"), &SNGrid::set_lod_distance);
+	ClassDB::bind_method(D_METHOD("get_lod_distance"), &SNGrid::get_lod_distance);
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_distance", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"), "set_lod_distance", "get_lod_distance");
+
+	ClassDB::bind_method(D_METHOD("update_lods", "camera_pos"), &SNGrid::update_lods);
+	ClassDB::bind_method(D_METHOD("get_chunk_lod", "chunk_idx"), &SNGrid::get_chunk_lod);
+
 	ClassDB::bind_method(D_METHOD("generate_test_sdf"), &SNGrid::generate_test_sdf);
 	ClassDB::bind_method(D_METHOD("generate_noise_sdf"), &SNGrid::generate_noise_sdf);
+	ClassDB::bind_method(D_METHOD("benchmark_chunk_codec", "iterations"), &SNGrid::benchmark_chunk_codec);
+	ClassDB::bind_method(D_METHOD("benchmark_surface_nets", "iterations"), &SNGrid::benchmark_surface_nets);
 
 	ClassDB::bind_method(D_METHOD("save_grid", "path"), &SNGrid::save_grid);
 	ClassDB::bind_method(D_METHOD("load_grid", "path"), &SNGrid::load_grid);
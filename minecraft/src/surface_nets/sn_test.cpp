@@ -1,9 +1,13 @@
 #include "surface_nets/sdf_helpers.h"
 #include "surface_nets/sn_grid.h"
+#include "surface_nets/surface_nets.h"
+#include <godot_cpp/classes/time.hpp>
 
 namespace godot {
 
 void SNGrid::generate_test_sdf() {
+	_stop_streaming();
+
 	int max_x = grid_size.x * chunk_size.x;
 	int max_y = grid_size.y * chunk_size.y;
 	int max_z = grid_size.z * chunk_size.z;
@@ -23,6 +27,7 @@ void SNGrid::generate_test_sdf() {
 	const float SDF_SCALE = 120.0f;
 
 	for (SNChunk &chunk : chunks) {
+		chunk.save_dirty = true;
 		int nx = chunk.size_x + 1;
 		int ny = chunk.size_y + 1;
 		int nz = chunk.size_z + 1;
@@ -70,6 +75,7 @@ void SNGrid::generate_noise_sdf() {
 	if (terrain_noise.is_null()) {
 		return;
 	}
+	_stop_streaming();
 
 	int max_x = grid_size.x * chunk_size.x;
 	int max_y = grid_size.y * chunk_size.y;
@@ -80,6 +86,7 @@ void SNGrid::generate_noise_sdf() {
 	SDFHeightmap heightmap(terrain_noise, static_cast<float>(max_y));
 
 	for (SNChunk &chunk : chunks) {
+		chunk.save_dirty = true;
 		int nx = chunk.size_x + 1;
 		int ny = chunk.size_y + 1;
 		int nz = chunk.size_z + 1;
@@ -116,4 +123,147 @@ void SNGrid::generate_noise_sdf() {
 	refresh_grid();
 }
 
+Dictionary SNGrid::benchmark_surface_nets(int p_iterations) {
+	Dictionary result;
+	if (p_iterations <= 0 || chunks.empty()) {
+		UtilityFunctions::print("SNGrid: benchmark_surface_nets needs an initialized grid and a positive iteration count");
+		return result;
+	}
+
+	SurfaceNetsBuffer buffer;
+
+	// Both paths must agree vertex for vertex before their timings mean anything
+	bool match = true;
+	for (const SNChunk &chunk : chunks) {
+		Vector3i loc(chunk.loc_x, chunk.loc_y, chunk.loc_z);
+		SurfaceNets::MeshData reference = SurfaceNets::generate_mesh_reference(this, loc, chunk_size, buffer, cell_center, smooth_normal);
+		SurfaceNets::MeshData fast = SurfaceNets::generate_mesh(this, loc, chunk_size, buffer, cell_center, smooth_normal);
+		if (reference.vertices != fast.vertices || reference.normals != fast.normals || reference.indices != fast.indices) {
+			match = false;
+		}
+	}
+
+	uint64_t t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		for (const SNChunk &chunk : chunks) {
+			SurfaceNets::generate_mesh_reference(this, Vector3i(chunk.loc_x, chunk.loc_y, chunk.loc_z), chunk_size, buffer, cell_center, smooth_normal);
+		}
+	}
+	uint64_t t_reference = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		for (const SNChunk &chunk : chunks) {
+			SurfaceNets::generate_mesh(this, Vector3i(chunk.loc_x, chunk.loc_y, chunk.loc_z), chunk_size, buffer, cell_center, smooth_normal);
+		}
+	}
+	uint64_t t_fast = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	// Each chunk visits its own cells plus the one-cell apron on every side
+	double cells_per_pass = static_cast<double>(chunks.size()) * (chunk_size.x + 2) * (chunk_size.y + 2) * (chunk_size.z + 2);
+	double cells = cells_per_pass * p_iterations;
+
+	result["cells"] = static_cast<int64_t>(cells_per_pass);
+	result["reference_usec"] = static_cast<double>(t_reference) / p_iterations;
+	result["fast_usec"] = static_cast<double>(t_fast) / p_iterations;
+	result["reference_cells_per_sec"] = t_reference > 0 ? cells * 1000000.0 / t_reference : 0.0;
+	result["fast_cells_per_sec"] = t_fast > 0 ? cells * 1000000.0 / t_fast : 0.0;
+	result["speedup"] = t_fast > 0 ? static_cast<double>(t_reference) / t_fast : 0.0;
+	result["match"] = match;
+	return result;
+}
+
+Dictionary SNGrid::benchmark_chunk_codec(int p_iterations) {
+	Dictionary result;
+	if (p_iterations <= 0 || chunks.empty()) {
+		UtilityFunctions::print("SNGrid: benchmark_chunk_codec needs an initialized grid and a positive iteration count");
+		return result;
+	}
+
+	std::vector<const SNChunk *> resident;
+	for (const SNChunk &chunk : chunks) {
+		if (chunk.is_resident()) {
+			resident.push_back(&chunk);
+		}
+	}
+	if (resident.empty()) {
+		UtilityFunctions::print("SNGrid: benchmark_chunk_codec found no resident chunks");
+		return result;
+	}
+
+	// Round-trip every chunk first; a lossy codec would make the sizes meaningless
+	int64_t raw_bytes = 0;
+	int64_t rle_bytes = 0;
+	int64_t quantized_bytes = 0;
+	int uniform_chunks = 0;
+	bool match = true;
+	std::vector<PackedByteArray> rle_data;
+	std::vector<PackedByteArray> quantized_data;
+	for (const SNChunk *chunk : resident) {
+		rle_data.push_back(chunk->serialize_rle());
+		quantized_data.push_back(chunk->serialize_quantized());
+		raw_bytes += static_cast<int64_t>(chunk->corner_densities.size());
+		rle_bytes += rle_data.back().size();
+		quantized_bytes += quantized_data.back().size();
+		if (quantized_data.back().size() <= 3) {
+			uniform_chunks++;
+		}
+
+		SNChunk copy = *chunk;
+		copy.deserialize(quantized_data.back());
+		if (copy.corner_densities != chunk->corner_densities) {
+			match = false;
+		}
+		copy.deserialize(rle_data.back());
+		if (copy.corner_densities != chunk->corner_densities) {
+			match = false;
+		}
+	}
+
+	uint64_t t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		for (const SNChunk *chunk : resident) {
+			chunk->serialize_rle();
+		}
+	}
+	uint64_t t_rle_encode = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		for (const SNChunk *chunk : resident) {
+			chunk->serialize_quantized();
+		}
+	}
+	uint64_t t_quantized_encode = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	SNChunk scratch = *resident.front();
+	t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		for (const PackedByteArray &data : rle_data) {
+			scratch.deserialize_rle(data);
+		}
+	}
+	uint64_t t_rle_decode = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	t_start = Time::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		for (const PackedByteArray &data : quantized_data) {
+			scratch.deserialize(data);
+		}
+	}
+	uint64_t t_quantized_decode = Time::get_singleton()->get_ticks_usec() - t_start;
+
+	result["chunks"] = static_cast<int64_t>(resident.size());
+	result["uniform_chunks"] = uniform_chunks;
+	result["raw_bytes"] = raw_bytes;
+	result["rle_bytes"] = rle_bytes;
+	result["quantized_bytes"] = quantized_bytes;
+	result["rle_encode_usec"] = static_cast<double>(t_rle_encode) / p_iterations;
+	result["quantized_encode_usec"] = static_cast<double>(t_quantized_encode) / p_iterations;
+	result["rle_decode_usec"] = static_cast<double>(t_rle_decode) / p_iterations;
+	result["quantized_decode_usec"] = static_cast<double>(t_quantized_decode) / p_iterations;
+	result["match"] = match;
+	return result;
+}
+
 } //namespace godot
@@ -2,141 +2,148 @@
 #include "surface_nets/sdf_helpers.h"
 #include "surface_nets/sn_grid.h"
 
+#include <cstring>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SN_USE_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace godot {
 
-SurfaceNets::MeshData SurfaceNets::generate_mesh(const SNGrid *p_grid, const Vector3i &p_chunk_loc, const Vector3i &p_chunk_size, SurfaceNetsBuffer &p_buffer, bool p_cell_center, bool p_smooth_normal) {
-	Vector3i start_cell = p_chunk_loc * p_chunk_size - Vector3i(1, 1, 1);
-	Vector3i end_cell = (p_chunk_loc + Vector3i(1, 1, 1)) * p_chunk_size;
-	Vector3i cache_end = end_cell + Vector3i(1, 1, 1);
-	Vector3i size = cache_end - start_cell + Vector3i(1, 1, 1);
+namespace {
 
-	auto linearize = [&](const Vector3i &cell) -> int {
-		int lx = cell.x - start_cell.x;
-		int ly = cell.y - start_cell.y;
-		int lz = cell.z - start_cell.z;
-		return lx + ly * size.x + lz * (size.x * size.y);
-	};
+// Cell helper definitions
+const Vector3i CORNER_OFFSETS[8] = {
+	Vector3i(0, 0, 1), // c0
+	Vector3i(1, 0, 1), // c1
+	Vector3i(1, 0, 0), // c2
+	Vector3i(0, 0, 0), // c3
+	Vector3i(0, 1, 1), // c4
+	Vector3i(1, 1, 1), // c5
+	Vector3i(1, 1, 0), // c6
+	Vector3i(0, 1, 0) // c7
+};
 
-	// Cell helper definitions
-	const Vector3i corner_offsets[8] = {
-		Vector3i(0, 0, 1), // c0
-		Vector3i(1, 0, 1), // c1
-		Vector3i(1, 0, 0), // c2
-		Vector3i(0, 0, 0), // c3
-		Vector3i(0, 1, 1), // c4
-		Vector3i(1, 1, 1), // c5
-		Vector3i(1, 1, 0), // c6
-		Vector3i(0, 1, 0) // c7
-	};
+const int CELL_EDGES[12][2] = {
+	{ 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, // Bottom face
+	{ 4, 5 },
+	{ 5, 6 },
+	{ 6, 7 },
+	{ 7, 4 }, // Top face
+	{ 0, 4 },
+	{ 1, 5 },
+	{ 2, 6 },
+	{ 3, 7 } // Vertical edges
+};
 
-	const int cell_edges[12][2] = {
-		{ 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, // Bottom face
-		{ 4, 5 },
-		{ 5, 6 },
-		{ 6, 7 },
-		{ 7, 4 }, // Top face
-		{ 0, 4 },
-		{ 1, 5 },
-		{ 2, 6 },
-		{ 3, 7 } // Vertical edges
-	};
+// EDGE_TABLE[case] has bit e set when CELL_EDGES[e] crosses the surface; case bit i is set when corner i is solid.
+struct EdgeTable {
+	uint16_t masks[256];
 
-	// 1. Cache all density values for the volume to minimize grid checks
-	std::vector<int8_t> densities_cache(size.x * size.y * size.z);
-	for (int gy = start_cell.y; gy <= cache_end.y; ++gy) {
-		for (int gz = start_cell.z; gz <= cache_end.z; ++gz) {
-			for (int gx = start_cell.x; gx <= cache_end.x; ++gx) {
-				Vector3i global_cell(gx, gy, gz);
-				densities_cache[linearize(global_cell)] = p_grid->get_density(global_cell);
+	EdgeTable() {
+		for (int c = 0; c < 256; c++) {
+			uint16_t mask = 0;
+			for (int e = 0; e < 12; e++) {
+				if (((c >> CELL_EDGES[e][0]) ^ (c >> CELL_EDGES[e][1])) & 1) {
+					mask |= static_cast<uint16_t>(1 << e);
+				}
 			}
+			masks[c] = mask;
 		}
 	}
+};
 
-	p_buffer.reset(size.x * size.y * size.z);
+const EdgeTable EDGE_TABLE;
 
-	// 2. Scan and compute vertices for crossing cells
-	for (int gy = start_cell.y; gy <= end_cell.y; ++gy) {
-		for (int gz = start_cell.z; gz <= end_cell.z; ++gz) {
-			for (int gx = start_cell.x; gx <= end_cell.x; ++gx) {
-				Vector3i global_cell(gx, gy, gz);
-				int stride = linearize(global_cell);
+inline int lowest_bit(uint64_t p_bits) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, p_bits);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(p_bits);
+#endif
+}
 
-				int8_t densities[8];
-				bool has_solid = false;
-				bool has_empty = false;
-				for (int i = 0; i < 8; ++i) {
-					densities[i] = densities_cache[linearize(global_cell + corner_offsets[i])];
-					if (densities[i] < 0) {
-						has_solid = true;
-					} else {
-						has_empty = true;
-					}
-				}
+// Packs the sign of each density into r_words, bit x set when p_row[x] is solid (negative).
+inline void build_sign_bits(const int8_t *p_row, int p_count, uint64_t *r_words, int p_words) {
+	for (int w = 0; w < p_words; w++) {
+		r_words[w] = 0;
+	}
 
-				if (has_solid && has_empty) {
-					Vector3 sum_pts(0, 0, 0);
-					int count = 0;
-					for (int e = 0; e < 12; ++e) {
-						int idxA = cell_edges[e][0];
-						int idxB = cell_edges[e][1];
-						int8_t dA = densities[idxA];
-						int8_t dB = densities[idxB];
-						if ((dA < 0 && dB >= 0) || (dA >= 0 && dB < 0)) {
-							float t = -static_cast<float>(dA) / (static_cast<float>(dB) - static_cast<float>(dA));
-							Vector3 pA = Vector3(corner_offsets[idxA]);
-							Vector3 pB = Vector3(corner_offsets[idxB]);
-							sum_pts += pA.lerp(pB, t);
-							count++;
-						}
-					}
+	int x = 0;
+#ifdef SN_USE_SSE2
+	// movemask gathers the top (sign) bit of 16 densities at once
+	for (; x + 16 <= p_count; x += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_row + x));
+		uint64_t mask = static_cast<uint32_t>(_mm_movemask_epi8(v));
+		r_words[x >> 6] |= mask << (x & 63);
+	}
+#endif
+	for (; x < p_count; x++) {
+		r_words[x >> 6] |= static_cast<uint64_t>(p_row[x] < 0) << (x & 63);
+	}
+}
 
-					Vector3 c;
-					if (p_cell_center) {
-						c = Vector3(0.5f, 0.5f, 0.5f);
-					} else {
-						if (count > 0) {
-							c = sum_pts / static_cast<float>(count);
-						} else {
-							c = Vector3(0.5f, 0.5f, 0.5f);
-						}
-					}
+// Bits of p_row shifted down by one, so bit x holds corner x + 1.
+inline uint64_t next_corner_bits(const uint64_t *p_row, int p_word) {
+	return (p_row[p_word] >> 1) | (p_row[p_word + 1] << 63);
+}
 
-					Vector3 v_pos = Vector3(global_cell) + c;
-					p_buffer.positions.push_back(v_pos);
+// Places the cell vertex from the summed edge crossings and records it in the buffer.
+void emit_vertex(SurfaceNetsBuffer &p_buffer, const Vector3i &p_global_cell, int p_stride, const int8_t p_densities[8], const Vector3 &p_sum_pts, int p_count, bool p_cell_center, bool p_smooth_normal) {
+	Vector3 c;
+	if (p_cell_center) {
+		c = Vector3(0.5f, 0.5f, 0.5f);
+	} else {
+		if (p_count > 0) {
+			c = p_sum_pts / static_cast<float>(p_count);
+		} else {
+			c = Vector3(0.5f, 0.5f, 0.5f);
+		}
+	}
 
-					// Compute normal using sdf_gradient
-					float corner_dists[8];
-					for (int i = 0; i < 8; ++i) {
-						corner_dists[i] = static_cast<float>(densities[BINARY_TO_CPP_CORNER[i]]);
-					}
-					// If smooth normal is enabled, interpolate gradient at the surface point c.
-					// Otherwise, sample the gradient at the cell center (0.5, 0.5, 0.5) for flat shading.
-					Vector3 norm_sample_pt = p_smooth_normal ? c : Vector3(0.5f, 0.5f, 0.5f);
-					Vector3 norm = sdf_gradient(corner_dists, norm_sample_pt);
-					if (norm.length_squared() > 0.001f) {
-						norm.normalize();
-					} else {
-						norm = Vector3(0, 1, 0);
-					}
-					p_buffer.normals.push_back(norm);
+	Vector3 v_pos = Vector3(p_global_cell) + c;
+	p_buffer.positions.push_back(v_pos);
 
-					p_buffer.stride_to_index[stride] = p_buffer.positions.size() - 1;
-					p_buffer.surface_points.push_back(global_cell);
-					p_buffer.surface_strides.push_back(stride);
-				}
-			}
-		}
+	// Compute normal using sdf_gradient
+	float corner_dists[8];
+	for (int i = 0; i < 8; ++i) {
+		corner_dists[i] = static_cast<float>(p_densities[BINARY_TO_CPP_CORNER[i]]);
+	}
+	// If smooth normal is enabled, interpolate gradient at the surface point c.
+	// Otherwise, sample the gradient at the cell center (0.5, 0.5, 0.5) for flat shading.
+	Vector3 norm_sample_pt = p_smooth_normal ? c : Vector3(0.5f, 0.5f, 0.5f);
+	Vector3 norm = sdf_gradient(corner_dists, norm_sample_pt);
+	if (norm.length_squared() > 0.001f) {
+		norm.normalize();
+	} else {
+		norm = Vector3(0, 1, 0);
 	}
+	p_buffer.normals.push_back(norm);
 
-	MeshData data;
+	p_buffer.stride_to_index[p_stride] = p_buffer.positions.size() - 1;
+	p_buffer.surface_points.push_back(p_global_cell);
+	p_buffer.surface_strides.push_back(p_stride);
+}
+
+// Connects the vertices of the four cells around every crossing edge inside the chunk, then copies the result out.
+SurfaceNets::MeshData build_mesh_data(SurfaceNetsBuffer &p_buffer, const int8_t *p_densities, const Vector3i &p_size, const Vector3i &p_chunk_loc, const Vector3i &p_chunk_size) {
+	SurfaceNets::MeshData data;
 	if (p_buffer.positions.empty()) {
 		return data;
 	}
 
-	// 3. Helper lambda to add a quad (2 triangles) connecting 4 cells sharing a crossing edge
+	// Helper lambda to add a quad (2 triangles) connecting 4 cells sharing a crossing edge
 	auto maybe_make_quad = [&](int p1, int p2, int axis_b_stride, int axis_c_stride) {
-		int8_t d1 = densities_cache[p1];
-		int8_t d2 = densities_cache[p2];
+		int8_t d1 = p_densities[p1];
+		int8_t d2 = p_densities[p2];
 
 		bool negative_face = false;
 		if (d1 < 0 && d2 >= 0) {
@@ -197,7 +204,7 @@ SurfaceNets::MeshData SurfaceNets::generate_mesh(const SNGrid *p_grid, const Vec
 		}
 	};
 
-	// 4. Scan internal edges of the chunk and generate indices
+	// Scan internal edges of the chunk and generate indices
 	int start_x = p_chunk_loc.x * p_chunk_size.x;
 	int end_x = (p_chunk_loc.x + 1) * p_chunk_size.x;
 	int start_y = p_chunk_loc.y * p_chunk_size.y;
@@ -206,8 +213,8 @@ SurfaceNets::MeshData SurfaceNets::generate_mesh(const SNGrid *p_grid, const Vec
 	int end_z = (p_chunk_loc.z + 1) * p_chunk_size.z;
 
 	int x_stride = 1;
-	int y_stride = size.x;
-	int z_stride = size.x * size.y;
+	int y_stride = p_size.x;
+	int z_stride = p_size.x * p_size.y;
 
 	for (size_t i = 0; i < p_buffer.surface_points.size(); ++i) {
 		Vector3i global_cell = p_buffer.surface_points[i];
@@ -226,7 +233,7 @@ SurfaceNets::MeshData SurfaceNets::generate_mesh(const SNGrid *p_grid, const Vec
 		}
 	}
 
-	// 5. Copy final mesh data for Godot compatibility
+	// Copy final mesh data for Godot compatibility
 	data.vertices.resize(p_buffer.positions.size());
 	if (!p_buffer.positions.empty()) {
 		memcpy(data.vertices.ptrw(), p_buffer.positions.data(), p_buffer.positions.size() * sizeof(Vector3));
@@ -245,4 +252,257 @@ SurfaceNets::MeshData SurfaceNets::generate_mesh(const SNGrid *p_grid, const Vec
 	return data;
 }
 
+} // namespace
+
+SurfaceNets::MeshData SurfaceNets::generate_mesh(const SNGrid *p_grid, const Vector3i &p_chunk_loc, const Vector3i &p_chunk_size, SurfaceNetsBuffer &p_buffer, bool p_cell_center, bool p_smooth_normal, int p_lod) {
+	// Everything below works in LOD cells; vertices are scaled back to voxels at the end
+	int step = 1 << p_lod;
+	Vector3i lod_chunk_size(p_chunk_size.x / step, p_chunk_size.y / step, p_chunk_size.z / step);
+
+	Vector3i start_cell = p_chunk_loc * lod_chunk_size - Vector3i(1, 1, 1);
+	Vector3i size = lod_chunk_size + Vector3i(3, 3, 3);
+	size_t volume = static_cast<size_t>(size.x) * size.y * size.z;
+
+	int y_stride = size.x;
+	int z_stride = size.x * size.y;
+
+	// 1. Copy the chunk and its apron into one contiguous block, a row at a time
+	p_buffer.densities.resize(volume);
+	p_grid->copy_density_block(start_cell * Vector3i(step, step, step), size, p_buffer.densities.data(), step);
+	const int8_t *densities = p_buffer.densities.data();
+
+	p_buffer.reset(volume);
+
+	// 2. Sign masks for every corner row, with a trailing zero word so the +1 shift never reads past the row
+	int row_words = (size.x + 63) / 64 + 1;
+	int rows = size.y * size.z;
+	p_buffer.sign_bits.resize(static_cast<size_t>(rows) * row_words);
+	uint64_t *sign_bits = p_buffer.sign_bits.data();
+	for (int r = 0; r < rows; r++) {
+		build_sign_bits(densities + static_cast<size_t>(r) * size.x, size.x, sign_bits + static_cast<size_t>(r) * row_words, row_words);
+	}
+	// Row (ly, lz) starts at densities[ly * y_stride + lz * z_stride], i.e. row number ly + lz * size.y
+	auto row_bits = [&](int p_ly, int p_lz) -> const uint64_t * {
+		return sign_bits + static_cast<size_t>(p_ly + p_lz * size.y) * row_words;
+	};
+
+	int corner_strides[8];
+	for (int i = 0; i < 8; ++i) {
+		corner_strides[i] = CORNER_OFFSETS[i].x + CORNER_OFFSETS[i].y * y_stride + CORNER_OFFSETS[i].z * z_stride;
+	}
+
+	// 3. Classify 64 cells per step and compute vertices only for the mixed ones
+	int cells_x = size.x - 1;
+	int cell_words = (cells_x + 63) / 64;
+	for (int ly = 0; ly < size.y - 1; ++ly) {
+		for (int lz = 0; lz < size.z - 1; ++lz) {
+			const uint64_t *r_yz = row_bits(ly, lz);
+			const uint64_t *r_yz1 = row_bits(ly, lz + 1);
+			const uint64_t *r_y1z = row_bits(ly + 1, lz);
+			const uint64_t *r_y1z1 = row_bits(ly + 1, lz + 1);
+
+			for (int w = 0; w < cell_words; w++) {
+				// Bit x of each word holds corner i of cell x, in c0..c7 order
+				uint64_t c[8] = {
+					r_yz1[w], next_corner_bits(r_yz1, w), next_corner_bits(r_yz, w), r_yz[w],
+					r_y1z1[w], next_corner_bits(r_y1z1, w), next_corner_bits(r_y1z, w), r_y1z[w]
+				};
+
+				uint64_t any_solid = c[0] | c[1] | c[2] | c[3] | c[4] | c[5] | c[6] | c[7];
+				uint64_t all_solid = c[0] & c[1] & c[2] & c[3] & c[4] & c[5] & c[6] & c[7];
+				uint64_t mixed = any_solid & ~all_solid;
+
+				int base_x = w * 64;
+				if (cells_x - base_x < 64) {
+					mixed &= (uint64_t(1) << (cells_x - base_x)) - 1;
+				}
+
+				while (mixed) {
+					int b = lowest_bit(mixed);
+					mixed &= mixed - 1;
+
+					int lx = base_x + b;
+					int stride = lx + ly * y_stride + lz * z_stride;
+
+					uint32_t cell_case = 0;
+					int8_t cell_densities[8];
+					for (int i = 0; i < 8; ++i) {
+						cell_case |= static_cast<uint32_t>((c[i] >> b) & 1) << i;
+						cell_densities[i] = densities[stride + corner_strides[i]];
+					}
+
+					Vector3 sum_pts(0, 0, 0);
+					int count = 0;
+					uint32_t edges = EDGE_TABLE.masks[cell_case];
+					while (edges) {
+						int e = lowest_bit(edges);
+						edges &= edges - 1;
+
+						int idxA = CELL_EDGES[e][0];
+						int idxB = CELL_EDGES[e][1];
+						int8_t dA = cell_densities[idxA];
+						int8_t dB = cell_densities[idxB];
+						float t = -static_cast<float>(dA) / (static_cast<float>(dB) - static_cast<float>(dA));
+						sum_pts += Vector3(CORNER_OFFSETS[idxA]).lerp(Vector3(CORNER_OFFSETS[idxB]), t);
+						count++;
+					}
+
+					Vector3i global_cell = start_cell + Vector3i(lx, ly, lz);
+					emit_vertex(p_buffer, global_cell, stride, cell_densities, sum_pts, count, p_cell_center, p_smooth_normal);
+				}
+			}
+		}
+	}
+
+	MeshData data = build_mesh_data(p_buffer, densities, size, p_chunk_loc, lod_chunk_size);
+	if (step > 1) {
+		Vector3 *vertices = data.vertices.ptrw();
+		for (int i = 0; i < data.vertices.size(); ++i) {
+			vertices[i] *= static_cast<float>(step);
+		}
+	}
+	return data;
+}
+
+void SurfaceNets::add_skirts(MeshData &r_data, float p_length) {
+	int vertex_count = r_data.vertices.size();
+	int index_count = r_data.indices.size();
+	if (index_count == 0) {
+		return;
+	}
+
+	const Vector3 *vertices = r_data.vertices.ptr();
+	const Vector3 *normals = r_data.normals.ptr();
+	const int32_t *indices = r_data.indices.ptr();
+
+	// Undirected edges used by a single triangle lie on the open border of the chunk mesh
+	auto edge_key = [](int32_t a, int32_t b) -> uint64_t {
+		return (static_cast<uint64_t>(static_cast<uint32_t>(MIN(a, b))) << 32) | static_cast<uint32_t>(MAX(a, b));
+	};
+	std::unordered_map<uint64_t, int> edge_uses;
+	edge_uses.reserve(static_cast<size_t>(index_count));
+	for (int t = 0; t + 2 < index_count; t += 3) {
+		for (int k = 0; k < 3; ++k) {
+			edge_uses[edge_key(indices[t + k], indices[t + (k + 1) % 3])]++;
+		}
+	}
+
+	std::vector<int32_t> skirt_of(static_cast<size_t>(vertex_count), -1);
+	std::vector<Vector3> extra_vertices;
+	std::vector<Vector3> extra_normals;
+	std::vector<int32_t> extra_indices;
+
+	auto skirt_vertex = [&](int32_t v) -> int32_t {
+		if (skirt_of[v] < 0) {
+			skirt_of[v] = vertex_count + static_cast<int32_t>(extra_vertices.size());
+			extra_vertices.push_back(vertices[v] - normals[v] * p_length);
+			extra_normals.push_back(normals[v]);
+		}
+		return skirt_of[v];
+	};
+
+	for (int t = 0; t + 2 < index_count; t += 3) {
+		for (int k = 0; k < 3; ++k) {
+			int32_t a = indices[t + k];
+			int32_t b = indices[t + (k + 1) % 3];
+			if (edge_uses[edge_key(a, b)] != 1) {
+				continue;
+			}
+			int32_t a2 = skirt_vertex(a);
+			int32_t b2 = skirt_vertex(b);
+
+			// The border triangle runs a->b, so the skirt runs b->a to face the same way
+			extra_indices.push_back(b);
+			extra_indices.push_back(a);
+			extra_indices.push_back(a2);
+			extra_indices.push_back(b);
+			extra_indices.push_back(a2);
+			extra_indices.push_back(b2);
+		}
+	}
+
+	if (extra_indices.empty()) {
+		return;
+	}
+
+	r_data.vertices.resize(vertex_count + static_cast<int>(extra_vertices.size()));
+	memcpy(r_data.vertices.ptrw() + vertex_count, extra_vertices.data(), extra_vertices.size() * sizeof(Vector3));
+	r_data.normals.resize(vertex_count + static_cast<int>(extra_normals.size()));
+	memcpy(r_data.normals.ptrw() + vertex_count, extra_normals.data(), extra_normals.size() * sizeof(Vector3));
+	r_data.indices.resize(index_count + static_cast<int>(extra_indices.size()));
+	memcpy(r_data.indices.ptrw() + index_count, extra_indices.data(), extra_indices.size() * sizeof(int32_t));
+}
+
+SurfaceNets::MeshData SurfaceNets::generate_mesh_reference(const SNGrid *p_grid, const Vector3i &p_chunk_loc, const Vector3i &p_chunk_size, SurfaceNetsBuffer &p_buffer, bool p_cell_center, bool p_smooth_normal) {
+	Vector3i start_cell = p_chunk_loc * p_chunk_size - Vector3i(1, 1, 1);
+	Vector3i end_cell = (p_chunk_loc + Vector3i(1, 1, 1)) * p_chunk_size;
+	Vector3i cache_end = end_cell + Vector3i(1, 1, 1);
+	Vector3i size = cache_end - start_cell + Vector3i(1, 1, 1);
+
+	auto linearize = [&](const Vector3i &cell) -> int {
+		int lx = cell.x - start_cell.x;
+		int ly = cell.y - start_cell.y;
+		int lz = cell.z - start_cell.z;
+		return lx + ly * size.x + lz * (size.x * size.y);
+	};
+
+	// 1. Cache all density values for the volume to minimize grid checks
+	std::vector<int8_t> densities_cache(size.x * size.y * size.z);
+	for (int gy = start_cell.y; gy <= cache_end.y; ++gy) {
+		for (int gz = start_cell.z; gz <= cache_end.z; ++gz) {
+			for (int gx = start_cell.x; gx <= cache_end.x; ++gx) {
+				Vector3i global_cell(gx, gy, gz);
+				densities_cache[linearize(global_cell)] = p_grid->get_density(global_cell);
+			}
+		}
+	}
+
+	p_buffer.reset(size.x * size.y * size.z);
+
+	// 2. Scan and compute vertices for crossing cells
+	for (int gy = start_cell.y; gy <= end_cell.y; ++gy) {
+		for (int gz = start_cell.z; gz <= end_cell.z; ++gz) {
+			for (int gx = start_cell.x; gx <= end_cell.x; ++gx) {
+				Vector3i global_cell(gx, gy, gz);
+				int stride = linearize(global_cell);
+
+				int8_t densities[8];
+				bool has_solid = false;
+				bool has_empty = false;
+				for (int i = 0; i < 8; ++i) {
+					densities[i] = densities_cache[linearize(global_cell + CORNER_OFFSETS[i])];
+					if (densities[i] < 0) {
+						has_solid = true;
+					} else {
+						has_empty = true;
+					}
+				}
+
+				if (has_solid && has_empty) {
+					Vector3 sum_pts(0, 0, 0);
+					int count = 0;
+					for (int e = 0; e < 12; ++e) {
+						int idxA = CELL_EDGES[e][0];
+						int idxB = CELL_EDGES[e][1];
+						int8_t dA = densities[idxA];
+						int8_t dB = densities[idxB];
+						if ((dA < 0 && dB >= 0) || (dA >= 0 && dB < 0)) {
+							float t = -static_cast<float>(dA) / (static_cast<float>(dB) - static_cast<float>(dA));
+							Vector3 pA = Vector3(CORNER_OFFSETS[idxA]);
+							Vector3 pB = Vector3(CORNER_OFFSETS[idxB]);
+							sum_pts += pA.lerp(pB, t);
+							count++;
+						}
+					}
+
+					emit_vertex(p_buffer, global_cell, stride, densities, sum_pts, count, p_cell_center, p_smooth_normal);
+				}
+			}
+		}
+	}
+
+	// 3. Connect the vertices into quads
+	return build_mesh_data(p_buffer, densities_cache.data(), size, p_chunk_loc, p_chunk_size);
+}
+
 } // namespace godot
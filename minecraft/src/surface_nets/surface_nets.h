@@ -5,12 +5,17 @@
 #include <godot_cpp/variant/packed_int32_array.hpp>
 #include <godot_cpp/variant/packed_vector3_array.hpp>
 #include <godot_cpp/variant/vector3i.hpp>
+#include <cstdint>
+#include <vector>
 
 namespace godot {
 
 class SNGrid;
 
 struct SurfaceNetsBuffer {
+	std::vector<int8_t> densities; // Padded chunk-plus-apron density block, x fastest, then y, then z
+	std::vector<uint64_t> sign_bits; // One bit per corner of the block (set when solid), rows padded to whole words
+
 	std::vector<Vector3> positions;
 	std::vector<Vector3> normals;
 	std::vector<int32_t> indices;
@@ -42,7 +47,29 @@ public:
 		PackedInt32Array indices;
 	};
 
-	static MeshData generate_mesh(const SNGrid *p_grid, const Vector3i &p_chunk_loc, const Vector3i &p_chunk_size, SurfaceNetsBuffer &p_buffer, bool p_cell_center = false, bool p_smooth_normal = true);
+	/*
+	 * Meshes one chunk plus its one-cell apron.
+	 * Densities are copied into p_buffer.densities with whole-row copies, cells are
+	 * classified 64 at a time from per-row sign masks so fully inside/outside runs
+	 * are skipped, and crossing edges come from a 256-entry edge table.
+	 * p_lod meshes every (1 << p_lod)-th corner, so a cell spans 2^p_lod voxels;
+	 * p_chunk_size must be divisible by that step. Vertices stay in voxel units.
+	 */
+	static MeshData generate_mesh(const SNGrid *p_grid, const Vector3i &p_chunk_loc, const Vector3i &p_chunk_size, SurfaceNetsBuffer &p_buffer, bool p_cell_center = false, bool p_smooth_normal = true, int p_lod = 0);
+
+	/*
+	 * Hangs a strip of triangles below every open border edge of the mesh, pushed p_length
+	 * along each vertex's inverted normal. Hides the cracks left where chunks meshed at
+	 * different LODs meet.
+	 */
+	static void add_skirts(MeshData &r_data, float p_length);
+
+	/*
+	 * Original per-voxel implementation: one get_density call per corner and a
+	 * 12-edge scan per cell. Produces the same mesh as generate_mesh and is kept
+	 * as the baseline for SNGrid::benchmark_surface_nets.
+	 */
+	static MeshData generate_mesh_reference(const SNGrid *p_grid, const Vector3i &p_chunk_loc, const Vector3i &p_chunk_size, SurfaceNetsBuffer &p_buffer, bool p_cell_center = false, bool p_smooth_normal = true);
 };
 
 } // namespace godot
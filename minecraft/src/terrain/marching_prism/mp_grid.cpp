@@ -19,6 +19,8 @@
 #include <godot_cpp/classes/sphere_mesh.hpp>
 #include <godot_cpp/classes/standard_material3d.hpp>
 #include <godot_cpp/classes/static_body3d.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 namespace godot {
@@ -40,6 +42,9 @@ void MPGrid::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_total_mp_meshes"), &MPGrid::get_total_mp_meshes);
 	ClassDB::bind_method(D_METHOD("get_total_debug_corners"), &MPGrid::get_total_debug_corners);
 	ClassDB::bind_method(D_METHOD("get_total_cells"), &MPGrid::get_total_cells);
+	ClassDB::bind_method(D_METHOD("get_refresh_timings"), &MPGrid::get_refresh_timings);
+	ClassDB::bind_method(D_METHOD("_hash_chunk_task", "index"), &MPGrid::_hash_chunk_task);
+	ClassDB::bind_method(D_METHOD("_build_chunk_task", "index"), &MPGrid::_build_chunk_task);
 	ClassDB::bind_method(D_METHOD("set_hover_cylinder_alpha", "alpha"), &MPGrid::set_hover_cylinder_alpha);
 	ClassDB::bind_method(D_METHOD("get_hover_cylinder_alpha"), &MPGrid::get_hover_cylinder_alpha);
 
@@ -117,8 +122,28 @@ void MPGrid::refresh_grid() {
 	_debug_corner_mesh->set_radius(0.04f);
 	_debug_corner_mesh->set_height(0.08f);
 
+	if (mp_node) {
+		chunk_builds.resize(chunks.size());
+
+		uint64_t t_start = Time::get_singleton()->get_ticks_usec();
+		_run_chunk_tasks("_hash_chunk_task", "MPGrid_Hash");
+		uint64_t t_hashed = Time::get_singleton()->get_ticks_usec();
+		_run_chunk_tasks("_build_chunk_task", "MPGrid_Build");
+		uint64_t t_built = Time::get_singleton()->get_ticks_usec();
+
+		for (size_t i = 0; i < chunks.size(); i++) {
+			_commit_chunk(chunks[i], chunk_builds[i]);
+		}
+		uint64_t t_committed = Time::get_singleton()->get_ticks_usec();
+
+		refresh_hash_usec = t_hashed - t_start;
+		refresh_build_usec = t_built - t_hashed;
+		refresh_commit_usec = t_committed - t_built;
+		UtilityFunctions::print("MPGrid Refresh: ", (int)chunks.size(), " chunks | hash ", refresh_hash_usec / 1000.0,
+				" ms | build ", refresh_build_usec / 1000.0, " ms | commit ", refresh_commit_usec / 1000.0, " ms");
+	}
+
 	for (const MPChunk &chunk : chunks) {
-		_spawn_marching_prisms(chunk, mp_node);
 		_spawn_debug_spheres(chunk, _debug_corner_mesh);
 	}
 
@@ -126,136 +151,173 @@ void MPGrid::refresh_grid() {
 		debug_corners_container->set_visible(debug_draw_mode == DEBUG_SHOW_CORNER || debug_draw_mode == DEBUG_SHOW_CORNER_AND_EDGE);
 }
 
-int MPGrid::_spawn_marching_prisms(const MPChunk &p_chunk, MPNode *p_mp_node) {
-	if (!p_mp_node)
-		return 0;
-	int count = 0;
+Dictionary MPGrid::get_refresh_timings() const {
+	Dictionary result;
+	result["chunks"] = (int)chunks.size();
+	result["hash_usec"] = (int64_t)refresh_hash_usec;
+	result["build_usec"] = (int64_t)refresh_build_usec;
+	result["commit_usec"] = (int64_t)refresh_commit_usec;
+	return result;
+}
 
-	for (int y = 0; y < p_chunk.size_y; y++) {
-		for (int z = 0; z < p_chunk.size_z; z++) {
-			for (int cx = 0; cx < p_chunk.size_x * 2; cx++) {
-				int global_cx = (p_chunk.loc_x * p_chunk.size_x * 2) + cx;
-				int global_z = (p_chunk.loc_z * p_chunk.size_z) + z;
-				int global_y = (p_chunk.loc_y * p_chunk.size_y) + y;
+uint8_t MPChunk::get_prism_config(int cx, int y, int z, int r_v_x[3], int r_v_z[3], bool &r_points_down) const {
+	// Bind strictly to GLOBAL coordinates to ensure chunks seal perfectly
+	int global_cx = (loc_x * size_x * 2) + cx;
+	int global_z = (loc_z * size_z) + z;
+	int vx = cx / 2;
+	r_points_down = ((global_cx + global_z) % 2 == 0);
+
+	if (r_points_down) {
+		r_v_x[1] = vx;
+		r_v_z[1] = z;
+		r_v_x[0] = vx + 1;
+		r_v_z[0] = z;
+		r_v_x[2] = (global_z % 2 == 0) ? vx : vx + 1;
+		r_v_z[2] = z + 1;
+	} else {
+		r_v_x[0] = vx;
+		r_v_z[0] = z + 1;
+		r_v_x[1] = vx + 1;
+		r_v_z[1] = z + 1;
+		r_v_x[2] = (global_z % 2 == 0) ? vx + 1 : vx;
+		r_v_z[2] = z;
+	}
 
-				int vx = cx / 2;
-				int v0_x, v0_z, v1_x, v1_z, v2_x, v2_z;
+	uint8_t config_idx = 0;
+	for (int i = 0; i < 3; i++) {
+		if (get_corner(r_v_x[i], y, r_v_z[i]))
+			config_idx |= (1 << i);
+		if (get_corner(r_v_x[i], y + 1, r_v_z[i]))
+			config_idx |= (1 << (i + 3));
+	}
+	return config_idx;
+}
 
-				// Bind strictly to GLOBAL coordinates to ensure chunks seal perfectly
-				bool points_down = ((global_cx + global_z) % 2 == 0);
+void MPGrid::_hash_chunk_task(int p_index) {
+	const MPChunk &chunk = chunks[p_index];
+	MPChunkBuild &build = chunk_builds[p_index];
+	build.configs.resize(chunk.size_x * 2 * chunk.size_y * chunk.size_z);
+
+	int v_x[3], v_z[3];
+	bool points_down = false;
+	uint8_t *out = build.configs.data();
+	for (int y = 0; y < chunk.size_y; y++) {
+		for (int z = 0; z < chunk.size_z; z++) {
+			for (int cx = 0; cx < chunk.size_x * 2; cx++) {
+				*out++ = chunk.get_prism_config(cx, y, z, v_x, v_z, points_down);
+			}
+		}
+	}
+}
 
-				if (global_z % 2 == 0) {
-					if (points_down) {
-						v1_x = vx;
-						v1_z = z;
-						v0_x = vx + 1;
-						v0_z = z;
-						v2_x = vx;
-						v2_z = z + 1;
-					} else {
-						v0_x = vx;
-						v0_z = z + 1;
-						v1_x = vx + 1;
-						v1_z = z + 1;
-						v2_x = vx + 1;
-						v2_z = z;
-					}
-				} else {
-					if (points_down) {
-						v1_x = vx;
-						v1_z = z;
-						v0_x = vx + 1;
-						v0_z = z;
-						v2_x = vx + 1;
-						v2_z = z + 1;
-					} else {
-						v0_x = vx;
-						v0_z = z + 1;
-						v1_x = vx + 1;
-						v1_z = z + 1;
-						v2_x = vx;
-						v2_z = z;
-					}
-				}
+void MPGrid::_build_chunk_task(int p_index) {
+	const MPChunk &chunk = chunks[p_index];
+	MPChunkBuild &build = chunk_builds[p_index];
+	build.spawns.clear();
 
-				uint8_t config_idx = 0;
-				if (p_chunk.get_corner(v0_x, y, v0_z))
-					config_idx |= (1 << 0);
-				if (p_chunk.get_corner(v1_x, y, v1_z))
-					config_idx |= (1 << 1);
-				if (p_chunk.get_corner(v2_x, y, v2_z))
-					config_idx |= (1 << 2);
-				if (p_chunk.get_corner(v0_x, y + 1, v0_z))
-					config_idx |= (1 << 3);
-				if (p_chunk.get_corner(v1_x, y + 1, v1_z))
-					config_idx |= (1 << 4);
-				if (p_chunk.get_corner(v2_x, y + 1, v2_z))
-					config_idx |= (1 << 5);
+	for (int y = 0; y < chunk.size_y; y++) {
+		for (int z = 0; z < chunk.size_z; z++) {
+			for (int cx = 0; cx < chunk.size_x * 2; cx++) {
+				int cell_idx = (y * chunk.size_x * 2 * chunk.size_z) + (z * chunk.size_x * 2) + cx;
+				uint8_t config_idx = build.configs[cell_idx];
+				if (config_idx == 0 || config_idx == 63)
+					continue;
+				if (mp_node->get_mesh_config(config_idx).mesh.is_null())
+					continue;
 
-				total_cells++;
+				MPCellSpawn spawn;
+				spawn.cell_idx = cell_idx;
+				spawn.cx = cx;
+				spawn.y = y;
+				spawn.z = z;
+				spawn.config = config_idx;
+				chunk.get_prism_config(cx, y, z, spawn.v_x, spawn.v_z, spawn.points_down);
 
 				// Centroid Math completely decouples from stagger, it is perfectly linear
+				int global_cx = (chunk.loc_x * chunk.size_x * 2) + cx;
+				int global_z = (chunk.loc_z * chunk.size_z) + z;
+				int global_y = (chunk.loc_y * chunk.size_y) + y;
 				float centroid_x = (global_cx + 1.0f) * 0.5f;
-				float centroid_z = (global_z * 0.866025f) + (points_down ? 0.288675f : 0.577350f);
+				float centroid_z = (global_z * 0.866025f) + (spawn.points_down ? 0.288675f : 0.577350f);
 				float centroid_y = (global_y * 1.0f) + 0.5f;
+				spawn.world_pos = Vector3(centroid_x, centroid_y, centroid_z);
 
-				Vector3 world_pos = Vector3(centroid_x, centroid_y, centroid_z);
-				int cell_idx = (y * p_chunk.size_x * 2 * p_chunk.size_z) + (z * p_chunk.size_x * 2) + cx;
-
-				if (config_idx == 0 || config_idx == 63)
-					continue;
-
-				PrismMeshConfig conf = p_mp_node->get_mesh_config(config_idx);
-				if (conf.mesh.is_null())
-					continue;
-
-				// Spawn cell collider only when mesh exists
-				StaticBody3D *cell_sb = memnew(StaticBody3D);
-				cell_sb->set_position(world_pos);
-				cell_sb->set_collision_layer(toLayer(LAYER_CELLS));
-				cell_sb->set_meta("is_cell", true);
-				cell_sb->set_meta("cell_x", global_cx);
-				cell_sb->set_meta("cell_y", global_y);
-				cell_sb->set_meta("cell_z", global_z);
+				build.spawns.push_back(spawn);
+			}
+		}
+	}
+}
 
-				CollisionShape3D *cs = memnew(CollisionShape3D);
-				BoxShape3D *shape = memnew(BoxShape3D);
-				shape->set_size(Vector3(0.4, 0.4, 0.4));
-				cs->set_shape(shape);
-				cell_sb->add_child(cs);
-				add_child(cell_sb);
+void MPGrid::_run_chunk_tasks(const StringName &p_method, const String &p_task_name) {
+	int num_tasks = (int)chunks.size();
+	if (num_tasks <= 0)
+		return;
 
-				const_cast<MPChunk &>(p_chunk).cell_colliders[cell_idx] = cell_sb;
+	WorkerThreadPool *wtp = WorkerThreadPool::get_singleton();
+	if (wtp && num_tasks > 1) {
+		int group_id = wtp->add_group_task(Callable(this, p_method), num_tasks, -1, true, p_task_name);
+		wtp->wait_for_group_task_completion(group_id);
+	} else {
+		for (int i = 0; i < num_tasks; i++) {
+			call(p_method, i);
+		}
+	}
+}
 
-				// Draw active cell wireframe using debug helper if mode allows
-				if (debug_draw_mode == DEBUG_SHOW_CORNER_AND_EDGE) {
-					_draw_cell_wireframe(p_chunk, cx, y, z, v0_x, v0_z, v1_x, v1_z, v2_x, v2_z);
-				} else {
-					_clear_cell_wireframe(p_chunk, cx, y, z);
-				}
+int MPGrid::_commit_chunk(MPChunk &p_chunk, const MPChunkBuild &p_build) {
+	total_cells += p_chunk.size_x * 2 * p_chunk.size_y * p_chunk.size_z;
+
+	for (const MPCellSpawn &spawn : p_build.spawns) {
+		PrismMeshConfig conf = mp_node->get_mesh_config(spawn.config);
+
+		int global_cx = (p_chunk.loc_x * p_chunk.size_x * 2) + spawn.cx;
+		int global_z = (p_chunk.loc_z * p_chunk.size_z) + spawn.z;
+		int global_y = (p_chunk.loc_y * p_chunk.size_y) + spawn.y;
+
+		// Spawn cell collider only when mesh exists
+		StaticBody3D *cell_sb = memnew(StaticBody3D);
+		cell_sb->set_position(spawn.world_pos);
+		cell_sb->set_collision_layer(toLayer(LAYER_CELLS));
+		cell_sb->set_meta("is_cell", true);
+		cell_sb->set_meta("cell_x", global_cx);
+		cell_sb->set_meta("cell_y", global_y);
+		cell_sb->set_meta("cell_z", global_z);
+
+		CollisionShape3D *cs = memnew(CollisionShape3D);
+		BoxShape3D *shape = memnew(BoxShape3D);
+		shape->set_size(Vector3(0.4, 0.4, 0.4));
+		cs->set_shape(shape);
+		cell_sb->add_child(cs);
+		add_child(cell_sb);
+
+		p_chunk.cell_colliders[spawn.cell_idx] = cell_sb;
+
+		// Draw active cell wireframe using debug helper if mode allows
+		if (debug_draw_mode == DEBUG_SHOW_CORNER_AND_EDGE) {
+			_draw_cell_wireframe(p_chunk, spawn.cx, spawn.y, spawn.z, spawn.v_x[0], spawn.v_z[0], spawn.v_x[1], spawn.v_z[1], spawn.v_x[2], spawn.v_z[2]);
+		} else {
+			_clear_cell_wireframe(p_chunk, spawn.cx, spawn.y, spawn.z);
+		}
 
-				MeshInstance3D *mi = memnew(MeshInstance3D);
-				mi->set_mesh(conf.mesh);
-				Transform3D cell_t;
-				cell_t.origin = world_pos;
+		MeshInstance3D *mi = memnew(MeshInstance3D);
+		mi->set_mesh(conf.mesh);
+		Transform3D cell_t;
+		cell_t.origin = spawn.world_pos;
 
-				if (points_down) {
-					cell_t.basis = cell_t.basis.rotated(Vector3(0, 1, 0), Math_PI);
-				}
+		if (spawn.points_down) {
+			cell_t.basis = cell_t.basis.rotated(Vector3(0, 1, 0), Math_PI);
+		}
 
-				mi->set_transform(cell_t * conf.transform);
-				mi->set_cast_shadows_setting(GeometryInstance3D::SHADOW_CASTING_SETTING_OFF);
-				add_child(mi);
+		mi->set_transform(cell_t * conf.transform);
+		mi->set_cast_shadows_setting(GeometryInstance3D::SHADOW_CASTING_SETTING_OFF);
+		add_child(mi);
 
-				if (is_inside_tree())
-					mi->set_owner(get_owner() ? get_owner() : this);
-				const_cast<MPChunk &>(p_chunk).cell_visuals[cell_idx] = mi;
-				count++;
-				total_mp_meshes++;
-			}
-		}
+		if (is_inside_tree())
+			mi->set_owner(get_owner() ? get_owner() : this);
+		p_chunk.cell_visuals[spawn.cell_idx] = mi;
+		total_mp_meshes++;
 	}
-	return count;
+	return (int)p_build.spawns.size();
 }
 
 void MPGrid::_clear_children() {
@@ -516,6 +578,7 @@ void MPGrid::modify_corner(const Vector3i &p_grid_pos, bool p_active) {
 				int idx = _get_chunk_index(cx, cy, cz);
 				MPChunk &chunk = chunks[idx];
 				chunk.set_corner(gx - (cx * chunk_size.x), gy - (cy * chunk_size.y), gz - (cz * chunk_size.z), p_active);
+				chunk.save_dirty = true;
 				actual_modified = true;
 			}
 		}
@@ -9,8 +9,10 @@
 #define MP_GRID_H
 
 #include "terrain/marching_prism/mp.h"
+#include "utils/encoding/region_file.h"
 #include <cstdint>
 #include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/vector3i.hpp>
 #include <vector>
 
@@ -32,6 +34,7 @@ struct MPChunk {
 	int loc_y = 0;
 	int loc_z = 0;
 	std::vector<uint8_t> corner_states;
+	bool save_dirty = true; // Corners differ from the region file; set by edits, cleared once the chunk is written
 
 	std::vector<MeshInstance3D *> cell_visuals;
 	std::vector<StaticBody3D *> cell_colliders; // Tracks center of prism colliders
@@ -103,6 +106,28 @@ struct MPChunk {
 			return true;
 		return false;
 	}
+
+	// Returns the 6-bit configuration of prism cell (cx, y, z) and its triangle corner columns.
+	uint8_t get_prism_config(int cx, int y, int z, int r_v_x[3], int r_v_z[3], bool &r_points_down) const;
+};
+
+// A prism cell that needs a mesh, found by the build phase of MPGrid::refresh_grid.
+struct MPCellSpawn {
+	int cell_idx = 0; // Index into MPChunk::cell_visuals
+	int cx = 0; // Chunk-local prism column (0 .. size_x * 2)
+	int y = 0; // Chunk-local layer
+	int z = 0; // Chunk-local row
+	uint8_t config = 0; // 6-bit prism configuration
+	bool points_down = false; // Triangle orientation, rotates the mesh by 180 degrees
+	int v_x[3] = { 0, 0, 0 }; // Chunk-local X of the triangle corners (for the debug wireframe)
+	int v_z[3] = { 0, 0, 0 }; // Chunk-local Z of the triangle corners (for the debug wireframe)
+	Vector3 world_pos; // Prism centroid in grid space
+};
+
+// Output of the hash and build refresh phases for one chunk, filled on worker threads.
+struct MPChunkBuild {
+	std::vector<uint8_t> configs; // Configuration per prism cell, indexed like MPChunk::cell_visuals
+	std::vector<MPCellSpawn> spawns; // Cells that get a mesh and collider in the commit phase
 };
 
 class MPGrid : public Node3D {
@@ -121,6 +146,7 @@ private:
 	MPNode *mp_node = nullptr;
 	DebugDrawMode debug_draw_mode = DEBUG_SHOW_NONE; // Current debug draw mode.
 	std::vector<MPChunk> chunks;
+	RegionFile region; // Save file last loaded or saved, kept open so later saves only rewrite changed chunks
 	int total_mp_meshes = 0;
 	int total_debug_corners = 0;
 	int total_cells = 0;
@@ -137,6 +163,10 @@ private:
 	MeshInstance3D *hover_cylinder = nullptr; // Cylinder mesh representing the vertex click zone
 	float hover_cylinder_alpha = 0.5f; // Opacity of the hover cylinder visual preview.
 	MeshInstance3D *wireframe_instance = nullptr; // Renders all triangular prism edges in the grid.
+	std::vector<MPChunkBuild> chunk_builds; // One build slot per chunk for the parallel refresh
+	uint64_t refresh_hash_usec = 0; // Wall time of the last refresh's hash phase
+	uint64_t refresh_build_usec = 0; // Wall time of the last refresh's build phase
+	uint64_t refresh_commit_usec = 0; // Wall time of the last refresh's commit phase
 
 	inline int _get_chunk_index(int x, int y, int z) const {
 		return (y * grid_size.x * grid_size.z) + (z * grid_size.x) + x;
@@ -150,7 +180,12 @@ private:
 	void _initialize_boundaries(MPChunk &p_chunk) const;
 	// Spawns sphere debug visuals at the corners of a chunk for visualization/debugging.
 	int _spawn_debug_spheres(const MPChunk &p_chunk, const Ref<SphereMesh> &p_sphere_mesh);
-	int _spawn_marching_prisms(const MPChunk &p_chunk, MPNode *p_mp_node);
+	// Refresh pipeline: hash and build run on WorkerThreadPool, commit creates the nodes on the main thread.
+	void _hash_chunk_task(int p_index);
+	void _build_chunk_task(int p_index);
+	int _commit_chunk(MPChunk &p_chunk, const MPChunkBuild &p_build);
+	// Runs p_method(index) for every chunk as a WorkerThreadPool group task, or serially without a pool.
+	void _run_chunk_tasks(const StringName &p_method, const String &p_task_name);
 	void _initialize_hover_previews();
 	// Gets the world position of a specific local corner coordinate in a chunk.
 	Vector3 _get_corner_world_pos(const MPChunk &p_chunk, int lx, int ly, int lz) const;
@@ -174,6 +209,8 @@ public:
 	void initialize_grid(int p_chunks_x, int p_chunks_y, int p_chunks_z, int p_chunk_size_x, int p_chunk_size_y, int p_chunk_size_z, bool p_refresh = true);
 	// Refreshes the grid by spawning marching prisms and debug spheres.
 	void refresh_grid();
+	// Phase timings of the last refresh_grid in microseconds (hash, build, commit) plus the chunk count.
+	Dictionary get_refresh_timings() const;
 	void modify_corner(const Vector3i &p_grid_pos, bool p_active);
 	bool is_corner_active(const Vector3i &p_grid_pos) const;
 	void save_grid(const String &p_path);
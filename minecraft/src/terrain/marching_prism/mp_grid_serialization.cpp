@@ -8,35 +8,74 @@
 #include "mp_grid.h"
 #include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <cstring>
 
 namespace godot {
 
-// Saves the entire grid data to a binary file at the specified path.
+// Saves the grid as a region file, one compressed payload per chunk.
+// Saving over the file the grid came from only rewrites chunks edited since they were last written.
 void MPGrid::save_grid(const String &p_path) {
-	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
-	if (file.is_null()) {
-		UtilityFunctions::print("MPGrid: Failed to write ", p_path);
-		return;
+	bool fresh = !region.matches(p_path, grid_size, chunk_size);
+	if (fresh) {
+		if (!region.create(p_path, 0x50524953, grid_size, chunk_size, static_cast<uint32_t>(chunks.size()))) {
+			UtilityFunctions::print("MPGrid: Failed to write ", p_path);
+			return;
+		}
 	}
 
-	file->store_32(0x50524953); // Magic: 'PRIS'
-	file->store_32(grid_size.x);
-	file->store_32(grid_size.y);
-	file->store_32(grid_size.z);
-	file->store_32(chunk_size.x);
-	file->store_32(chunk_size.y);
-	file->store_32(chunk_size.z);
-
-	for (const MPChunk &chunk : chunks) {
-		file->store_32(chunk.corner_states.size());
-		for (uint8_t byte : chunk.corner_states) {
-			file->store_8(byte);
+	for (size_t i = 0; i < chunks.size(); i++) {
+		MPChunk &chunk = chunks[i];
+		if (!fresh && !chunk.save_dirty) {
+			continue;
+		}
+		const std::vector<uint8_t> &states = chunk.corner_states;
+		PackedByteArray payload;
+		payload.resize(static_cast<int64_t>(states.size()));
+		if (!states.empty()) {
+			memcpy(payload.ptrw(), states.data(), states.size());
+		}
+		if (region.write_chunk(static_cast<uint32_t>(i), payload)) {
+			chunk.save_dirty = false;
 		}
 	}
 }
 
-// Loads the entire grid data from a binary file at the specified path.
+// Loads a region file, or the legacy 'PRIS' single-stream file, from the specified path.
 void MPGrid::load_grid(const String &p_path) {
+	if (RegionFile::is_region_file(p_path)) {
+		if (!region.open(p_path, 0x50524953)) {
+			UtilityFunctions::print("MPGrid: Invalid region file");
+			return;
+		}
+
+		Vector3i gs = region.get_grid_size();
+		Vector3i cs = region.get_chunk_size();
+		initialize_grid(gs.x, gs.y, gs.z, cs.x, cs.y, cs.z, false);
+		if (region.get_chunk_count() != chunks.size()) {
+			UtilityFunctions::print("MPGrid: Chunk count mismatch");
+			region.close();
+			return;
+		}
+
+		for (size_t i = 0; i < chunks.size(); i++) {
+			if (!region.has_chunk(static_cast<uint32_t>(i))) {
+				continue;
+			}
+			// initialize_grid sized corner_states to one bit per corner; anything else keeps the initial boundaries
+			PackedByteArray payload = region.read_chunk(static_cast<uint32_t>(i));
+			if (static_cast<size_t>(payload.size()) != chunks[i].corner_states.size()) {
+				UtilityFunctions::print("MPGrid: Chunk ", static_cast<int>(i), " has the wrong size, keeping its initial state");
+				continue;
+			}
+			chunks[i].corner_states.assign(payload.ptr(), payload.ptr() + payload.size());
+			chunks[i].save_dirty = false;
+		}
+
+		refresh_grid();
+		return;
+	}
+
+	region.close();
 	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
 	if (file.is_null()) {
 		UtilityFunctions::print("MPGrid: Failed to read ", p_path);
@@ -0,0 +1,198 @@
+#include "utils/encoding/region_file.h"
+#include <godot_cpp/variant/utility_functions.hpp>
+
+namespace godot {
+
+namespace {
+
+constexpr uint64_t HEADER_SIZE = 10 * sizeof(uint32_t);
+constexpr uint64_t ENTRY_SIZE = 5 * sizeof(uint32_t);
+
+// Worst case over the grid payloads: SNChunk::serialize_quantized writes two bit maps of at most a byte per corner,
+// up to two delta bytes per corner and an 11-byte header; MC and MP write at most a byte per corner.
+constexpr uint64_t MAX_BYTES_PER_CORNER = 4;
+constexpr uint64_t MAX_PAYLOAD_HEADER = 16;
+
+uint32_t hash_bytes(const PackedByteArray &p_data) {
+	uint32_t hash = 2166136261u;
+	const uint8_t *ptr = p_data.ptr();
+	for (int64_t i = 0; i < p_data.size(); i++) {
+		hash = (hash ^ ptr[i]) * 16777619u;
+	}
+	return hash;
+}
+
+} // namespace
+
+bool RegionFile::is_region_file(const String &p_path) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	if (f.is_null() || f->get_length() < HEADER_SIZE) {
+		return false;
+	}
+	return f->get_32() == MAGIC;
+}
+
+bool RegionFile::create(const String &p_path, uint32_t p_grid_magic, const Vector3i &p_grid_size, const Vector3i &p_chunk_size, uint32_t p_chunk_count) {
+	close();
+
+	file = FileAccess::open(p_path, FileAccess::WRITE_READ);
+	if (file.is_null()) {
+		return false;
+	}
+
+	path = p_path;
+	grid_magic = p_grid_magic;
+	grid_size = p_grid_size;
+	chunk_size = p_chunk_size;
+	entries.assign(p_chunk_count, Entry());
+
+	file->store_32(MAGIC);
+	file->store_32(VERSION);
+	file->store_32(grid_magic);
+	file->store_32(grid_size.x);
+	file->store_32(grid_size.y);
+	file->store_32(grid_size.z);
+	file->store_32(chunk_size.x);
+	file->store_32(chunk_size.y);
+	file->store_32(chunk_size.z);
+	file->store_32(p_chunk_count);
+
+	// Reserve the whole table up front so payloads always start after it
+	for (uint32_t i = 0; i < p_chunk_count; i++) {
+		for (int k = 0; k < 5; k++) {
+			file->store_32(0);
+		}
+	}
+	return true;
+}
+
+bool RegionFile::open(const String &p_path, uint32_t p_grid_magic) {
+	close();
+
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ_WRITE);
+	if (f.is_null() || f->get_length() < HEADER_SIZE) {
+		return false;
+	}
+	if (f->get_32() != MAGIC || f->get_32() != VERSION || f->get_32() != p_grid_magic) {
+		return false;
+	}
+
+	Vector3i gs, cs;
+	gs.x = f->get_32();
+	gs.y = f->get_32();
+	gs.z = f->get_32();
+	cs.x = f->get_32();
+	cs.y = f->get_32();
+	cs.z = f->get_32();
+	uint32_t count = f->get_32();
+	if (f->get_length() < HEADER_SIZE + ENTRY_SIZE * count) {
+		return false;
+	}
+
+	entries.resize(count);
+	for (Entry &entry : entries) {
+		entry.offset = f->get_32();
+		entry.capacity = f->get_32();
+		entry.stored_size = f->get_32();
+		entry.raw_size = f->get_32();
+		entry.raw_hash = f->get_32();
+	}
+
+	file = f;
+	path = p_path;
+	grid_magic = p_grid_magic;
+	grid_size = gs;
+	chunk_size = cs;
+	return true;
+}
+
+void RegionFile::close() {
+	if (file.is_valid()) {
+		file->close();
+		file.unref();
+	}
+	path = String();
+	entries.clear();
+}
+
+bool RegionFile::matches(const String &p_path, const Vector3i &p_grid_size, const Vector3i &p_chunk_size) const {
+	return is_open() && path == p_path && grid_size == p_grid_size && chunk_size == p_chunk_size;
+}
+
+bool RegionFile::has_chunk(uint32_t p_index) const {
+	return p_index < entries.size() && entries[p_index].offset != 0;
+}
+
+PackedByteArray RegionFile::read_chunk(uint32_t p_index) const {
+	if (!is_open() || !has_chunk(p_index)) {
+		return PackedByteArray();
+	}
+
+	const Entry &entry = entries[p_index];
+	if (entry.raw_size == 0) {
+		return PackedByteArray();
+	}
+	if (entry.raw_size > _max_raw_size() || static_cast<uint64_t>(entry.offset) + entry.stored_size > file->get_length()) {
+		UtilityFunctions::print("RegionFile: Chunk ", p_index, " in ", path, " is corrupt");
+		return PackedByteArray();
+	}
+
+	file->seek(entry.offset);
+	PackedByteArray stored = file->get_buffer(entry.stored_size);
+	PackedByteArray raw = stored.decompress(entry.raw_size, FileAccess::COMPRESSION_ZSTD);
+	if (raw.size() != static_cast<int64_t>(entry.raw_size) || hash_bytes(raw) != entry.raw_hash) {
+		UtilityFunctions::print("RegionFile: Chunk ", p_index, " in ", path, " is corrupt");
+		return PackedByteArray();
+	}
+	return raw;
+}
+
+bool RegionFile::write_chunk(uint32_t p_index, const PackedByteArray &p_raw) {
+	if (!is_open() || p_index >= entries.size()) {
+		return false;
+	}
+
+	Entry &entry = entries[p_index];
+	PackedByteArray stored = p_raw.is_empty() ? PackedByteArray() : p_raw.compress(FileAccess::COMPRESSION_ZSTD);
+	uint32_t stored_size = static_cast<uint32_t>(stored.size());
+
+	if (entry.offset == 0 || entry.capacity < stored_size) {
+		entry.offset = static_cast<uint32_t>(file->get_length());
+		entry.capacity = stored_size;
+	}
+	file->seek(entry.offset);
+	file->store_buffer(stored);
+
+	entry.stored_size = stored_size;
+	entry.raw_size = static_cast<uint32_t>(p_raw.size());
+	entry.raw_hash = hash_bytes(p_raw);
+	_store_entry(p_index);
+	return true;
+}
+
+uint64_t RegionFile::_max_raw_size() const {
+	if (chunk_size.x < 0 || chunk_size.y < 0 || chunk_size.z < 0) {
+		return 0;
+	}
+	// raw_size is 32-bit, so stop multiplying once the bound can't limit it any further
+	uint64_t corners = 1;
+	for (int axis = 0; axis < 3; axis++) {
+		corners *= static_cast<uint64_t>(chunk_size[axis]) + 1;
+		if (corners > UINT32_MAX) {
+			return UINT32_MAX;
+		}
+	}
+	return corners * MAX_BYTES_PER_CORNER + MAX_PAYLOAD_HEADER;
+}
+
+void RegionFile::_store_entry(uint32_t p_index) {
+	const Entry &entry = entries[p_index];
+	file->seek(HEADER_SIZE + ENTRY_SIZE * p_index);
+	file->store_32(entry.offset);
+	file->store_32(entry.capacity);
+	file->store_32(entry.stored_size);
+	file->store_32(entry.raw_size);
+	file->store_32(entry.raw_hash);
+}
+
+} // namespace godot
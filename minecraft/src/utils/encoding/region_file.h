@@ -0,0 +1,88 @@
+#ifndef REGION_FILE_H
+#define REGION_FILE_H
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/ref.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/vector3i.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+/**
+ * Random-access chunk store shared by the voxel grids.
+ * Layout (little-endian):
+ * [magic 'RGNF'][version][grid magic][grid_size xyz][chunk_size xyz][chunk count]
+ * [entry 0] ... [entry n-1]       entry = offset, capacity, stored size, raw size, raw hash
+ * [chunk payloads]                each compressed on its own, in any order
+ *
+ * Only the header and entry table are read on open; chunk payloads are read
+ * and written individually, so a grid can page chunks in and out as needed.
+ * A rewritten chunk reuses its slot when the new payload fits, otherwise it is
+ * appended and the old slot is abandoned until the file is saved fresh.
+ */
+class RegionFile {
+public:
+	static constexpr uint32_t MAGIC = 0x52474E46; // 'RGNF'
+	static constexpr uint32_t VERSION = 1;
+
+private:
+	struct Entry {
+		uint32_t offset = 0; // Payload position in the file, 0 when the chunk was never written
+		uint32_t capacity = 0; // Bytes reserved for the payload at offset
+		uint32_t stored_size = 0; // Compressed payload size
+		uint32_t raw_size = 0; // Payload size before compression
+		uint32_t raw_hash = 0; // FNV-1a of the uncompressed payload, checked when the chunk is read back
+	};
+
+	Ref<FileAccess> file;
+	String path;
+	uint32_t grid_magic = 0;
+	Vector3i grid_size;
+	Vector3i chunk_size;
+	std::vector<Entry> entries;
+
+	// Rewrites one entry of the on-disk table.
+	void _store_entry(uint32_t p_index);
+
+	// Largest uncompressed payload a chunk of chunk_size can have, so a corrupt entry can't request a huge buffer.
+	uint64_t _max_raw_size() const;
+
+public:
+	// True when the file at p_path starts with the region magic.
+	static bool is_region_file(const String &p_path);
+
+	// Creates (or truncates) p_path with an empty table for p_chunk_count chunks.
+	bool create(const String &p_path, uint32_t p_grid_magic, const Vector3i &p_grid_size, const Vector3i &p_chunk_size, uint32_t p_chunk_count);
+
+	// Opens an existing region file for reading and in-place updates; fails if it belongs to another grid type.
+	bool open(const String &p_path, uint32_t p_grid_magic);
+
+	void close();
+
+	bool is_open() const { return file.is_valid(); }
+	const String &get_path() const { return path; }
+	Vector3i get_grid_size() const { return grid_size; }
+	Vector3i get_chunk_size() const { return chunk_size; }
+	uint32_t get_chunk_count() const { return static_cast<uint32_t>(entries.size()); }
+
+	// True when the file was created for this grid layout.
+	bool matches(const String &p_path, const Vector3i &p_grid_size, const Vector3i &p_chunk_size) const;
+
+	bool has_chunk(uint32_t p_index) const;
+
+	// Reads and decompresses one chunk payload; empty when the chunk was never written or fails its size or hash check.
+	PackedByteArray read_chunk(uint32_t p_index) const;
+
+	/*
+	 * Compresses and stores one chunk payload.
+	 * Always writes; callers track which chunks changed since they were last written.
+	 */
+	bool write_chunk(uint32_t p_index, const PackedByteArray &p_raw);
+};
+
+} // namespace godot
+
+#endif // REGION_FILE_H
@@ -1,7 +1,92 @@
 #include "utils/encoding/rle.h"
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace godot {
 
+namespace {
+
+// Longest run a single token can hold (14-bit length).
+constexpr uint32_t MAX_RUN = 16383;
+
+inline int lowest_bit(uint64_t p_bits) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, p_bits);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(p_bits);
+#endif
+}
+
+// Returns the 64 bits starting at p_bit, zero-padded past the end of the data.
+inline uint64_t load_bits(const uint8_t *p_data, size_t p_size, size_t p_bit) {
+	size_t byte = p_bit >> 3;
+	unsigned shift = p_bit & 7;
+
+	uint8_t window[9] = { 0 };
+	if (byte + 9 <= p_size) {
+		memcpy(window, p_data + byte, 9);
+	} else if (byte < p_size) {
+		memcpy(window, p_data + byte, p_size - byte);
+	}
+
+	uint64_t lo = 0;
+	for (int i = 7; i >= 0; i--) {
+		lo = (lo << 8) | window[i];
+	}
+	uint64_t bits = lo >> shift;
+	if (shift) {
+		bits |= uint64_t(window[8]) << (64 - shift);
+	}
+	return bits;
+}
+
+// Number of consecutive bits equal to p_state starting at p_bit, capped at p_limit.
+inline uint32_t scan_run(const uint8_t *p_data, size_t p_size, size_t p_bit, bool p_state, uint32_t p_limit) {
+	uint64_t flip = p_state ? ~uint64_t(0) : 0;
+	uint32_t length = 0;
+	while (length < p_limit) {
+		uint64_t diff = load_bits(p_data, p_size, p_bit + length) ^ flip;
+		if (diff) {
+			length += static_cast<uint32_t>(lowest_bit(diff));
+			break;
+		}
+		length += 64;
+	}
+	return length < p_limit ? length : p_limit;
+}
+
+// Sets or clears p_count bits starting at p_bit, using whole-byte fills for the aligned middle.
+inline void fill_bits(uint8_t *r_bits, size_t p_bit, size_t p_count, bool p_state) {
+	size_t end = p_bit + p_count;
+
+	// Leading partial byte
+	while (p_bit < end && (p_bit & 7)) {
+		uint8_t mask = static_cast<uint8_t>(1 << (p_bit & 7));
+		r_bits[p_bit >> 3] = p_state ? (r_bits[p_bit >> 3] | mask) : (r_bits[p_bit >> 3] & ~mask);
+		p_bit++;
+	}
+
+	size_t whole = (end - p_bit) >> 3;
+	if (whole) {
+		memset(r_bits + (p_bit >> 3), p_state ? 0xFF : 0x00, whole);
+		p_bit += whole << 3;
+	}
+
+	// Trailing partial byte
+	while (p_bit < end) {
+		uint8_t mask = static_cast<uint8_t>(1 << (p_bit & 7));
+		r_bits[p_bit >> 3] = p_state ? (r_bits[p_bit >> 3] | mask) : (r_bits[p_bit >> 3] & ~mask);
+		p_bit++;
+	}
+}
+
+} // namespace
+
 PackedByteArray RLE::encode_bit_rle(int p_num_bits, const BitGetter &p_getter) {
 	PackedByteArray output;
 	if (p_num_bits == 0) {
@@ -75,4 +160,63 @@ void RLE::decode_bit_rle(const PackedByteArray &p_data, int p_num_bits, const Bi
 	}
 }
 
+PackedByteArray RLE::encode_bit_rle(const uint8_t *p_bits, int p_num_bits) {
+	PackedByteArray output;
+	if (p_num_bits <= 0) {
+		return output;
+	}
+
+	// Worst case is one short token per bit
+	output.resize(p_num_bits + 2);
+	uint8_t *out = output.ptrw();
+	size_t written = 0;
+
+	size_t num_bits = static_cast<size_t>(p_num_bits);
+	size_t size = p_bits ? (num_bits + 7) / 8 : 0;
+	size_t pos = 0;
+	while (pos < num_bits) {
+		bool state = p_bits && (p_bits[pos >> 3] & (1 << (pos & 7)));
+		uint32_t limit = static_cast<uint32_t>(num_bits - pos < MAX_RUN ? num_bits - pos : MAX_RUN);
+		uint32_t length = p_bits ? scan_run(p_bits, size, pos, state, limit) : limit;
+
+		if (length < 64) {
+			out[written++] = static_cast<uint8_t>((state ? 0x80 : 0x00) | length);
+		} else {
+			out[written++] = static_cast<uint8_t>((state ? 0x80 : 0x00) | 0x40 | (length >> 8));
+			out[written++] = static_cast<uint8_t>(length & 0xFF);
+		}
+		pos += length;
+	}
+
+	output.resize(static_cast<int64_t>(written));
+	return output;
+}
+
+void RLE::decode_bit_rle(const PackedByteArray &p_data, int p_num_bits, uint8_t *r_bits) {
+	const uint8_t *data = p_data.ptr();
+	int64_t data_size = p_data.size();
+	size_t num_bits = p_num_bits > 0 ? static_cast<size_t>(p_num_bits) : 0;
+	size_t pos = 0;
+	int64_t byte_index = 0;
+
+	while (byte_index < data_size && pos < num_bits) {
+		uint8_t b1 = data[byte_index++];
+		bool state = (b1 & 0x80) != 0;
+		size_t length = b1 & 0x3F;
+
+		if (b1 & 0x40) {
+			if (byte_index >= data_size) {
+				break;
+			}
+			length = (length << 8) | data[byte_index++];
+		}
+
+		if (length > num_bits - pos) {
+			length = num_bits - pos;
+		}
+		fill_bits(r_bits, pos, length, state);
+		pos += length;
+	}
+}
+
 } // namespace godot
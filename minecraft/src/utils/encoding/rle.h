@@ -2,6 +2,7 @@
 #define MC_RLE_H
 
 #include <godot_cpp/variant/packed_byte_array.hpp>
+#include <cstdint>
 #include <functional>
 
 namespace godot {
@@ -23,6 +24,20 @@ public:
 	 * Decodes a bitstream from the RLE format.
 	 */
 	static void decode_bit_rle(const PackedByteArray &p_data, int p_num_bits, const BitSetter &p_setter);
+
+	/**
+	 * Encodes p_num_bits bits packed little-endian in p_bits (bit i in byte i / 8, bit i % 8).
+	 * Output is byte-identical to the callback encoder. Runs are found 64 bits at a time
+	 * by XOR-ing each window against the run state and counting trailing zeros, and the
+	 * output buffer is sized once up front. A null p_bits encodes all zeros.
+	 */
+	static PackedByteArray encode_bit_rle(const uint8_t *p_bits, int p_num_bits);
+
+	/**
+	 * Decodes into r_bits (at least (p_num_bits + 7) / 8 bytes, same packing as above).
+	 * Runs are written as whole bytes where possible; bits past the decoded data are left untouched.
+	 */
+	static void decode_bit_rle(const PackedByteArray &p_data, int p_num_bits, uint8_t *r_bits);
 };
 
 } // namespace godot
@@ -0,0 +1,501 @@
+#include "quadtree.h"
+#include "linear_quadtree.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+#include <thread>
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Seconds elapsed since start
+static double secondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Sample
+{
+    double x, y;
+};
+
+// Copies the samples into points whose payload is the sample index
+template <typename Coord = double>
+static std::vector<Point<int, Coord>> makePoints(const std::vector<Sample> &samples)
+{
+    std::vector<Point<int, Coord>> points;
+    points.reserve(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        points.emplace_back(samples[i].x, samples[i].y, static_cast<int>(i));
+    }
+    return points;
+}
+
+// Counts the points inside a range by scanning every sample, used to check the trees
+static size_t bruteForceCount(const std::vector<Sample> &samples, const BoundingBox &range)
+{
+    size_t count = 0;
+    for (const auto &s : samples)
+    {
+        if (range.contains(s.x, s.y))
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Squared distance to the closest sample, used to check the trees
+static double bruteForceNearest(const std::vector<Sample> &samples, const Sample &probe)
+{
+    double best = std::numeric_limits<double>::max();
+    for (const auto &s : samples)
+    {
+        double dx = s.x - probe.x;
+        double dy = s.y - probe.y;
+        best = std::min(best, dx * dx + dy * dy);
+    }
+    return best;
+}
+
+// Sorted squared distances of the k closest samples, used to check k-nearest queries
+static std::vector<double> bruteForceKNearest(const std::vector<Sample> &samples, const Sample &probe, size_t k)
+{
+    std::vector<double> distances;
+    distances.reserve(samples.size());
+    for (const auto &s : samples)
+    {
+        double dx = s.x - probe.x;
+        double dy = s.y - probe.y;
+        distances.push_back(dx * dx + dy * dy);
+    }
+    k = std::min(k, distances.size());
+    std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+    distances.resize(k);
+    return distances;
+}
+
+// Counts the samples within radius of a probe, used to check radius queries
+static size_t bruteForceRadius(const std::vector<Sample> &samples, const Sample &probe, double radius)
+{
+    size_t count = 0;
+    for (const auto &s : samples)
+    {
+        double dx = s.x - probe.x;
+        double dy = s.y - probe.y;
+        if (dx * dx + dy * dy <= radius * radius)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+struct QueryTimes
+{
+    double range;    // Range queries per second
+    double visit;    // Range queries per second through a counting visitor, 0 when not measured
+    double nearest;  // Nearest-neighbour queries per second
+    double kNearest; // k-nearest queries per second, 0 when not measured
+    double radius;   // Radius queries per second, 0 when not measured
+    double found;    // Average points per range query
+    size_t total;    // Points returned by all range queries
+    bool match;      // Results agree with the brute-force scans
+};
+
+// Times and checks the query API shared by QuadTree and LinearQuadTree
+template <typename Tree>
+static QueryTimes timeQueries(const Tree &tree, const std::vector<Sample> &samples,
+                              const std::vector<BoundingBox> &ranges, const std::vector<Sample> &probes)
+{
+    const size_t numChecks = 8;
+    QueryTimes times = {};
+
+    auto start = Clock::now();
+    size_t found = 0;
+    for (const auto &range : ranges)
+    {
+        found += tree.queryRange(range).size();
+    }
+    times.range = ranges.size() / secondsSince(start);
+    times.found = static_cast<double>(found) / ranges.size();
+    times.total = found;
+
+    start = Clock::now();
+    typename Tree::PointType nearest;
+    for (const auto &probe : probes)
+    {
+        tree.findNearest(probe.x, probe.y, nearest);
+    }
+    times.nearest = probes.size() / secondsSince(start);
+
+    times.match = tree.size() == samples.size();
+    for (size_t i = 0; i < numChecks; ++i)
+    {
+        times.match &= tree.queryRange(ranges[i]).size() == bruteForceCount(samples, ranges[i]);
+
+        tree.findNearest(probes[i].x, probes[i].y, nearest);
+        double dx = nearest.x - probes[i].x;
+        double dy = nearest.y - probes[i].y;
+        times.match &= dx * dx + dy * dy == bruteForceNearest(samples, probes[i]);
+    }
+    return times;
+}
+
+// Times and checks the queries only QuadTree offers: visitor range, k-nearest and radius
+template <typename Coord>
+static void timeQuadTreeQueries(const QuadTree<int, Coord> &tree, const std::vector<Sample> &samples,
+                                const std::vector<BoundingBox> &ranges, const std::vector<Sample> &probes,
+                                size_t k, double radius, QueryTimes &times)
+{
+    const size_t numChecks = 8;
+
+    auto start = Clock::now();
+    size_t visited = 0;
+    for (const auto &range : ranges)
+    {
+        tree.queryRange(range, [&visited](const Point<int, Coord> &) {
+            ++visited;
+        });
+    }
+    times.visit = ranges.size() / secondsSince(start);
+    times.match &= visited == times.total;
+
+    start = Clock::now();
+    std::vector<Point<int, Coord>> neighbours;
+    for (const auto &probe : probes)
+    {
+        tree.findKNearest(probe.x, probe.y, k, neighbours);
+    }
+    times.kNearest = probes.size() / secondsSince(start);
+
+    start = Clock::now();
+    for (const auto &probe : probes)
+    {
+        tree.queryRadius(probe.x, probe.y, radius);
+    }
+    times.radius = probes.size() / secondsSince(start);
+
+    for (size_t i = 0; i < numChecks; ++i)
+    {
+        std::vector<double> expected = bruteForceKNearest(samples, probes[i], k);
+        tree.findKNearest(probes[i].x, probes[i].y, k, neighbours);
+        times.match &= neighbours.size() == expected.size();
+        for (size_t j = 0; times.match && j < expected.size(); ++j)
+        {
+            double dx = neighbours[j].x - probes[i].x;
+            double dy = neighbours[j].y - probes[i].y;
+            times.match &= dx * dx + dy * dy == expected[j];
+        }
+
+        times.match &= tree.queryRadius(probes[i].x, probes[i].y, radius).size() ==
+                       bruteForceRadius(samples, probes[i], radius);
+    }
+}
+
+// Prints a rate in thousands per second, or "-" when it was not measured
+static void printRate(double rate, int width)
+{
+    if (rate > 0)
+    {
+        std::cout << std::setw(width) << rate / 1e3;
+    }
+    else
+    {
+        std::cout << std::setw(width) << "-";
+    }
+}
+
+static void printRow(size_t numPoints, const char *name, const double *buildRates, size_t numBuildRates,
+                     const QueryTimes &times)
+{
+    std::cout << std::setw(9) << numPoints << "  " << std::left << std::setw(8) << name << std::right
+              << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        if (i < numBuildRates && buildRates[i] > 0)
+        {
+            std::cout << std::setw(9) << buildRates[i];
+        }
+        else
+        {
+            std::cout << std::setw(9) << "-";
+        }
+    }
+    std::cout << " | ";
+    printRate(times.range, 9);
+    printRate(times.visit, 10);
+    printRate(times.nearest, 10);
+    printRate(times.kNearest, 10);
+    printRate(times.radius, 10);
+    std::cout << " (" << std::setprecision(1) << times.found << " pts/q)"
+              << " | " << (times.match ? "ok" : "MISMATCH") << std::endl;
+}
+
+// Times every way of filling a QuadTree plus its queries and prints one row
+template <typename Coord>
+static void benchmarkQuadTree(const char *name, const std::vector<Sample> &samples, const BoundingBox &world,
+                              const std::vector<BoundingBox> &ranges, const std::vector<Sample> &probes)
+{
+    const size_t numPoints = samples.size();
+    QuadTree<int, Coord> tree(world, 8, 15);
+
+    // insert, clear() + insert, build, parallel build; input vectors are not timed
+    double rates[4];
+    auto start = Clock::now();
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        tree.insert(samples[i].x, samples[i].y, static_cast<int>(i));
+    }
+    rates[0] = numPoints / secondsSince(start) / 1e6;
+
+    start = Clock::now();
+    tree.clear();
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        tree.insert(samples[i].x, samples[i].y, static_cast<int>(i));
+    }
+    rates[1] = numPoints / secondsSince(start) / 1e6;
+
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+        std::vector<Point<int, Coord>> points = makePoints<Coord>(samples);
+        start = Clock::now();
+        tree.build(std::move(points), parallel != 0);
+        rates[2 + parallel] = numPoints / secondsSince(start) / 1e6;
+    }
+    // Radius and k chosen to return about as many points as the range queries
+    const size_t k = 8;
+    double radius = world.width * std::sqrt(64.0 / (3.14159265358979 * static_cast<double>(numPoints)));
+    QueryTimes times = timeQueries(tree, samples, ranges, probes);
+    timeQuadTreeQueries(tree, samples, ranges, probes, k, radius, times);
+    printRow(numPoints, name, rates, 4, times);
+}
+
+static void benchmarkSize(size_t numPoints, std::mt19937 &gen)
+{
+    const double worldSize = 1000.0;
+    const size_t numQueries = 10000;
+
+    std::uniform_real_distribution<> dis(0.0, worldSize);
+    std::vector<Sample> samples(numPoints);
+    for (auto &s : samples)
+    {
+        s.x = dis(gen);
+        s.y = dis(gen);
+    }
+
+    // Query boxes sized to hold about 64 points on average at every tree size
+    double side = worldSize * std::sqrt(64.0 / static_cast<double>(numPoints));
+    std::uniform_real_distribution<> corner(0.0, worldSize - side);
+    std::vector<BoundingBox> ranges;
+    std::vector<Sample> probes(numQueries);
+    ranges.reserve(numQueries);
+    for (size_t i = 0; i < numQueries; ++i)
+    {
+        ranges.emplace_back(corner(gen), corner(gen), side, side);
+        probes[i].x = dis(gen);
+        probes[i].y = dis(gen);
+    }
+
+    const BoundingBox world(0, 0, worldSize, worldSize);
+    benchmarkQuadTree<double>("QuadTree", samples, world, ranges, probes);
+
+    // Float coordinates; checked against samples rounded the same way
+    std::vector<Sample> floatSamples(samples);
+    for (auto &s : floatSamples)
+    {
+        s.x = static_cast<float>(s.x);
+        s.y = static_cast<float>(s.y);
+    }
+    benchmarkQuadTree<float>("Float", floatSamples, world, ranges, probes);
+
+    LinearQuadTree<int> linear(world, 8, 15);
+    std::vector<Point<int>> points = makePoints(samples);
+    auto start = Clock::now();
+    linear.build(std::move(points));
+    double linearRates[3] = {0, 0, numPoints / secondsSince(start) / 1e6};
+    printRow(numPoints, "Linear", linearRates, 3, timeQueries(linear, samples, ranges, probes));
+}
+
+// Per-frame cost of tracking moving objects: update() + compact() against rebuilding the tree
+static void benchmarkMoving(size_t numPoints, std::mt19937 &gen)
+{
+    const double worldSize = 1000.0;
+    const size_t numFrames = 20;
+    const double speed = 1.0; // Largest step per frame, about a tenth of a leaf at this density
+    const BoundingBox world(0, 0, worldSize, worldSize);
+
+    std::uniform_real_distribution<> dis(0.0, worldSize);
+    std::uniform_real_distribution<> step(-speed, speed);
+    std::vector<Sample> initial(numPoints);
+    for (auto &s : initial)
+    {
+        s.x = dis(gen);
+        s.y = dis(gen);
+    }
+
+    std::cout << std::endl
+              << "Moving objects: " << numPoints << " points, " << numFrames << " frames, steps up to "
+              << speed << " units" << std::endl;
+    std::cout << "   moving    update ms  reinsert ms     build ms" << std::endl;
+
+    const double fractions[] = {0.01, 0.1, 1.0};
+    for (double fraction : fractions)
+    {
+        std::vector<Sample> samples = initial;
+        QuadTree<int> tree(world, 8, 15);
+        std::vector<QuadTree<int>::Handle> handles(numPoints);
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            handles[i] = tree.insert(samples[i].x, samples[i].y, static_cast<int>(i));
+        }
+
+        // Movers are the first objects; rebuilds pay for every object regardless
+        size_t numMoving = static_cast<size_t>(numPoints * fraction);
+        double updateTime = 0, reinsertTime = 0, buildTime = 0;
+        QuadTree<int> rebuilt(world, 8, 15);
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            for (size_t i = 0; i < numMoving; ++i)
+            {
+                samples[i].x = std::min(std::max(samples[i].x + step(gen), 0.0), worldSize);
+                samples[i].y = std::min(std::max(samples[i].y + step(gen), 0.0), worldSize);
+            }
+
+            auto start = Clock::now();
+            for (size_t i = 0; i < numMoving; ++i)
+            {
+                tree.update(handles[i], samples[i].x, samples[i].y);
+            }
+            tree.compact();
+            updateTime += secondsSince(start);
+
+            start = Clock::now();
+            rebuilt.clear();
+            for (size_t i = 0; i < numPoints; ++i)
+            {
+                rebuilt.insert(samples[i].x, samples[i].y, static_cast<int>(i));
+            }
+            reinsertTime += secondsSince(start);
+
+            std::vector<Point<int>> points = makePoints(samples);
+            start = Clock::now();
+            rebuilt.build(std::move(points));
+            buildTime += secondsSince(start);
+        }
+
+        bool match = tree.size() == numPoints;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            BoundingBox range(dis(gen) * 0.9, dis(gen) * 0.9, worldSize / 10, worldSize / 10);
+            match &= tree.queryRange(range).size() == bruteForceCount(samples, range);
+        }
+
+        std::cout << std::setw(8) << std::setprecision(0) << fraction * 100 << "%" << std::setprecision(3)
+                  << std::setw(13) << updateTime * 1e3 / numFrames << std::setw(13) << reinsertTime * 1e3 / numFrames
+                  << std::setw(13) << buildTime * 1e3 / numFrames << " | " << (match ? "ok" : "MISMATCH") << std::endl;
+    }
+}
+
+// Batch query throughput on 1 to maxThreads threads, checked against the single-thread results
+static void benchmarkBatch(size_t numPoints, size_t maxThreads, std::mt19937 &gen)
+{
+    const double worldSize = 1000.0;
+    const size_t numQueries = 100000;
+    const size_t k = 8;
+
+    std::uniform_real_distribution<> dis(0.0, worldSize);
+    std::vector<Sample> samples(numPoints);
+    for (auto &s : samples)
+    {
+        s.x = dis(gen);
+        s.y = dis(gen);
+    }
+    QuadTree<int> tree(BoundingBox(0, 0, worldSize, worldSize), 8, 15);
+    tree.build(makePoints(samples));
+
+    double side = worldSize * std::sqrt(64.0 / static_cast<double>(numPoints));
+    std::uniform_real_distribution<> corner(0.0, worldSize - side);
+    std::vector<BoundingBox> ranges;
+    std::vector<QueryPoint> probes(numQueries);
+    ranges.reserve(numQueries);
+    for (size_t i = 0; i < numQueries; ++i)
+    {
+        ranges.emplace_back(corner(gen), corner(gen), side, side);
+        probes[i] = QueryPoint{dis(gen), dis(gen)};
+    }
+
+    std::cout << std::endl
+              << "Batch queries: " << numPoints << " points, " << numQueries << " queries per batch, k = " << k
+              << std::endl;
+    std::cout << "  threads  range Kq/s  speedup  k-near Kq/s  speedup" << std::endl;
+
+    QuadTreeBatch<int> rangeResult, nearResult;
+    std::vector<size_t> rangeOffsets, nearOffsets;
+    double baseRange = 0, baseNear = 0;
+    // Doubling thread counts, always ending at maxThreads
+    for (size_t threads = 1;; threads = std::min(threads * 2, maxThreads))
+    {
+        ThreadPool pool(threads);
+
+        // First pass warms the result buffers, second is timed
+        tree.queryRangeBatch(ranges.data(), ranges.size(), rangeResult, pool);
+        auto start = Clock::now();
+        tree.queryRangeBatch(ranges.data(), ranges.size(), rangeResult, pool);
+        double rangeRate = numQueries / secondsSince(start);
+
+        tree.findKNearestBatch(probes.data(), probes.size(), k, nearResult, pool);
+        start = Clock::now();
+        tree.findKNearestBatch(probes.data(), probes.size(), k, nearResult, pool);
+        double nearRate = numQueries / secondsSince(start);
+
+        if (threads == 1)
+        {
+            baseRange = rangeRate;
+            baseNear = nearRate;
+            rangeOffsets = rangeResult.offsets;
+            nearOffsets = nearResult.offsets;
+        }
+        bool match = rangeResult.offsets == rangeOffsets && nearResult.offsets == nearOffsets;
+
+        std::cout << std::setw(9) << threads << std::fixed << std::setprecision(2) << std::setw(12)
+                  << rangeRate / 1e3 << std::setw(8) << rangeRate / baseRange << "x" << std::setw(13)
+                  << nearRate / 1e3 << std::setw(8) << nearRate / baseNear << "x"
+                  << " | " << (match ? "ok" : "MISMATCH") << std::endl;
+        if (threads == maxThreads)
+        {
+            break;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // Optional arguments cap the largest tree size (default 10^7) and the batch thread count (default: all)
+    size_t maxPoints = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t maxThreads = argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+                                 : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+    std::cout << "=== QuadTree Benchmark ===" << std::endl;
+    std::cout << "Uniform points in 1000x1000, maxPoints 8, maxDepth 15, 10000 queries of each kind per size, k = 8" << std::endl;
+    std::cout << "Build rates in Mpts/s; parallel build uses " << std::thread::hardware_concurrency() << " threads" << std::endl
+              << std::endl;
+    std::cout << "   points  tree        insert  rebuild    build  par.bld |     range     visit   nearest   k-near    radius (Kq/s)"
+              << std::endl;
+
+    std::mt19937 gen(42);
+    for (size_t numPoints = 10000; numPoints <= maxPoints; numPoints *= 10)
+    {
+        benchmarkSize(numPoints, gen);
+    }
+    benchmarkMoving(std::min<size_t>(maxPoints, 100000), gen);
+    benchmarkBatch(std::min<size_t>(maxPoints, 1000000), std::max<size_t>(maxThreads, 1), gen);
+
+    return 0;
+}
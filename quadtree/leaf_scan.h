@@ -0,0 +1,60 @@
+#ifndef LEAF_SCAN_H
+#define LEAF_SCAN_H
+
+#include <cstdint>
+
+/**
+ * Vectorized tests over the coordinate arrays of one leaf bucket
+ *
+ * Each kernel tests up to LEAF_SCAN_BLOCK points stored as separate x and y
+ * arrays and returns a bit mask with bit i set for point i. float and double
+ * coordinates use AVX2 when the compiler targets it (8 or 4 lanes), SSE2
+ * otherwise (4 or 2 lanes), and a scalar loop on other targets or types.
+ * Kernels may read up to LEAF_SCAN_PADDING elements past count, so callers
+ * keep that much readable slack at the end of their arrays.
+ */
+constexpr uint32_t LEAF_SCAN_BLOCK = 64;
+constexpr uint32_t LEAF_SCAN_PADDING = 8;
+
+/**
+ * A closed query box rounded to the coordinate type
+ *
+ * For float the bounds are rounded inwards, so a stored point passes the
+ * float comparison exactly when it lies inside the double box.
+ */
+template <typename Coord>
+struct LeafScanBox
+{
+    Coord minX, minY, maxX, maxY;
+
+    LeafScanBox(double minX, double minY, double maxX, double maxY);
+};
+
+/**
+ * Bits of the points inside a box
+ */
+template <typename Coord>
+uint64_t leafRangeMask(const Coord *xs, const Coord *ys, uint32_t count, const LeafScanBox<Coord> &box);
+uint64_t leafRangeMask(const float *xs, const float *ys, uint32_t count, const LeafScanBox<float> &box);
+uint64_t leafRangeMask(const double *xs, const double *ys, uint32_t count, const LeafScanBox<double> &box);
+
+/**
+ * Bits of the points whose squared distance to (x, y) may be at most limit
+ *
+ * Distances are computed in double. The limit is widened by a few ulps so
+ * that no point passing the caller's exact scalar test is ever left out,
+ * whether or not the compiler fuses the scalar multiply-adds.
+ */
+template <typename Coord>
+uint64_t leafDistanceMask(const Coord *xs, const Coord *ys, uint32_t count, double x, double y, double limit);
+uint64_t leafDistanceMask(const float *xs, const float *ys, uint32_t count, double x, double y, double limit);
+uint64_t leafDistanceMask(const double *xs, const double *ys, uint32_t count, double x, double y, double limit);
+
+/**
+ * Index of the lowest set bit of a non-zero mask
+ */
+uint32_t lowestBit(uint64_t mask);
+
+#include "leaf_scan.hpp"
+
+#endif // LEAF_SCAN_H
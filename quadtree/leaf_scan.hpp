@@ -0,0 +1,224 @@
+#include "leaf_scan.h"
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LEAF_SCAN_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+inline uint32_t lowestBit(uint64_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(mask));
+#endif
+}
+
+// Mask with the low count bits set
+inline uint64_t leafCountMask(uint32_t count)
+{
+    return count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+}
+
+// Limit widened to absorb rounding differences between vector and scalar distance arithmetic
+inline double leafWidenedLimit(double limit)
+{
+    return limit + limit * (8 * std::numeric_limits<double>::epsilon());
+}
+
+template <typename Coord>
+LeafScanBox<Coord>::LeafScanBox(double minX, double minY, double maxX, double maxY)
+    : minX(static_cast<Coord>(minX)), minY(static_cast<Coord>(minY)),
+      maxX(static_cast<Coord>(maxX)), maxY(static_cast<Coord>(maxY))
+{
+}
+
+template <>
+inline LeafScanBox<float>::LeafScanBox(double minX, double minY, double maxX, double maxY)
+{
+    // Smallest float at or above each lower bound, largest at or below each upper bound
+    auto roundUp = [](double value) {
+        float f = static_cast<float>(value);
+        return static_cast<double>(f) < value ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f;
+    };
+    auto roundDown = [](double value) {
+        float f = static_cast<float>(value);
+        return static_cast<double>(f) > value ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f;
+    };
+    this->minX = roundUp(minX);
+    this->minY = roundUp(minY);
+    this->maxX = roundDown(maxX);
+    this->maxY = roundDown(maxY);
+}
+
+template <typename Coord>
+uint64_t leafRangeMask(const Coord *xs, const Coord *ys, uint32_t count, const LeafScanBox<Coord> &box)
+{
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        bool inside = xs[i] >= box.minX && xs[i] <= box.maxX && ys[i] >= box.minY && ys[i] <= box.maxY;
+        mask |= static_cast<uint64_t>(inside) << i;
+    }
+    return mask;
+}
+
+inline uint64_t leafRangeMask(const float *xs, const float *ys, uint32_t count, const LeafScanBox<float> &box)
+{
+#if defined(__AVX2__)
+    const __m256 minX = _mm256_set1_ps(box.minX), maxX = _mm256_set1_ps(box.maxX);
+    const __m256 minY = _mm256_set1_ps(box.minY), maxY = _mm256_set1_ps(box.maxY);
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < count; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 y = _mm256_loadu_ps(ys + i);
+        __m256 inX = _mm256_and_ps(_mm256_cmp_ps(x, minX, _CMP_GE_OQ), _mm256_cmp_ps(x, maxX, _CMP_LE_OQ));
+        __m256 inY = _mm256_and_ps(_mm256_cmp_ps(y, minY, _CMP_GE_OQ), _mm256_cmp_ps(y, maxY, _CMP_LE_OQ));
+        mask |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_and_ps(inX, inY))) << i;
+    }
+    return mask & leafCountMask(count);
+#elif defined(LEAF_SCAN_SSE2)
+    const __m128 minX = _mm_set1_ps(box.minX), maxX = _mm_set1_ps(box.maxX);
+    const __m128 minY = _mm_set1_ps(box.minY), maxY = _mm_set1_ps(box.maxY);
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 inX = _mm_and_ps(_mm_cmpge_ps(x, minX), _mm_cmple_ps(x, maxX));
+        __m128 inY = _mm_and_ps(_mm_cmpge_ps(y, minY), _mm_cmple_ps(y, maxY));
+        mask |= static_cast<uint64_t>(_mm_movemask_ps(_mm_and_ps(inX, inY))) << i;
+    }
+    return mask & leafCountMask(count);
+#else
+    return leafRangeMask<float>(xs, ys, count, box);
+#endif
+}
+
+inline uint64_t leafRangeMask(const double *xs, const double *ys, uint32_t count, const LeafScanBox<double> &box)
+{
+#if defined(__AVX2__)
+    const __m256d minX = _mm256_set1_pd(box.minX), maxX = _mm256_set1_pd(box.maxX);
+    const __m256d minY = _mm256_set1_pd(box.minY), maxY = _mm256_set1_pd(box.maxY);
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        __m256d x = _mm256_loadu_pd(xs + i);
+        __m256d y = _mm256_loadu_pd(ys + i);
+        __m256d inX = _mm256_and_pd(_mm256_cmp_pd(x, minX, _CMP_GE_OQ), _mm256_cmp_pd(x, maxX, _CMP_LE_OQ));
+        __m256d inY = _mm256_and_pd(_mm256_cmp_pd(y, minY, _CMP_GE_OQ), _mm256_cmp_pd(y, maxY, _CMP_LE_OQ));
+        mask |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_and_pd(inX, inY))) << i;
+    }
+    return mask & leafCountMask(count);
+#elif defined(LEAF_SCAN_SSE2)
+    const __m128d minX = _mm_set1_pd(box.minX), maxX = _mm_set1_pd(box.maxX);
+    const __m128d minY = _mm_set1_pd(box.minY), maxY = _mm_set1_pd(box.maxY);
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < count; i += 2)
+    {
+        __m128d x = _mm_loadu_pd(xs + i);
+        __m128d y = _mm_loadu_pd(ys + i);
+        __m128d inX = _mm_and_pd(_mm_cmpge_pd(x, minX), _mm_cmple_pd(x, maxX));
+        __m128d inY = _mm_and_pd(_mm_cmpge_pd(y, minY), _mm_cmple_pd(y, maxY));
+        mask |= static_cast<uint64_t>(_mm_movemask_pd(_mm_and_pd(inX, inY))) << i;
+    }
+    return mask & leafCountMask(count);
+#else
+    return leafRangeMask<double>(xs, ys, count, box);
+#endif
+}
+
+template <typename Coord>
+uint64_t leafDistanceMask(const Coord *xs, const Coord *ys, uint32_t count, double x, double y, double limit)
+{
+    limit = leafWidenedLimit(limit);
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        double dx = static_cast<double>(xs[i]) - x;
+        double dy = static_cast<double>(ys[i]) - y;
+        mask |= static_cast<uint64_t>(dx * dx + dy * dy <= limit) << i;
+    }
+    return mask;
+}
+
+inline uint64_t leafDistanceMask(const float *xs, const float *ys, uint32_t count, double x, double y, double limit)
+{
+#if defined(__AVX2__)
+    // Widened to double four lanes at a time
+    const __m256d qx = _mm256_set1_pd(x), qy = _mm256_set1_pd(y);
+    const __m256d bound = _mm256_set1_pd(leafWidenedLimit(limit));
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        __m256d dx = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(xs + i)), qx);
+        __m256d dy = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(ys + i)), qy);
+        __m256d distSq = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        mask |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_cmp_pd(distSq, bound, _CMP_LE_OQ))) << i;
+    }
+    return mask & leafCountMask(count);
+#elif defined(LEAF_SCAN_SSE2)
+    const __m128d qx = _mm_set1_pd(x), qy = _mm_set1_pd(y);
+    const __m128d bound = _mm_set1_pd(leafWidenedLimit(limit));
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        __m128 xs4 = _mm_loadu_ps(xs + i);
+        __m128 ys4 = _mm_loadu_ps(ys + i);
+        __m128d dxLow = _mm_sub_pd(_mm_cvtps_pd(xs4), qx);
+        __m128d dyLow = _mm_sub_pd(_mm_cvtps_pd(ys4), qy);
+        __m128d dxHigh = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(xs4, xs4)), qx);
+        __m128d dyHigh = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(ys4, ys4)), qy);
+        __m128d low = _mm_add_pd(_mm_mul_pd(dxLow, dxLow), _mm_mul_pd(dyLow, dyLow));
+        __m128d high = _mm_add_pd(_mm_mul_pd(dxHigh, dxHigh), _mm_mul_pd(dyHigh, dyHigh));
+        uint64_t bits = static_cast<uint64_t>(_mm_movemask_pd(_mm_cmple_pd(low, bound))) |
+                        static_cast<uint64_t>(_mm_movemask_pd(_mm_cmple_pd(high, bound))) << 2;
+        mask |= bits << i;
+    }
+    return mask & leafCountMask(count);
+#else
+    return leafDistanceMask<float>(xs, ys, count, x, y, limit);
+#endif
+}
+
+inline uint64_t leafDistanceMask(const double *xs, const double *ys, uint32_t count, double x, double y, double limit)
+{
+#if defined(__AVX2__)
+    const __m256d qx = _mm256_set1_pd(x), qy = _mm256_set1_pd(y);
+    const __m256d bound = _mm256_set1_pd(leafWidenedLimit(limit));
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), qx);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), qy);
+        __m256d distSq = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        mask |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_cmp_pd(distSq, bound, _CMP_LE_OQ))) << i;
+    }
+    return mask & leafCountMask(count);
+#elif defined(LEAF_SCAN_SSE2)
+    const __m128d qx = _mm_set1_pd(x), qy = _mm_set1_pd(y);
+    const __m128d bound = _mm_set1_pd(leafWidenedLimit(limit));
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < count; i += 2)
+    {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), qx);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), qy);
+        __m128d distSq = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        mask |= static_cast<uint64_t>(_mm_movemask_pd(_mm_cmple_pd(distSq, bound))) << i;
+    }
+    return mask & leafCountMask(count);
+#else
+    return leafDistanceMask<double>(xs, ys, count, x, y, limit);
+#endif
+}
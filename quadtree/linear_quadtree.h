@@ -0,0 +1,148 @@
+#ifndef LINEAR_QUADTREE_H
+#define LINEAR_QUADTREE_H
+
+#include "quadtree.h"
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+/**
+ * Pointerless quadtree for static point sets
+ *
+ * Points are kept in one array sorted by Morton (Z-order) key, next to a
+ * parallel array of the keys. A node is implicit: the points of the node at
+ * depth d with key prefix p are exactly the run of keys starting with p, so
+ * no child pointers are stored. The runs of the top levels are looked up in a
+ * flat directory of offsets sized to the point count; deeper runs are found by
+ * binary search inside the parent's run. Nodes are split the same way QuadTree
+ * splits them, which makes the two interchangeable for queries.
+ *
+ * Build once with build(), then query; there is no incremental insert. For
+ * trivially copyable payloads the whole tree can be saved and restored with
+ * serialize() / deserialize().
+ */
+template <typename T>
+class LinearQuadTree
+{
+private:
+    MortonEncoder morton;
+    size_t maxPoints;                                       // Runs of at most this many points are scanned as leaves
+    size_t maxDepth;                                        // Depth at which runs are scanned regardless of size
+    std::vector<uint64_t> keys;                             // Sorted Morton keys, parallel to points
+    std::vector<Point<T>> points;                           // Points in key order
+    std::vector<uint32_t> directory;                        // directory[c]: first point whose top directoryLevels digits are >= c
+    size_t directoryLevels;                                 // Levels resolved through the directory instead of binary search
+    std::vector<std::pair<uint64_t, uint32_t>> sortKeys;    // (key, input index) scratch kept between build() calls
+    std::vector<std::pair<uint64_t, uint32_t>> sortScratch; // Radix sort buffer for build()
+
+    /**
+     * Split the run [begin, end) of the node with the given key prefix into its
+     * four child runs, r_runs[i] to r_runs[i + 1]
+     */
+    void childRuns(uint64_t prefix, size_t begin, size_t end, size_t depth, size_t r_runs[5]) const;
+
+    /**
+     * Rebuild the directory for the current keys
+     */
+    void buildDirectory();
+
+    /**
+     * Whether the run [begin, end) of a node at the given depth is scanned instead of split
+     */
+    bool isLeaf(size_t begin, size_t end, size_t depth) const;
+
+    /**
+     * Query points within a bounding box recursively
+     */
+    void queryRangeRecursive(const BoundingBox &bounds, uint64_t prefix, size_t begin, size_t end, size_t depth,
+                             const BoundingBox &range, std::vector<Point<T>> &result) const;
+
+    /**
+     * Find the nearest point recursively
+     */
+    void findNearestRecursive(const BoundingBox &bounds, uint64_t prefix, size_t begin, size_t end, size_t depth,
+                              double x, double y, size_t &nearest, double &minDistSq) const;
+
+    /**
+     * Calculate the squared distance from a point to a bounding box
+     */
+    static double distanceSqToBounds(double x, double y, const BoundingBox &bounds);
+
+public:
+    /**
+     * Type of the stored points
+     */
+    using PointType = Point<T>;
+
+    /**
+     * Constructor
+     * @param bounds The bounding box for the entire quadtree
+     * @param maxPoints Maximum points per node before subdivision (default: 10)
+     * @param maxDepth Maximum depth of the tree (default: 10)
+     */
+    LinearQuadTree(const BoundingBox &bounds, size_t maxPoints = 10, size_t maxDepth = 10);
+
+    /**
+     * Replace the contents of the tree with a set of points
+     * @param points Points to index; their payloads are moved into the tree.
+     *               Points outside the tree bounds are dropped.
+     */
+    void build(std::vector<Point<T>> &&points);
+
+    /**
+     * Query all points within a given bounding box
+     * @param range The bounding box to search within
+     * @return Vector of points within the range
+     */
+    std::vector<Point<T>> queryRange(const BoundingBox &range) const;
+
+    /**
+     * Find the nearest point to a given location
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param nearest Output parameter for the nearest point
+     * @return True if a point was found, false otherwise
+     */
+    bool findNearest(double x, double y, Point<T> &nearest) const;
+
+    /**
+     * Get all points in the quadtree, in Morton order
+     * @return Vector of all points
+     */
+    std::vector<Point<T>> getAllPoints() const;
+
+    /**
+     * Clear all points from the quadtree, keeping the storage
+     */
+    void clear();
+
+    /**
+     * Get the total number of points in the quadtree
+     * @return Number of points
+     */
+    size_t size() const;
+
+    /**
+     * Check if the quadtree is empty
+     * @return True if empty, false otherwise
+     */
+    bool empty() const;
+
+    /**
+     * Write the tree to a flat byte buffer: a fixed header, then the key
+     * and point arrays copied verbatim. Requires a trivially copyable T.
+     * @return Serialized tree
+     */
+    std::vector<uint8_t> serialize() const;
+
+    /**
+     * Replace the tree with one written by serialize()
+     * @param data Serialized tree
+     * @return False if the buffer is not a valid tree for this T; the tree is left unchanged
+     */
+    bool deserialize(const std::vector<uint8_t> &data);
+};
+
+#include "linear_quadtree.hpp"
+
+#endif // LINEAR_QUADTREE_H
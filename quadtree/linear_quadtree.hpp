@@ -0,0 +1,384 @@
+#include "linear_quadtree.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace linear_quadtree_detail
+{
+    constexpr uint32_t MAGIC = 0x5251544C; // "LTQR"
+    constexpr uint32_t VERSION = 1;
+
+    // Fixed-size prefix of a serialized tree
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t pointSize; // sizeof(Point<T>) at write time
+        uint64_t count;
+        uint64_t maxPoints;
+        uint64_t maxDepth;
+        double bounds[4];
+    };
+}
+
+template <typename T>
+LinearQuadTree<T>::LinearQuadTree(const BoundingBox &bounds, size_t maxPoints, size_t maxDepth)
+    : morton(bounds, maxDepth), maxPoints(maxPoints), maxDepth(maxDepth), directoryLevels(0)
+{
+}
+
+template <typename T>
+void LinearQuadTree<T>::build(std::vector<Point<T>> &&input)
+{
+    using Key = std::pair<uint64_t, uint32_t>;
+
+    sortKeys.clear();
+    sortKeys.reserve(input.size());
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        if (morton.bounds.contains(input[i].x, input[i].y))
+        {
+            sortKeys.push_back(Key(morton.encode(input[i].x, input[i].y), static_cast<uint32_t>(i)));
+        }
+    }
+
+    sortScratch.resize(sortKeys.size());
+    const int bits = 2 * std::max(morton.levels, 1);
+    radixSortKeys(sortKeys.data(), sortScratch.data(), sortKeys.size(), bits);
+
+    keys.clear();
+    points.clear();
+    keys.reserve(sortKeys.size());
+    points.reserve(sortKeys.size());
+    for (const Key &key : sortKeys)
+    {
+        keys.push_back(key.first);
+        points.push_back(std::move(input[key.second]));
+    }
+    buildDirectory();
+}
+
+template <typename T>
+void LinearQuadTree<T>::buildDirectory()
+{
+    // About one directory cell per leaf for uniform data, capped at 4^12 cells
+    size_t leaves = keys.size() / std::max<size_t>(maxPoints, 1);
+    directoryLevels = 0;
+    while (directoryLevels < 12 && directoryLevels < maxDepth &&
+           directoryLevels < static_cast<size_t>(morton.levels) && (size_t(1) << (2 * (directoryLevels + 1))) <= leaves)
+    {
+        ++directoryLevels;
+    }
+
+    size_t cells = size_t(1) << (2 * directoryLevels);
+    directory.assign(cells + 1, static_cast<uint32_t>(keys.size()));
+    if (directoryLevels == 0)
+    {
+        directory[0] = 0;
+        return;
+    }
+
+    // One sweep: every cell up to and including a key's cell starts at or before it
+    int shift = 64 - 2 * static_cast<int>(directoryLevels);
+    size_t cell = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        size_t keyCell = static_cast<size_t>(keys[i] >> shift);
+        while (cell <= keyCell)
+        {
+            directory[cell++] = static_cast<uint32_t>(i);
+        }
+    }
+}
+
+template <typename T>
+void LinearQuadTree<T>::childRuns(uint64_t prefix, size_t begin, size_t end, size_t depth, size_t r_runs[5]) const
+{
+    r_runs[0] = begin;
+    r_runs[4] = end;
+
+    if (depth < directoryLevels)
+    {
+        // Children of directory levels start at the first cell they cover
+        size_t span = size_t(1) << (2 * (directoryLevels - depth - 1));
+        size_t firstCell = static_cast<size_t>(prefix) * 4 * span;
+        for (uint32_t i = 1; i < 4; ++i)
+        {
+            r_runs[i] = directory[firstCell + i * span];
+        }
+        return;
+    }
+
+    int shift = 62 - 2 * static_cast<int>(depth);
+    for (uint32_t i = 1; i < 4; ++i)
+    {
+        auto it = std::partition_point(keys.begin() + r_runs[i - 1], keys.begin() + end, [shift, i](uint64_t key) {
+            return ((key >> shift) & 3) < i;
+        });
+        r_runs[i] = static_cast<size_t>(it - keys.begin());
+    }
+}
+
+template <typename T>
+bool LinearQuadTree<T>::isLeaf(size_t begin, size_t end, size_t depth) const
+{
+    return end - begin <= maxPoints || depth >= maxDepth || depth >= static_cast<size_t>(morton.levels);
+}
+
+template <typename T>
+std::vector<Point<T>> LinearQuadTree<T>::queryRange(const BoundingBox &range) const
+{
+    std::vector<Point<T>> result;
+    queryRangeRecursive(morton.bounds, 0, 0, keys.size(), 0, range, result);
+    return result;
+}
+
+template <typename T>
+void LinearQuadTree<T>::queryRangeRecursive(const BoundingBox &bounds, uint64_t prefix, size_t begin, size_t end,
+                                            size_t depth, const BoundingBox &range, std::vector<Point<T>> &result) const
+{
+    if (begin == end || !bounds.intersects(range))
+    {
+        return; // Empty run or no intersection, skip this node
+    }
+
+    // Every point of a node lies inside its bounds, so a covered node is copied whole
+    if (range.contains(bounds))
+    {
+        result.insert(result.end(), points.begin() + begin, points.begin() + end);
+        return;
+    }
+
+    if (isLeaf(begin, end, depth))
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (range.contains(points[i].x, points[i].y))
+            {
+                result.push_back(points[i]);
+            }
+        }
+        return;
+    }
+
+    // Each child is the sub-run whose key digit at this depth is its index
+    size_t runs[5];
+    childRuns(prefix, begin, end, depth, runs);
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        queryRangeRecursive(MortonEncoder::childBounds(bounds, i), prefix * 4 + i, runs[i], runs[i + 1], depth + 1,
+                            range, result);
+    }
+}
+
+template <typename T>
+bool LinearQuadTree<T>::findNearest(double x, double y, Point<T> &nearest) const
+{
+    size_t index = keys.size();
+    double minDistSq = std::numeric_limits<double>::max();
+    findNearestRecursive(morton.bounds, 0, 0, keys.size(), 0, x, y, index, minDistSq);
+    if (index == keys.size())
+    {
+        return false;
+    }
+    nearest = points[index];
+    return true;
+}
+
+template <typename T>
+void LinearQuadTree<T>::findNearestRecursive(const BoundingBox &bounds, uint64_t prefix, size_t begin, size_t end,
+                                             size_t depth, double x, double y, size_t &nearest, double &minDistSq) const
+{
+    if (begin == end)
+    {
+        return;
+    }
+
+    if (isLeaf(begin, end, depth))
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            double dx = points[i].x - x;
+            double dy = points[i].y - y;
+            double distSq = dx * dx + dy * dy;
+            if (distSq < minDistSq)
+            {
+                minDistSq = distSq;
+                nearest = i;
+            }
+        }
+        return;
+    }
+
+    size_t runs[5];
+    childRuns(prefix, begin, end, depth, runs);
+
+    // Search the child containing the query point first
+    double midX = bounds.x + bounds.width / 2.0;
+    double midY = bounds.y + bounds.height / 2.0;
+    uint32_t childIndex = 0;
+    if (x >= midX)
+        childIndex |= 1;
+    if (y >= midY)
+        childIndex |= 2;
+
+    for (uint32_t n = 0; n < 4; ++n)
+    {
+        uint32_t i = childIndex ^ n;
+        if (runs[i] == runs[i + 1])
+        {
+            continue;
+        }
+
+        // Skip children that cannot contain a closer point
+        BoundingBox childBounds = MortonEncoder::childBounds(bounds, i);
+        if (n == 0 || distanceSqToBounds(x, y, childBounds) < minDistSq)
+        {
+            findNearestRecursive(childBounds, prefix * 4 + i, runs[i], runs[i + 1], depth + 1, x, y, nearest, minDistSq);
+        }
+    }
+}
+
+template <typename T>
+double LinearQuadTree<T>::distanceSqToBounds(double x, double y, const BoundingBox &bounds)
+{
+    double dx = std::max(0.0, std::max(bounds.x - x, x - (bounds.x + bounds.width)));
+    double dy = std::max(0.0, std::max(bounds.y - y, y - (bounds.y + bounds.height)));
+    return dx * dx + dy * dy;
+}
+
+template <typename T>
+std::vector<Point<T>> LinearQuadTree<T>::getAllPoints() const
+{
+    return points;
+}
+
+template <typename T>
+void LinearQuadTree<T>::clear()
+{
+    keys.clear();
+    points.clear();
+    buildDirectory();
+}
+
+template <typename T>
+size_t LinearQuadTree<T>::size() const
+{
+    return points.size();
+}
+
+template <typename T>
+bool LinearQuadTree<T>::empty() const
+{
+    return points.empty();
+}
+
+template <typename T>
+std::vector<uint8_t> LinearQuadTree<T>::serialize() const
+{
+    static_assert(std::is_trivially_copyable<Point<T>>::value,
+                  "LinearQuadTree::serialize requires a trivially copyable payload");
+    using linear_quadtree_detail::Header;
+
+    Header header = {};
+    header.magic = linear_quadtree_detail::MAGIC;
+    header.version = linear_quadtree_detail::VERSION;
+    header.pointSize = sizeof(Point<T>);
+    header.count = points.size();
+    header.maxPoints = maxPoints;
+    header.maxDepth = maxDepth;
+    header.bounds[0] = morton.bounds.x;
+    header.bounds[1] = morton.bounds.y;
+    header.bounds[2] = morton.bounds.width;
+    header.bounds[3] = morton.bounds.height;
+
+    size_t keyBytes = keys.size() * sizeof(uint64_t);
+    size_t pointBytes = points.size() * sizeof(Point<T>);
+    std::vector<uint8_t> data(sizeof(Header) + keyBytes + pointBytes);
+    std::memcpy(data.data(), &header, sizeof(Header));
+    if (!points.empty())
+    {
+        std::memcpy(data.data() + sizeof(Header), keys.data(), keyBytes);
+        std::memcpy(data.data() + sizeof(Header) + keyBytes, points.data(), pointBytes);
+    }
+    return data;
+}
+
+template <typename T>
+bool LinearQuadTree<T>::deserialize(const std::vector<uint8_t> &data)
+{
+    static_assert(std::is_trivially_copyable<Point<T>>::value,
+                  "LinearQuadTree::deserialize requires a trivially copyable payload");
+    using linear_quadtree_detail::Header;
+
+    Header header;
+    if (data.size() < sizeof(Header))
+    {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(Header));
+    if (header.magic != linear_quadtree_detail::MAGIC || header.version != linear_quadtree_detail::VERSION ||
+        header.pointSize != sizeof(Point<T>))
+    {
+        return false;
+    }
+
+    // Checked by division so a corrupt count cannot overflow the size computation
+    uint64_t payload = data.size() - sizeof(Header);
+    if (header.count > payload / (sizeof(uint64_t) + sizeof(Point<T>)) ||
+        header.count * (sizeof(uint64_t) + sizeof(Point<T>)) != payload)
+    {
+        return false;
+    }
+
+    // The directory stores 32-bit offsets, and the scales in MortonEncoder need a finite, non-empty box
+    if (header.count > std::numeric_limits<uint32_t>::max() || header.maxPoints < 1)
+    {
+        return false;
+    }
+    for (double value : header.bounds)
+    {
+        if (!std::isfinite(value))
+        {
+            return false;
+        }
+    }
+    if (!(header.bounds[2] > 0.0) || !(header.bounds[3] > 0.0))
+    {
+        return false;
+    }
+
+    // Runs are located by searching the keys, so they must be sorted, and keys are left-aligned, so the bits
+    // of levels past maxDepth are zero
+    size_t count = static_cast<size_t>(header.count);
+    std::vector<uint64_t> newKeys(count);
+    if (count > 0)
+    {
+        std::memcpy(newKeys.data(), data.data() + sizeof(Header), count * sizeof(uint64_t));
+    }
+    const uint64_t bits = 2 * std::min<uint64_t>(header.maxDepth, 32);
+    const uint64_t unusedBits = bits >= 64 ? 0 : std::numeric_limits<uint64_t>::max() >> bits;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if ((newKeys[i] & unusedBits) != 0 || (i > 0 && newKeys[i] < newKeys[i - 1]))
+        {
+            return false;
+        }
+    }
+
+    BoundingBox bounds(header.bounds[0], header.bounds[1], header.bounds[2], header.bounds[3]);
+    morton = MortonEncoder(bounds, static_cast<size_t>(header.maxDepth));
+    maxPoints = static_cast<size_t>(header.maxPoints);
+    maxDepth = static_cast<size_t>(header.maxDepth);
+
+    keys.swap(newKeys);
+    points.resize(count);
+    if (count > 0)
+    {
+        std::memcpy(static_cast<void *>(points.data()), data.data() + sizeof(Header) + count * sizeof(uint64_t),
+                    count * sizeof(Point<T>));
+    }
+    buildDirectory();
+    return true;
+}
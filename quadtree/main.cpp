@@ -10,6 +10,7 @@ struct City
     std::string name;
     int population;
 
+    City() : population(0) {}
     City(const std::string &name, int population) : name(name), population(population) {}
 };
 
@@ -97,6 +98,13 @@ int main()
     std::cout << "Cities in Europe region: " << europeanCities.size() << std::endl;
     printPoints(europeanCities);
 
+    // Visit cities in place instead of copying their names
+    long long europePopulation = 0;
+    cityTree.queryRange(europeRegion, [&](const Point<City> &city) {
+        europePopulation += city.data.population;
+    });
+    std::cout << "Population of Europe region: " << europePopulation << std::endl;
+
     // Find nearest city to a location
     Point<City> nearestCity;
     if (cityTree.findNearest(10, 10, nearestCity))
@@ -1,24 +1,33 @@
 #ifndef QUADTREE_H
 #define QUADTREE_H
 
+#include "leaf_scan.h"
+#include "thread_pool.h"
 #include <vector>
-#include <memory>
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 // Forward declaration
-template <typename T>
+template <typename T, typename Coord>
 class QuadTree;
 
 /**
  * Represents a 2D point with associated data
+ *
+ * Coord is the stored coordinate type; float halves the size of the
+ * coordinates for data that does not need double precision.
  */
-template <typename T>
+template <typename T, typename Coord = double>
 struct Point
 {
-    double x, y;
+    Coord x, y;
     T data;
 
-    Point(double x, double y, const T &data) : x(x), y(y), data(data) {}
+    Point() : x(0), y(0), data() {}
+    Point(Coord x, Coord y, const T &data) : x(x), y(y), data(data) {}
 };
 
 /**
@@ -39,6 +48,15 @@ struct BoundingBox
         return px >= x && px <= x + width && py >= y && py <= y + height;
     }
 
+    /**
+     * Check if another bounding box lies entirely within this one
+     */
+    bool contains(const BoundingBox &other) const
+    {
+        return other.x >= x && other.x + other.width <= x + width &&
+               other.y >= y && other.y + other.height <= y + height;
+    }
+
     /**
      * Check if this bounding box intersects with another
      */
@@ -49,19 +67,169 @@ struct BoundingBox
     }
 };
 
+/**
+ * Z-order keys that follow QuadTree's subdivision of a root box
+ *
+ * Keys hold two bits per level, most significant level first. Each pair is
+ * the child index (bit 0: right half, bit 1: upper half) that insert() would
+ * pick at that level, so sorting by key groups points by node at every depth.
+ */
+struct MortonEncoder
+{
+    BoundingBox bounds;
+    int levels;            // Levels encoded, at most 32
+    double scaleX, scaleY; // Finest-level cells per unit
+    double slackX, slackY; // Cell-edge margin inside which encode() walks the exact midpoints
+
+    MortonEncoder(const BoundingBox &bounds, size_t maxDepth);
+
+    /**
+     * Key of a point inside bounds; the bits of levels past maxDepth are zero
+     */
+    uint64_t encode(double x, double y) const;
+
+    /**
+     * Child quadrant of a box, computed exactly as subdivide() does
+     */
+    static BoundingBox childBounds(const BoundingBox &parent, uint32_t index);
+};
+
 /**
  * QuadTree node structure
+ *
+ * Nodes live in one array owned by the tree. The four children of a node are
+ * allocated together, so a single index locates all of them. Leaf points are
+ * kept in fixed-size buckets of a shared point pool, chained through the
+ * bucket table when a leaf at maximum depth outgrows one bucket.
  */
-template <typename T>
 struct QuadTreeNode
 {
+    static constexpr uint32_t NONE = UINT32_MAX;
+
     BoundingBox bounds;
-    std::vector<Point<T>> points;
-    std::unique_ptr<QuadTreeNode<T>> children[4];
-    bool isLeaf;
+    uint32_t firstChild; // Index of the first of four consecutive children, NONE for leaves
+    uint32_t bucket;     // Head of the leaf's bucket chain, NONE when the leaf holds no points
+    uint32_t count;      // Number of points stored in this leaf
+    uint32_t parent;     // NONE for the root and for released nodes
 
-    QuadTreeNode(const BoundingBox &bounds)
-        : bounds(bounds), isLeaf(true) {}
+    QuadTreeNode(const BoundingBox &bounds, uint32_t parent = NONE)
+        : bounds(bounds), firstChild(NONE), bucket(NONE), count(0), parent(parent) {}
+
+    bool isLeaf() const { return firstChild == NONE; }
+};
+
+/**
+ * A run of bucketSize slots in the point pool, owned by one leaf
+ *
+ * Only the head bucket of a chain may be partly filled.
+ */
+struct QuadTreeBucket
+{
+    uint32_t next;  // Next bucket of the same leaf, QuadTreeNode::NONE at the end of the chain
+    uint32_t count; // Used slots in this bucket
+};
+
+/**
+ * Where the point behind a handle currently lives
+ */
+struct QuadTreeHandleEntry
+{
+    uint32_t slot; // Pool slot of the point, QuadTreeNode::NONE while the handle is free
+    uint32_t node; // Leaf holding that slot
+};
+
+/**
+ * Bounded max-heap of the best candidates found by a k-nearest search
+ *
+ * Entries live in storage supplied by the caller and the heap never grows
+ * past its capacity: once full, a closer candidate replaces the farthest one.
+ */
+template <typename T, typename Coord = double>
+class NeighbourHeap
+{
+public:
+    // k up to this many is searched with entries on the stack
+    static constexpr size_t INLINE_CAPACITY = 64;
+
+    struct Entry
+    {
+        double distSq;
+        const Point<T, Coord> *point;
+
+        bool operator<(const Entry &other) const { return distSq < other.distSq; }
+    };
+
+    NeighbourHeap(Entry *storage, size_t capacity)
+        : entries(storage), capacity(capacity), count(0) {}
+
+    /**
+     * Squared distance a candidate must beat to enter the heap
+     */
+    double bound() const
+    {
+        return count < capacity ? std::numeric_limits<double>::max() : entries[0].distSq;
+    }
+
+    /**
+     * Offer a candidate; ignored when it is not closer than bound()
+     */
+    void push(double distSq, const Point<T, Coord> *point)
+    {
+        if (count < capacity)
+        {
+            entries[count++] = Entry{distSq, point};
+            std::push_heap(entries, entries + count);
+        }
+        else if (distSq < entries[0].distSq)
+        {
+            std::pop_heap(entries, entries + count);
+            entries[count - 1] = Entry{distSq, point};
+            std::push_heap(entries, entries + count);
+        }
+    }
+
+    /**
+     * Sort the entries nearest first; the heap is unusable afterwards
+     */
+    void sortNearestFirst() { std::sort_heap(entries, entries + count); }
+
+    const Entry *begin() const { return entries; }
+    const Entry *end() const { return entries + count; }
+    size_t size() const { return count; }
+
+private:
+    Entry *entries;
+    size_t capacity;
+    size_t count;
+};
+
+/**
+ * Location of one nearest-neighbour query in a batch
+ */
+struct QueryPoint
+{
+    double x, y;
+};
+
+/**
+ * Results of a batch query, laid out query after query in one buffer
+ *
+ * The results of query i are points[offsets[i]] up to points[offsets[i + 1]].
+ * Reusing one batch object across calls keeps its buffers allocated.
+ */
+template <typename T, typename Coord = double>
+struct QuadTreeBatch
+{
+    std::vector<Point<T, Coord>> points;
+    std::vector<size_t> offsets; // One more entry than there were queries
+
+    // Scratch for the per-thread pass: each thread's results, and where query i wrote them
+    std::vector<std::vector<Point<T, Coord>>> workerPoints;
+    std::vector<std::pair<uint32_t, size_t>> sources;
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    const Point<T, Coord> *begin(size_t query) const { return points.data() + offsets[query]; }
+    const Point<T, Coord> *end(size_t query) const { return points.data() + offsets[query + 1]; }
 };
 
 /**
@@ -69,61 +237,169 @@ struct QuadTreeNode
  *
  * A quadtree recursively subdivides 2D space into four quadrants
  * when the number of points in a node exceeds a threshold.
+ *
+ * Const member functions keep no hidden state, so any number of threads may
+ * query one tree at the same time as long as no thread modifies it.
  */
-template <typename T>
+template <typename T, typename Coord = double>
 class QuadTree
 {
+    static_assert(std::is_floating_point<Coord>::value, "QuadTree coordinates must be float or double");
+
+public:
+    /**
+     * Stable reference to a point returned by insert()
+     *
+     * A handle stays valid while its point moves between nodes and becomes
+     * free again after remove() or clear(); free handles are reused.
+     */
+    using Handle = uint32_t;
+    static constexpr Handle INVALID_HANDLE = QuadTreeNode::NONE;
+
+    /**
+     * Type of the stored points
+     */
+    using PointType = Point<T, Coord>;
+
 private:
-    std::unique_ptr<QuadTreeNode<T>> root;
+    std::vector<QuadTreeNode> nodes;     // Node 0 is the root
+    std::vector<QuadTreeBucket> buckets; // Bucket b owns pool slots [b * bucketSize, (b + 1) * bucketSize)
+    std::vector<uint32_t> freeBuckets;   // Buckets released by subdivided or merged leaves, reused first
+    std::vector<uint32_t> freeNodes;     // First nodes of child quads released by merges, reused first
+    std::vector<Point<T, Coord>> pool;   // Point slots; may be larger than buckets * bucketSize after clear()
+    std::vector<Coord> xs, ys;           // Coordinates of each pool slot for leaf scans, plus LEAF_SCAN_PADDING
+    std::vector<Handle> slotHandles;     // Handle of each pool slot, INVALID_HANDLE for points without one
+    std::vector<QuadTreeHandleEntry> handles; // Indexed by Handle
+    std::vector<Handle> freeHandles;          // Handles released by remove(), reused first
+    std::vector<uint32_t> mergeCandidates;    // Parents of leaves that lost points since the last compact()
+    std::vector<std::pair<uint64_t, uint32_t>> buildKeys;    // (Morton key, input index) scratch kept between build() calls
+    std::vector<std::pair<uint64_t, uint32_t>> buildScratch; // Radix sort and merge buffer for build()
     size_t maxPoints;
     size_t maxDepth;
+    size_t bucketSize;
+    size_t pointCount;
+    MortonEncoder morton; // Keys for build()
 
     /**
-     * Subdivide a node into four children
+     * Subdivide a node at the given depth into four children
      */
-    void subdivide(QuadTreeNode<T> *node);
+    void subdivide(uint32_t node, size_t depth);
 
     /**
      * Insert a point recursively
      */
-    void insertRecursive(QuadTreeNode<T> *node, const Point<T> &point, size_t depth);
+    void insertRecursive(uint32_t node, const Point<T, Coord> &point, size_t depth, Handle handle);
+
+    /**
+     * Insert a point into the appropriate child of a node at the given depth
+     */
+    void insertIntoChildren(uint32_t node, const Point<T, Coord> &point, size_t depth, Handle handle);
+
+    /**
+     * Store a point in a leaf, starting a new bucket when the head bucket is full
+     */
+    void appendToLeaf(uint32_t node, Point<T, Coord> point, Handle handle);
 
     /**
-     * Insert a point into the appropriate child node
+     * Move a point out of its leaf, filling the hole with the leaf's last point
      */
-    void insertIntoChildren(QuadTreeNode<T> *node, const Point<T> &point);
+    Point<T, Coord> takeFromLeaf(uint32_t node, uint32_t slot);
+
+    /**
+     * Fold four leaf children back into their parent if they hold few enough points
+     */
+    bool mergeChildren(uint32_t node);
+
+    /**
+     * Append four children to the node array and link them to node
+     */
+    uint32_t createChildren(uint32_t node);
+
+    /**
+     * Build the subtree of node from keys sorted by Morton order
+     */
+    void buildRecursive(uint32_t node, const std::pair<uint64_t, uint32_t> *begin,
+                        const std::pair<uint64_t, uint32_t> *end, size_t depth,
+                        std::vector<Point<T, Coord>> &points);
+
+    /**
+     * Take a bucket from the free list or the end of the pool
+     */
+    uint32_t allocateBucket(const Point<T, Coord> &filler);
+
+    /**
+     * Call a visitor with a point; visitors returning void never stop the query
+     * @return False if the visitor asked to stop
+     */
+    template <typename Fn>
+    static bool visit(Fn &fn, const Point<T, Coord> &point);
+
+    /**
+     * Call fn for the points of a leaf selected by mask(xs, ys, count) until it asks to stop
+     */
+    template <typename Mask, typename Fn>
+    bool forEachInLeafMasked(const QuadTreeNode &node, Mask &&mask, Fn &&fn) const;
+
+    /**
+     * Call fn for every point stored in a leaf until it asks to stop
+     */
+    template <typename Fn>
+    bool forEachInLeaf(const QuadTreeNode &node, Fn &&fn) const;
 
     /**
      * Query points within a bounding box recursively
      */
-    void queryRangeRecursive(QuadTreeNode<T> *node, const BoundingBox &range,
-                             std::vector<Point<T>> &result) const;
+    template <typename Fn>
+    bool queryRangeRecursive(uint32_t node, const BoundingBox &range, const LeafScanBox<Coord> &box, Fn &fn) const;
 
     /**
      * Find the nearest point to a given location recursively
      */
-    bool findNearestRecursive(QuadTreeNode<T> *node, double x, double y,
-                              Point<T> &nearest, double &minDist) const;
+    bool findNearestRecursive(uint32_t node, double x, double y,
+                              Point<T, Coord> &nearest, double &minDistSq) const;
 
     /**
-     * Calculate distance between two points
+     * Collect the k nearest points recursively, visiting children nearest-first
      */
-    static double distance(double x1, double y1, double x2, double y2);
+    void findKNearestRecursive(uint32_t node, double x, double y, NeighbourHeap<T, Coord> &heap) const;
 
     /**
-     * Calculate distance from a point to a bounding box
+     * Append the k nearest points, nearest first, and return how many were found
      */
-    static double distanceToBounds(double x, double y, const BoundingBox &bounds);
+    size_t appendKNearest(double x, double y, size_t k, std::vector<Point<T, Coord>> &result) const;
 
     /**
-     * Get all points recursively
+     * Run query(i, out) for every query of a batch on the pool and gather the results in order
      */
-    void getAllPointsRecursive(QuadTreeNode<T> *node, std::vector<Point<T>> &result) const;
+    template <typename Query>
+    void runBatch(size_t count, QuadTreeBatch<T, Coord> &result, ThreadPool &pool, Query &&query) const;
 
     /**
-     * Count points recursively
+     * Query points within a circle recursively
      */
-    size_t countPointsRecursive(QuadTreeNode<T> *node) const;
+    template <typename Fn>
+    bool queryRadiusRecursive(uint32_t node, double x, double y, double radiusSq, Fn &fn) const;
+
+    /**
+     * Calculate squared distance between two points
+     */
+    static double distanceSq(double x1, double y1, double x2, double y2);
+
+    /**
+     * Calculate squared distance from a point to a bounding box, 0 inside it
+     */
+    static double distanceSqToBounds(double x, double y, const BoundingBox &bounds);
+
+    /**
+     * Calculate squared distance from a point to the farthest corner of a bounding box
+     */
+    static double farthestDistanceSq(double x, double y, const BoundingBox &bounds);
+
+    /**
+     * Visit all points of a subtree recursively
+     */
+    template <typename Fn>
+    bool getAllPointsRecursive(uint32_t node, Fn &fn) const;
 
 public:
     /**
@@ -139,15 +415,90 @@ public:
      * @param x X coordinate
      * @param y Y coordinate
      * @param data Associated data
+     * @return Handle of the new point, INVALID_HANDLE if it is outside the bounds
+     */
+    Handle insert(double x, double y, const T &data);
+
+    /**
+     * Remove the point behind a handle
+     *
+     * Emptied leaves stay in place until compact() merges them.
+     * @param handle Handle returned by insert()
+     * @return False if the handle is not in use
+     */
+    bool remove(Handle handle);
+
+    /**
+     * Move the point behind a handle
+     *
+     * A point that stays inside its leaf is updated in place; only a point
+     * crossing a leaf boundary is taken out and inserted again from the root.
+     * @param handle Handle returned by insert()
+     * @param x New X coordinate
+     * @param y New Y coordinate
+     * @return False if the handle is not in use or the position is outside
+     *         the tree bounds, in which case the point is left unchanged
+     */
+    bool update(Handle handle, double x, double y);
+
+    /**
+     * Get the point behind a handle
+     * @param handle Handle returned by insert() and still in use
+     */
+    const Point<T, Coord> &get(Handle handle) const;
+
+    /**
+     * Merge the subtrees emptied by remove() and update() since the last call
+     *
+     * A node whose four children are leaves holding at most maxPoints / 2
+     * points becomes a leaf again, which leaves room to grow before the next
+     * split. Cost is proportional to the number of removals and moves, so
+     * calling it once per frame is cheap.
+     * @return Number of merged nodes
      */
-    void insert(double x, double y, const T &data);
+    size_t compact();
+
+    /**
+     * Replace the contents of the tree with a set of points in one pass
+     *
+     * Points are sorted by Morton (Z-order) key, then each node takes the
+     * contiguous run of keys that falls inside it, so no point is ever moved
+     * between nodes. The resulting tree matches the one repeated insert()
+     * calls would produce, and storage from the previous build is reused.
+     * Points outside the tree bounds are dropped. Loaded points have no
+     * handle, and handles from earlier insert() calls are released.
+     * @param points Points to index; their payloads are moved into the tree
+     * @param parallel Compute and sort keys on all hardware threads
+     */
+    void build(std::vector<Point<T, Coord>> &&points, bool parallel = false);
 
     /**
      * Query all points within a given bounding box
      * @param range The bounding box to search within
      * @return Vector of points within the range
      */
-    std::vector<Point<T>> queryRange(const BoundingBox &range) const;
+    std::vector<Point<T, Coord>> queryRange(const BoundingBox &range) const;
+
+    /**
+     * Append all points within a given bounding box to a reused vector
+     * @param range The bounding box to search within
+     * @param result Vector the points are appended to; existing contents are kept
+     * @return Number of points appended
+     */
+    size_t queryRange(const BoundingBox &range, std::vector<Point<T, Coord>> &result) const;
+
+    /**
+     * Call a visitor for every point within a given bounding box, without copying
+     *
+     * The visitor takes a const Point<T, Coord>& and returns void, or bool where
+     * false stops the query. Points must not be inserted, moved or removed
+     * while the query runs.
+     * @param range The bounding box to search within
+     * @param fn Visitor called once per point
+     * @return False if the visitor stopped the query early
+     */
+    template <typename Fn>
+    bool queryRange(const BoundingBox &range, Fn &&fn) const;
 
     /**
      * Find the nearest point to a given location
@@ -156,16 +507,114 @@ public:
      * @param nearest Output parameter for the nearest point
      * @return True if a point was found, false otherwise
      */
-    bool findNearest(double x, double y, Point<T> &nearest) const;
+    bool findNearest(double x, double y, Point<T, Coord> &nearest) const;
+
+    /**
+     * Find the k points nearest to a given location
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param k Number of points to find
+     * @return Up to k points, nearest first
+     */
+    std::vector<Point<T, Coord>> findKNearest(double x, double y, size_t k) const;
+
+    /**
+     * Find the k points nearest to a given location into a reused vector
+     *
+     * For k up to NeighbourHeap<T, Coord>::INLINE_CAPACITY the search itself does
+     * not allocate, and once result has grown to k neither does the copy.
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param k Number of points to find
+     * @param result Replaced with up to k points, nearest first
+     * @return Number of points found
+     */
+    size_t findKNearest(double x, double y, size_t k, std::vector<Point<T, Coord>> &result) const;
+
+    /**
+     * Query all points within a given distance of a location
+     * @param x X coordinate of the center
+     * @param y Y coordinate of the center
+     * @param radius Search radius; points exactly on the circle are included
+     * @return Vector of points within the circle
+     */
+    std::vector<Point<T, Coord>> queryRadius(double x, double y, double radius) const;
+
+    /**
+     * Append all points within a given distance of a location to a reused vector
+     * @return Number of points appended
+     */
+    size_t queryRadius(double x, double y, double radius, std::vector<Point<T, Coord>> &result) const;
+
+    /**
+     * Call a visitor for every point within a given distance of a location
+     *
+     * Visitors follow the same rules as for queryRange().
+     * @return False if the visitor stopped the query early
+     */
+    template <typename Fn>
+    bool queryRadius(double x, double y, double radius, Fn &&fn) const;
+
+    /**
+     * Run many range queries on a thread pool
+     *
+     * Queries are spread over the pool with work stealing; each thread
+     * collects results on its own and they are then copied into per-query
+     * slices of result.points, in query order.
+     * @param ranges Array of count bounding boxes
+     * @param count Number of queries
+     * @param result Replaced with the results of every query
+     * @param pool Threads to run the queries on
+     */
+    void queryRangeBatch(const BoundingBox *ranges, size_t count, QuadTreeBatch<T, Coord> &result, ThreadPool &pool) const;
+
+    /**
+     * Run many k-nearest queries on a thread pool
+     *
+     * Each slice of result holds up to k points, nearest first.
+     * @param points Array of count query locations
+     * @param count Number of queries
+     * @param k Number of points to find per query
+     * @param result Replaced with the results of every query
+     * @param pool Threads to run the queries on
+     */
+    void findKNearestBatch(const QueryPoint *points, size_t count, size_t k, QuadTreeBatch<T, Coord> &result,
+                           ThreadPool &pool) const;
+
+    /**
+     * Run many nearest-point queries on a thread pool
+     *
+     * Each slice of result holds the nearest point, or nothing if the tree is empty.
+     */
+    void findNearestBatch(const QueryPoint *points, size_t count, QuadTreeBatch<T, Coord> &result, ThreadPool &pool) const;
 
     /**
      * Get all points in the quadtree
      * @return Vector of all points
      */
-    std::vector<Point<T>> getAllPoints() const;
+    std::vector<Point<T, Coord>> getAllPoints() const;
+
+    /**
+     * Append all points in the quadtree to a reused vector
+     * @return Number of points appended
+     */
+    size_t getAllPoints(std::vector<Point<T, Coord>> &result) const;
+
+    /**
+     * Call a visitor for every point in the quadtree
+     *
+     * Visitors follow the same rules as for queryRange().
+     * @return False if the visitor stopped early
+     */
+    template <typename Fn>
+    bool getAllPoints(Fn &&fn) const;
 
     /**
      * Clear all points from the quadtree
+     *
+     * Runs in constant time: node, bucket, point and handle storage keep
+     * their capacity for the next build; every handle is released. Payloads of the cleared points are
+     * released as their pool slots are reused or when the tree is destroyed.
      */
     void clear();
 
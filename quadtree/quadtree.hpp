@@ -1,185 +1,767 @@
 #include "quadtree.h"
 #include <cmath>
 #include <limits>
+#include <thread>
 
-template <typename T>
-QuadTree<T>::QuadTree(const BoundingBox &bounds, size_t maxPoints, size_t maxDepth)
-    : maxPoints(maxPoints), maxDepth(maxDepth)
+// Spreads the low 32 bits of v to the even bit positions
+inline uint64_t spreadBits(uint64_t v)
 {
-    root = std::make_unique<QuadTreeNode<T>>(bounds);
+    v &= 0xFFFFFFFFull;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    v = (v | (v << 2)) & 0x3333333333333333ull;
+    v = (v | (v << 1)) & 0x5555555555555555ull;
+    return v;
 }
 
-template <typename T>
-void QuadTree<T>::insert(double x, double y, const T &data)
+inline MortonEncoder::MortonEncoder(const BoundingBox &bounds, size_t maxDepth)
+    : bounds(bounds), levels(static_cast<int>(std::min<size_t>(maxDepth, 32)))
 {
-    if (!root->bounds.contains(x, y))
+    // Grid scale and the largest rounding error of subdivide()'s midpoints, in
+    // cells. Slack of 0.5 or more disables the quantized path.
+    const double cells = std::ldexp(1.0, levels);
+    const double epsilon = std::numeric_limits<double>::epsilon();
+    scaleX = cells / bounds.width;
+    scaleY = cells / bounds.height;
+    slackX = 2.0 * (levels + 4) * (std::abs(bounds.x) + std::abs(bounds.width)) * epsilon * scaleX;
+    slackY = 2.0 * (levels + 4) * (std::abs(bounds.y) + std::abs(bounds.height)) * epsilon * scaleY;
+    if (!(slackX < 0.5) || !(slackY < 0.5))
     {
-        return; // Point is outside the quadtree bounds
+        slackX = slackY = 0.5;
+    }
+}
+
+inline BoundingBox MortonEncoder::childBounds(const BoundingBox &parent, uint32_t index)
+{
+    double halfWidth = parent.width / 2.0;
+    double halfHeight = parent.height / 2.0;
+    return BoundingBox(parent.x + ((index & 1) ? halfWidth : 0.0),
+                       parent.y + ((index & 2) ? halfHeight : 0.0),
+                       halfWidth, halfHeight);
+}
+
+inline uint64_t MortonEncoder::encode(double x, double y) const
+{
+    if (levels == 0)
+    {
+        return 0;
+    }
+
+    // Fast path: quantize onto the finest grid, unless the point is within rounding
+    // distance of a cell edge where the midpoints subdivide() computes could disagree
+    double tx = (x - bounds.x) * scaleX;
+    double ty = (y - bounds.y) * scaleY;
+    double fx = tx - std::floor(tx);
+    double fy = ty - std::floor(ty);
+    if (fx > slackX && fx < 1.0 - slackX && fy > slackY && fy < 1.0 - slackY)
+    {
+        uint64_t cells = (uint64_t(1) << levels) - 1;
+        uint64_t qx = std::min(static_cast<uint64_t>(tx), cells);
+        uint64_t qy = std::min(static_cast<uint64_t>(ty), cells);
+        uint64_t key = spreadBits(qx) | (spreadBits(qy) << 1);
+        return levels == 32 ? key : key << (64 - 2 * levels);
+    }
+
+    // Walk the same midpoints subdivide() creates so keys agree exactly with insert()
+    BoundingBox cell = bounds;
+    uint64_t key = 0;
+    for (int level = 0; level < levels; ++level)
+    {
+        double halfWidth = cell.width / 2.0;
+        double halfHeight = cell.height / 2.0;
+
+        // Branch-free: the side taken at each level is close to random
+        uint64_t right = x >= cell.x + halfWidth;
+        uint64_t top = y >= cell.y + halfHeight;
+        cell.x += halfWidth * static_cast<double>(right);
+        cell.y += halfHeight * static_cast<double>(top);
+        cell.width = halfWidth;
+        cell.height = halfHeight;
+
+        key = (key << 2) | right | (top << 1);
     }
 
-    insertRecursive(root.get(), Point<T>(x, y, data), 0);
+    // Levels below maxDepth are never split on, so they stay zero
+    return levels == 32 ? key : key << (64 - 2 * levels);
 }
 
-template <typename T>
-void QuadTree<T>::insertRecursive(QuadTreeNode<T> *node, const Point<T> &point, size_t depth)
+template <typename T, typename Coord>
+QuadTree<T, Coord>::QuadTree(const BoundingBox &bounds, size_t maxPoints, size_t maxDepth)
+    : maxPoints(maxPoints), maxDepth(maxDepth), bucketSize(std::max<size_t>(maxPoints, 1)), pointCount(0),
+      morton(bounds, maxDepth)
 {
-    if (node->isLeaf)
+    nodes.emplace_back(bounds);
+}
+
+template <typename T, typename Coord>
+typename QuadTree<T, Coord>::Handle QuadTree<T, Coord>::insert(double x, double y, const T &data)
+{
+    // Place the point by its stored coordinates, so queries agree with where it lives
+    Point<T, Coord> point(static_cast<Coord>(x), static_cast<Coord>(y), data);
+    if (!nodes[0].bounds.contains(point.x, point.y))
     {
-        if (node->points.size() < maxPoints || depth >= maxDepth)
+        return INVALID_HANDLE; // Point is outside the quadtree bounds
+    }
+
+    Handle handle;
+    if (!freeHandles.empty())
+    {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    }
+    else
+    {
+        handle = static_cast<Handle>(handles.size());
+        handles.push_back(QuadTreeHandleEntry{QuadTreeNode::NONE, QuadTreeNode::NONE});
+    }
+
+    insertRecursive(0, point, 0, handle);
+    ++pointCount;
+    return handle;
+}
+
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::insertRecursive(uint32_t node, const Point<T, Coord> &point, size_t depth, Handle handle)
+{
+    if (nodes[node].isLeaf())
+    {
+        if (nodes[node].count < maxPoints || depth >= maxDepth)
         {
-            node->points.push_back(point);
+            appendToLeaf(node, point, handle);
         }
         else
         {
-            subdivide(node);
-            insertIntoChildren(node, point);
+            subdivide(node, depth);
+            insertIntoChildren(node, point, depth, handle);
         }
     }
     else
     {
-        insertIntoChildren(node, point);
+        insertIntoChildren(node, point, depth, handle);
     }
 }
 
-template <typename T>
-void QuadTree<T>::subdivide(QuadTreeNode<T> *node)
+template <typename T, typename Coord>
+bool QuadTree<T, Coord>::remove(Handle handle)
 {
-    double halfWidth = node->bounds.width / 2.0;
-    double halfHeight = node->bounds.height / 2.0;
+    if (handle >= handles.size() || handles[handle].slot == QuadTreeNode::NONE)
+    {
+        return false;
+    }
 
-    // Create four child nodes
-    node->children[0] = std::make_unique<QuadTreeNode<T>>(
-        BoundingBox(node->bounds.x, node->bounds.y, halfWidth, halfHeight));
-    node->children[1] = std::make_unique<QuadTreeNode<T>>(
-        BoundingBox(node->bounds.x + halfWidth, node->bounds.y, halfWidth, halfHeight));
-    node->children[2] = std::make_unique<QuadTreeNode<T>>(
-        BoundingBox(node->bounds.x, node->bounds.y + halfHeight, halfWidth, halfHeight));
-    node->children[3] = std::make_unique<QuadTreeNode<T>>(
-        BoundingBox(node->bounds.x + halfWidth, node->bounds.y + halfHeight, halfWidth, halfHeight));
+    uint32_t node = handles[handle].node;
+    takeFromLeaf(node, handles[handle].slot);
+    handles[handle] = QuadTreeHandleEntry{QuadTreeNode::NONE, QuadTreeNode::NONE};
+    freeHandles.push_back(handle);
+    --pointCount;
+    return true;
+}
 
-    node->isLeaf = false;
+template <typename T, typename Coord>
+bool QuadTree<T, Coord>::update(Handle handle, double x, double y)
+{
+    Coord storedX = static_cast<Coord>(x);
+    Coord storedY = static_cast<Coord>(y);
+    if (handle >= handles.size() || handles[handle].slot == QuadTreeNode::NONE ||
+        !nodes[0].bounds.contains(storedX, storedY))
+    {
+        return false;
+    }
 
-    // Redistribute existing points to children
-    for (const auto &existingPoint : node->points)
+    // Most moves stay inside the leaf and only rewrite the coordinates
+    QuadTreeHandleEntry entry = handles[handle];
+    if (nodes[entry.node].bounds.contains(storedX, storedY))
     {
-        insertIntoChildren(node, existingPoint);
+        pool[entry.slot].x = xs[entry.slot] = storedX;
+        pool[entry.slot].y = ys[entry.slot] = storedY;
+        return true;
     }
-    node->points.clear();
+
+    Point<T, Coord> point = takeFromLeaf(entry.node, entry.slot);
+    point.x = storedX;
+    point.y = storedY;
+    insertRecursive(0, point, 0, handle);
+    return true;
 }
 
-template <typename T>
-void QuadTree<T>::insertIntoChildren(QuadTreeNode<T> *node, const Point<T> &point)
+template <typename T, typename Coord>
+const Point<T, Coord> &QuadTree<T, Coord>::get(Handle handle) const
 {
-    double midX = node->bounds.x + node->bounds.width / 2.0;
-    double midY = node->bounds.y + node->bounds.height / 2.0;
+    return pool[handles[handle].slot];
+}
 
-    // Determine which child to insert into
-    int childIndex = 0;
-    if (point.x >= midX)
-        childIndex |= 1;
-    if (point.y >= midY)
-        childIndex |= 2;
+template <typename T, typename Coord>
+Point<T, Coord> QuadTree<T, Coord>::takeFromLeaf(uint32_t node, uint32_t slot)
+{
+    // The head bucket is the only partly filled one, so its last slot fills the hole
+    uint32_t head = nodes[node].bucket;
+    uint32_t last = static_cast<uint32_t>(head * bucketSize + buckets[head].count - 1);
+    Point<T, Coord> point = std::move(pool[slot]);
+    if (slot != last)
+    {
+        pool[slot] = std::move(pool[last]);
+        xs[slot] = xs[last];
+        ys[slot] = ys[last];
+        slotHandles[slot] = slotHandles[last];
+        if (slotHandles[slot] != INVALID_HANDLE)
+        {
+            handles[slotHandles[slot]].slot = slot;
+        }
+    }
 
-    insertRecursive(node->children[childIndex].get(), point, 0);
+    if (--buckets[head].count == 0)
+    {
+        nodes[node].bucket = buckets[head].next;
+        freeBuckets.push_back(head);
+    }
+    nodes[node].count--;
+
+    if (nodes[node].parent != QuadTreeNode::NONE)
+    {
+        mergeCandidates.push_back(nodes[node].parent);
+    }
+    return point;
 }
 
-template <typename T>
-std::vector<Point<T>> QuadTree<T>::queryRange(const BoundingBox &range) const
+template <typename T, typename Coord>
+size_t QuadTree<T, Coord>::compact()
 {
-    std::vector<Point<T>> result;
-    queryRangeRecursive(root.get(), range, result);
-    return result;
+    size_t merged = 0;
+
+    // Merging a node can make its parent a candidate, so the list may grow while it is walked
+    for (size_t i = 0; i < mergeCandidates.size(); ++i)
+    {
+        uint32_t node = mergeCandidates[i];
+        if (mergeChildren(node))
+        {
+            ++merged;
+            if (nodes[node].parent != QuadTreeNode::NONE)
+            {
+                mergeCandidates.push_back(nodes[node].parent);
+            }
+        }
+    }
+    mergeCandidates.clear();
+    return merged;
 }
 
-template <typename T>
-void QuadTree<T>::queryRangeRecursive(QuadTreeNode<T> *node, const BoundingBox &range,
-                                      std::vector<Point<T>> &result) const
+template <typename T, typename Coord>
+bool QuadTree<T, Coord>::mergeChildren(uint32_t node)
 {
-    if (!node->bounds.intersects(range))
+    // Candidates may have been merged already or released since they were queued
+    if (nodes[node].isLeaf())
     {
-        return; // No intersection, skip this node
+        return false;
     }
 
-    // Add points from this node that are within the range
-    for (const auto &point : node->points)
+    uint32_t firstChild = nodes[node].firstChild;
+    size_t total = 0;
+    for (uint32_t i = 0; i < 4; ++i)
     {
-        if (range.contains(point.x, point.y))
+        if (!nodes[firstChild + i].isLeaf())
         {
-            result.push_back(point);
+            return false;
         }
+        total += nodes[firstChild + i].count;
+    }
+    if (total > maxPoints / 2)
+    {
+        return false;
     }
 
-    // Recursively search children
-    if (!node->isLeaf)
+    nodes[node].firstChild = QuadTreeNode::NONE;
+    for (uint32_t i = 0; i < 4; ++i)
     {
-        for (int i = 0; i < 4; ++i)
+        QuadTreeNode &child = nodes[firstChild + i];
+        for (uint32_t bucket = child.bucket; bucket != QuadTreeNode::NONE;)
         {
-            if (node->children[i])
+            uint32_t next = buckets[bucket].next;
+            for (uint32_t j = 0; j < buckets[bucket].count; ++j)
             {
-                queryRangeRecursive(node->children[i].get(), range, result);
+                // The point is moved into the argument before appendToLeaf can grow the pool
+                uint32_t slot = static_cast<uint32_t>(bucket * bucketSize + j);
+                appendToLeaf(node, std::move(pool[slot]), slotHandles[slot]);
             }
+            buckets[bucket].count = 0;
+            freeBuckets.push_back(bucket);
+            bucket = next;
         }
+        nodes[firstChild + i] = QuadTreeNode(child.bounds);
     }
+    freeNodes.push_back(firstChild);
+    return true;
 }
 
-template <typename T>
-bool QuadTree<T>::findNearest(double x, double y, Point<T> &nearest) const
+template <typename T, typename Coord>
+uint32_t QuadTree<T, Coord>::allocateBucket(const Point<T, Coord> &filler)
 {
-    double minDist = std::numeric_limits<double>::max();
-    return findNearestRecursive(root.get(), x, y, nearest, minDist);
+    if (!freeBuckets.empty())
+    {
+        uint32_t bucket = freeBuckets.back();
+        freeBuckets.pop_back();
+        return bucket;
+    }
+
+    // Slots left over from before clear() are reused in place; otherwise the pool grows
+    uint32_t bucket = static_cast<uint32_t>(buckets.size());
+    buckets.push_back(QuadTreeBucket{QuadTreeNode::NONE, 0});
+    size_t end = buckets.size() * bucketSize;
+    if (pool.size() < end)
+    {
+        pool.resize(end, filler);
+        xs.resize(end + LEAF_SCAN_PADDING);
+        ys.resize(end + LEAF_SCAN_PADDING);
+        slotHandles.resize(end, INVALID_HANDLE);
+    }
+    return bucket;
 }
 
-template <typename T>
-bool QuadTree<T>::findNearestRecursive(QuadTreeNode<T> *node, double x, double y,
-                                       Point<T> &nearest, double &minDist) const
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::appendToLeaf(uint32_t node, Point<T, Coord> point, Handle handle)
 {
-    if (!node)
-        return false;
+    uint32_t head = nodes[node].bucket;
+    if (head == QuadTreeNode::NONE || buckets[head].count == bucketSize)
+    {
+        uint32_t bucket = allocateBucket(point);
+        buckets[bucket] = QuadTreeBucket{head, 0};
+        nodes[node].bucket = bucket;
+        head = bucket;
+    }
 
-    bool found = false;
+    uint32_t slot = static_cast<uint32_t>(head * bucketSize + buckets[head].count++);
+    pool[slot] = std::move(point);
+    xs[slot] = pool[slot].x;
+    ys[slot] = pool[slot].y;
+    slotHandles[slot] = handle;
+    if (handle != INVALID_HANDLE)
+    {
+        handles[handle] = QuadTreeHandleEntry{slot, node};
+    }
+    nodes[node].count++;
+}
 
-    // Check points in this node
-    for (const auto &point : node->points)
+template <typename T, typename Coord>
+template <typename Fn>
+bool QuadTree<T, Coord>::visit(Fn &fn, const Point<T, Coord> &point)
+{
+    if constexpr (std::is_void<decltype(fn(point))>::value)
+    {
+        fn(point);
+        return true;
+    }
+    else
     {
-        double dist = distance(x, y, point.x, point.y);
-        if (dist < minDist)
+        return static_cast<bool>(fn(point));
+    }
+}
+
+template <typename T, typename Coord>
+template <typename Mask, typename Fn>
+bool QuadTree<T, Coord>::forEachInLeafMasked(const QuadTreeNode &node, Mask &&mask, Fn &&fn) const
+{
+    for (uint32_t bucket = node.bucket; bucket != QuadTreeNode::NONE; bucket = buckets[bucket].next)
+    {
+        size_t base = bucket * bucketSize;
+        uint32_t count = buckets[bucket].count;
+        for (uint32_t block = 0; block < count; block += LEAF_SCAN_BLOCK)
         {
-            minDist = dist;
-            nearest = point;
-            found = true;
+            // Coordinates are tested in bulk; only matching points are touched in the pool
+            uint64_t bits = mask(xs.data() + base + block, ys.data() + base + block,
+                                 std::min(count - block, LEAF_SCAN_BLOCK));
+            while (bits != 0)
+            {
+                if (!visit(fn, pool[base + block + lowestBit(bits)]))
+                {
+                    return false;
+                }
+                bits &= bits - 1;
+            }
         }
     }
+    return true;
+}
 
-    // Recursively search children
-    if (!node->isLeaf)
+template <typename T, typename Coord>
+template <typename Fn>
+bool QuadTree<T, Coord>::forEachInLeaf(const QuadTreeNode &node, Fn &&fn) const
+{
+    for (uint32_t bucket = node.bucket; bucket != QuadTreeNode::NONE; bucket = buckets[bucket].next)
     {
-        // Determine which child is closest to the query point
-        double midX = node->bounds.x + node->bounds.width / 2.0;
-        double midY = node->bounds.y + node->bounds.height / 2.0;
+        const Point<T, Coord> *slots = pool.data() + bucket * bucketSize;
+        for (uint32_t i = 0; i < buckets[bucket].count; ++i)
+        {
+            if (!visit(fn, slots[i]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
 
-        int childIndex = 0;
-        if (x >= midX)
-            childIndex |= 1;
-        if (y >= midY)
-            childIndex |= 2;
+template <typename T, typename Coord>
+uint32_t QuadTree<T, Coord>::createChildren(uint32_t node)
+{
+    // Copy the bounds: creating the children may reallocate the node array
+    BoundingBox bounds = nodes[node].bounds;
 
-        // Search the closest child first
-        if (node->children[childIndex])
+    // Create four child nodes next to each other, reusing a quad released by a merge if there is one
+    uint32_t firstChild;
+    if (!freeNodes.empty())
+    {
+        firstChild = freeNodes.back();
+        freeNodes.pop_back();
+        for (uint32_t i = 0; i < 4; ++i)
         {
-            found |= findNearestRecursive(node->children[childIndex].get(), x, y, nearest, minDist);
+            nodes[firstChild + i] = QuadTreeNode(MortonEncoder::childBounds(bounds, i), node);
         }
+    }
+    else
+    {
+        firstChild = static_cast<uint32_t>(nodes.size());
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            nodes.emplace_back(MortonEncoder::childBounds(bounds, i), node);
+        }
+    }
 
-        // Search other children if they might contain closer points
-        for (int i = 0; i < 4; ++i)
+    nodes[node].firstChild = firstChild;
+    return firstChild;
+}
+
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::subdivide(uint32_t node, size_t depth)
+{
+    uint32_t bucket = nodes[node].bucket;
+    createChildren(node);
+    nodes[node].bucket = QuadTreeNode::NONE;
+    nodes[node].count = 0;
+
+    // Redistribute existing points to children, releasing each bucket once it is empty
+    while (bucket != QuadTreeNode::NONE)
+    {
+        uint32_t next = buckets[bucket].next;
+        uint32_t count = buckets[bucket].count;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            // Move out first: inserting into a child can grow the pool
+            Point<T, Coord> existingPoint = std::move(pool[bucket * bucketSize + i]);
+            insertIntoChildren(node, existingPoint, depth, slotHandles[bucket * bucketSize + i]);
+        }
+
+        buckets[bucket].count = 0;
+        freeBuckets.push_back(bucket);
+        bucket = next;
+    }
+}
+
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::insertIntoChildren(uint32_t node, const Point<T, Coord> &point, size_t depth, Handle handle)
+{
+    const QuadTreeNode &parent = nodes[node];
+    double midX = parent.bounds.x + parent.bounds.width / 2.0;
+    double midY = parent.bounds.y + parent.bounds.height / 2.0;
+
+    // Determine which child to insert into
+    uint32_t childIndex = 0;
+    if (point.x >= midX)
+        childIndex |= 1;
+    if (point.y >= midY)
+        childIndex |= 2;
+
+    insertRecursive(parent.firstChild + childIndex, point, depth + 1, handle);
+}
+
+// Runs fn(begin, end) over count items split into one contiguous range per thread
+template <typename Fn>
+inline void parallelRanges(size_t count, size_t threads, Fn &&fn)
+{
+    if (threads <= 1 || count < threads * 1024)
+    {
+        fn(size_t(0), count);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    size_t step = (count + threads - 1) / threads;
+    for (size_t begin = step; begin < count; begin += step)
+    {
+        workers.emplace_back([&fn, begin, step, count]() {
+            fn(begin, std::min(begin + step, count));
+        });
+    }
+    fn(size_t(0), std::min(step, count));
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+// Stable LSD radix sort of entries by the top bits of their key, 8 bits per pass
+inline void radixSortKeys(std::pair<uint64_t, uint32_t> *keys, std::pair<uint64_t, uint32_t> *scratch,
+                          size_t count, int bits)
+{
+    std::pair<uint64_t, uint32_t> *from = keys;
+    std::pair<uint64_t, uint32_t> *to = scratch;
+    for (int shift = 64 - bits; shift < 64; shift += 8)
+    {
+        size_t offsets[256] = {};
+        for (size_t i = 0; i < count; ++i)
+        {
+            ++offsets[(from[i].first >> shift) & 0xFF];
+        }
+        size_t sum = 0;
+        for (size_t &offset : offsets)
+        {
+            size_t digitCount = offset;
+            offset = sum;
+            sum += digitCount;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            to[offsets[(from[i].first >> shift) & 0xFF]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+    if (from != keys)
+    {
+        std::copy(from, from + count, keys);
+    }
+}
+
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::build(std::vector<Point<T, Coord>> &&points, bool parallel)
+{
+    clear();
+
+    using Key = std::pair<uint64_t, uint32_t>;
+    const size_t threads = parallel ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : 1;
+    const BoundingBox &bounds = nodes[0].bounds;
+
+    // Out-of-bounds points are flagged here and dropped before sorting
+    buildKeys.resize(points.size());
+    parallelRanges(points.size(), threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Point<T, Coord> &point = points[i];
+            buildKeys[i] = bounds.contains(point.x, point.y)
+                               ? Key(morton.encode(point.x, point.y), static_cast<uint32_t>(i))
+                               : Key(0, std::numeric_limits<uint32_t>::max());
+        }
+    });
+    buildKeys.erase(std::remove_if(buildKeys.begin(), buildKeys.end(), [](const Key &key) {
+                        return key.second == std::numeric_limits<uint32_t>::max();
+                    }),
+                    buildKeys.end());
+
+    const size_t count = buildKeys.size();
+    if (count == 0)
+    {
+        return;
+    }
+    buildScratch.resize(count);
+
+    // Radix sort one run per thread, then merge neighbouring runs pairwise
+    const int bits = 2 * static_cast<int>(std::min<size_t>(std::max<size_t>(maxDepth, 1), 32));
+    size_t step = (count + threads - 1) / threads;
+    parallelRanges(count, threads, [&](size_t begin, size_t end) {
+        radixSortKeys(buildKeys.data() + begin, buildScratch.data() + begin, end - begin, bits);
+    });
+    if (threads > 1 && count >= threads * 1024)
+    {
+        for (size_t width = step; width < count; width *= 2)
         {
-            if (i != childIndex && node->children[i])
+            std::vector<std::thread> workers;
+            for (size_t begin = 0; begin < count; begin += 2 * width)
             {
-                // Check if this child's bounds could contain a closer point
-                double childDist = distanceToBounds(x, y, node->children[i]->bounds);
-                if (childDist < minDist)
+                size_t middle = std::min(begin + width, count);
+                size_t end = std::min(begin + 2 * width, count);
+                workers.emplace_back([this, begin, middle, end]() {
+                    std::merge(buildKeys.begin() + begin, buildKeys.begin() + middle,
+                               buildKeys.begin() + middle, buildKeys.begin() + end,
+                               buildScratch.begin() + begin, [](const Key &a, const Key &b) {
+                                   return a.first < b.first;
+                               });
+                });
+            }
+            for (auto &worker : workers)
+            {
+                worker.join();
+            }
+            buildKeys.swap(buildScratch);
+        }
+    }
+
+    pointCount = count;
+    buildRecursive(0, buildKeys.data(), buildKeys.data() + count, 0, points);
+}
+
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::buildRecursive(uint32_t node, const std::pair<uint64_t, uint32_t> *begin,
+                                 const std::pair<uint64_t, uint32_t> *end, size_t depth,
+                                 std::vector<Point<T, Coord>> &points)
+{
+    size_t count = static_cast<size_t>(end - begin);
+    if (count <= maxPoints || depth >= maxDepth)
+    {
+        for (auto it = begin; it != end; ++it)
+        {
+            appendToLeaf(node, std::move(points[it->second]), INVALID_HANDLE);
+        }
+        return;
+    }
+
+    // Keys only hold 32 levels; anything deeper falls back to regular insertion
+    if (depth >= 32)
+    {
+        for (auto it = begin; it != end; ++it)
+        {
+            insertRecursive(node, points[it->second], depth, INVALID_HANDLE);
+        }
+        return;
+    }
+
+    uint32_t firstChild = createChildren(node);
+
+    // Each child owns the contiguous run of keys whose digit at this level is its index
+    int shift = 62 - 2 * static_cast<int>(depth);
+    const std::pair<uint64_t, uint32_t> *childBegin = begin;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        const std::pair<uint64_t, uint32_t> *childEnd = std::partition_point(
+            childBegin, end, [shift, i](const std::pair<uint64_t, uint32_t> &key) {
+                return ((key.first >> shift) & 3) <= i;
+            });
+        buildRecursive(firstChild + i, childBegin, childEnd, depth + 1, points);
+        childBegin = childEnd;
+    }
+}
+
+template <typename T, typename Coord>
+std::vector<Point<T, Coord>> QuadTree<T, Coord>::queryRange(const BoundingBox &range) const
+{
+    std::vector<Point<T, Coord>> result;
+    queryRange(range, result);
+    return result;
+}
+
+template <typename T, typename Coord>
+size_t QuadTree<T, Coord>::queryRange(const BoundingBox &range, std::vector<Point<T, Coord>> &result) const
+{
+    size_t start = result.size();
+    queryRange(range, [&result](const Point<T, Coord> &point) {
+        result.push_back(point);
+    });
+    return result.size() - start;
+}
+
+template <typename T, typename Coord>
+template <typename Fn>
+bool QuadTree<T, Coord>::queryRange(const BoundingBox &range, Fn &&fn) const
+{
+    LeafScanBox<Coord> box(range.x, range.y, range.x + range.width, range.y + range.height);
+    return queryRangeRecursive(0, range, box, fn);
+}
+
+template <typename T, typename Coord>
+template <typename Fn>
+bool QuadTree<T, Coord>::queryRangeRecursive(uint32_t node, const BoundingBox &range, const LeafScanBox<Coord> &box,
+                                             Fn &fn) const
+{
+    const QuadTreeNode &current = nodes[node];
+    if (!current.bounds.intersects(range))
+    {
+        return true; // No intersection, skip this node
+    }
+
+    // Every point of a node lies inside its bounds, so a covered node is visited without tests
+    if (range.contains(current.bounds))
+    {
+        return getAllPointsRecursive(node, fn);
+    }
+
+    if (current.isLeaf())
+    {
+        // Visit points from this leaf that are within the range
+        return forEachInLeafMasked(
+            current,
+            [&box](const Coord *leafXs, const Coord *leafYs, uint32_t count) {
+                return leafRangeMask(leafXs, leafYs, count, box);
+            },
+            fn);
+    }
+
+    // Recursively search children
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (!queryRangeRecursive(current.firstChild + i, range, box, fn))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Coord>
+bool QuadTree<T, Coord>::findNearest(double x, double y, Point<T, Coord> &nearest) const
+{
+    double minDistSq = std::numeric_limits<double>::max();
+    return findNearestRecursive(0, x, y, nearest, minDistSq);
+}
+
+template <typename T, typename Coord>
+bool QuadTree<T, Coord>::findNearestRecursive(uint32_t node, double x, double y,
+                                       Point<T, Coord> &nearest, double &minDistSq) const
+{
+    const QuadTreeNode &current = nodes[node];
+    bool found = false;
+
+    // Check points in this node
+    if (current.isLeaf())
+    {
+        // The kernel only narrows the candidates; the exact distance decides
+        forEachInLeafMasked(
+            current,
+            [&](const Coord *leafXs, const Coord *leafYs, uint32_t count) {
+                return leafDistanceMask(leafXs, leafYs, count, x, y, minDistSq);
+            },
+            [&](const Point<T, Coord> &point) {
+                double distSq = distanceSq(x, y, point.x, point.y);
+                if (distSq < minDistSq)
                 {
-                    found |= findNearestRecursive(node->children[i].get(), x, y, nearest, minDist);
+                    minDistSq = distSq;
+                    nearest = point;
+                    found = true;
                 }
+            });
+        return found;
+    }
+
+    // Determine which child is closest to the query point
+    double midX = current.bounds.x + current.bounds.width / 2.0;
+    double midY = current.bounds.y + current.bounds.height / 2.0;
+
+    uint32_t childIndex = 0;
+    if (x >= midX)
+        childIndex |= 1;
+    if (y >= midY)
+        childIndex |= 2;
+
+    // Search the closest child first
+    found |= findNearestRecursive(current.firstChild + childIndex, x, y, nearest, minDistSq);
+
+    // Search other children if they might contain closer points
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (i != childIndex)
+        {
+            // Check if this child's bounds could contain a closer point
+            double childDistSq = distanceSqToBounds(x, y, nodes[current.firstChild + i].bounds);
+            if (childDistSq < minDistSq)
+            {
+                found |= findNearestRecursive(current.firstChild + i, x, y, nearest, minDistSq);
             }
         }
     }
@@ -187,88 +769,321 @@ bool QuadTree<T>::findNearestRecursive(QuadTreeNode<T> *node, double x, double y
     return found;
 }
 
-template <typename T>
-double QuadTree<T>::distance(double x1, double y1, double x2, double y2)
+template <typename T, typename Coord>
+std::vector<Point<T, Coord>> QuadTree<T, Coord>::findKNearest(double x, double y, size_t k) const
 {
-    double dx = x2 - x1;
-    double dy = y2 - y1;
-    return std::sqrt(dx * dx + dy * dy);
+    std::vector<Point<T, Coord>> result;
+    findKNearest(x, y, k, result);
+    return result;
 }
 
-template <typename T>
-double QuadTree<T>::distanceToBounds(double x, double y, const BoundingBox &bounds)
+template <typename T, typename Coord>
+size_t QuadTree<T, Coord>::findKNearest(double x, double y, size_t k, std::vector<Point<T, Coord>> &result) const
 {
-    double dx = std::max(0.0, std::max(bounds.x - x, x - (bounds.x + bounds.width)));
-    double dy = std::max(0.0, std::max(bounds.y - y, y - (bounds.y + bounds.height)));
-    return std::sqrt(dx * dx + dy * dy);
+    result.clear();
+    return appendKNearest(x, y, k, result);
 }
 
-template <typename T>
-std::vector<Point<T>> QuadTree<T>::getAllPoints() const
+template <typename T, typename Coord>
+size_t QuadTree<T, Coord>::appendKNearest(double x, double y, size_t k, std::vector<Point<T, Coord>> &result) const
 {
-    std::vector<Point<T>> result;
-    getAllPointsRecursive(root.get(), result);
-    return result;
+    using Entry = typename NeighbourHeap<T, Coord>::Entry;
+
+    k = std::min(k, pointCount);
+    if (k == 0)
+    {
+        return 0;
+    }
+
+    // Small k keeps the heap on the stack; larger k allocates it once
+    Entry inlineEntries[NeighbourHeap<T, Coord>::INLINE_CAPACITY];
+    std::vector<Entry> spilled;
+    Entry *storage = inlineEntries;
+    if (k > NeighbourHeap<T, Coord>::INLINE_CAPACITY)
+    {
+        spilled.resize(k);
+        storage = spilled.data();
+    }
+
+    NeighbourHeap<T, Coord> heap(storage, k);
+    findKNearestRecursive(0, x, y, heap);
+    heap.sortNearestFirst();
+    for (const Entry &entry : heap)
+    {
+        result.push_back(*entry.point);
+    }
+    return heap.size();
 }
 
-template <typename T>
-void QuadTree<T>::getAllPointsRecursive(QuadTreeNode<T> *node, std::vector<Point<T>> &result) const
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::findKNearestRecursive(uint32_t node, double x, double y, NeighbourHeap<T, Coord> &heap) const
 {
-    if (!node)
+    const QuadTreeNode &current = nodes[node];
+    if (current.isLeaf())
+    {
+        forEachInLeafMasked(
+            current,
+            [&](const Coord *leafXs, const Coord *leafYs, uint32_t count) {
+                return leafDistanceMask(leafXs, leafYs, count, x, y, heap.bound());
+            },
+            [&](const Point<T, Coord> &point) {
+                heap.push(distanceSq(x, y, point.x, point.y), &point);
+            });
         return;
+    }
 
-    // Add points from this node
-    result.insert(result.end(), node->points.begin(), node->points.end());
+    // Order the children by how close their bounds come to the query point
+    double childDistSq[4];
+    uint32_t order[4];
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        childDistSq[i] = distanceSqToBounds(x, y, nodes[current.firstChild + i].bounds);
+        uint32_t j = i;
+        for (; j > 0 && childDistSq[order[j - 1]] > childDistSq[i]; --j)
+        {
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+    }
 
-    // Recursively get points from children
-    if (!node->isLeaf)
+    // The bound only shrinks, so the first child that cannot improve ends the search
+    for (uint32_t n = 0; n < 4; ++n)
     {
-        for (int i = 0; i < 4; ++i)
+        uint32_t i = order[n];
+        if (childDistSq[i] >= heap.bound())
         {
-            if (node->children[i])
-            {
-                getAllPointsRecursive(node->children[i].get(), result);
-            }
+            break;
         }
+        findKNearestRecursive(current.firstChild + i, x, y, heap);
     }
 }
 
-template <typename T>
-void QuadTree<T>::clear()
+template <typename T, typename Coord>
+std::vector<Point<T, Coord>> QuadTree<T, Coord>::queryRadius(double x, double y, double radius) const
+{
+    std::vector<Point<T, Coord>> result;
+    queryRadius(x, y, radius, result);
+    return result;
+}
+
+template <typename T, typename Coord>
+size_t QuadTree<T, Coord>::queryRadius(double x, double y, double radius, std::vector<Point<T, Coord>> &result) const
 {
-    root = std::make_unique<QuadTreeNode<T>>(root->bounds);
+    size_t start = result.size();
+    queryRadius(x, y, radius, [&result](const Point<T, Coord> &point) {
+        result.push_back(point);
+    });
+    return result.size() - start;
 }
 
-template <typename T>
-size_t QuadTree<T>::size() const
+template <typename T, typename Coord>
+template <typename Fn>
+bool QuadTree<T, Coord>::queryRadius(double x, double y, double radius, Fn &&fn) const
 {
-    return countPointsRecursive(root.get());
+    return radius < 0 || queryRadiusRecursive(0, x, y, radius * radius, fn);
 }
 
-template <typename T>
-size_t QuadTree<T>::countPointsRecursive(QuadTreeNode<T> *node) const
+template <typename T, typename Coord>
+template <typename Fn>
+bool QuadTree<T, Coord>::queryRadiusRecursive(uint32_t node, double x, double y, double radiusSq, Fn &fn) const
 {
-    if (!node)
-        return 0;
+    const QuadTreeNode &current = nodes[node];
+    if (distanceSqToBounds(x, y, current.bounds) > radiusSq)
+    {
+        return true; // Circle misses this node
+    }
 
-    size_t count = node->points.size();
+    // Every point of a node lies inside its bounds, so a covered node is taken whole
+    if (farthestDistanceSq(x, y, current.bounds) <= radiusSq)
+    {
+        return getAllPointsRecursive(node, fn);
+    }
+
+    if (current.isLeaf())
+    {
+        return forEachInLeafMasked(
+            current,
+            [&](const Coord *leafXs, const Coord *leafYs, uint32_t count) {
+                return leafDistanceMask(leafXs, leafYs, count, x, y, radiusSq);
+            },
+            [&](const Point<T, Coord> &point) {
+                return distanceSq(x, y, point.x, point.y) > radiusSq || visit(fn, point);
+            });
+    }
 
-    if (!node->isLeaf)
+    for (uint32_t i = 0; i < 4; ++i)
     {
-        for (int i = 0; i < 4; ++i)
+        if (!queryRadiusRecursive(current.firstChild + i, x, y, radiusSq, fn))
         {
-            if (node->children[i])
-            {
-                count += countPointsRecursive(node->children[i].get());
-            }
+            return false;
         }
     }
+    return true;
+}
+
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::queryRangeBatch(const BoundingBox *ranges, size_t count, QuadTreeBatch<T, Coord> &result,
+                                  ThreadPool &pool) const
+{
+    runBatch(count, result, pool, [this, ranges](size_t i, std::vector<Point<T, Coord>> &out) {
+        queryRange(ranges[i], out);
+    });
+}
 
-    return count;
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::findKNearestBatch(const QueryPoint *points, size_t count, size_t k, QuadTreeBatch<T, Coord> &result,
+                                    ThreadPool &pool) const
+{
+    runBatch(count, result, pool, [this, points, k](size_t i, std::vector<Point<T, Coord>> &out) {
+        appendKNearest(points[i].x, points[i].y, k, out);
+    });
+}
+
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::findNearestBatch(const QueryPoint *points, size_t count, QuadTreeBatch<T, Coord> &result,
+                                   ThreadPool &pool) const
+{
+    findKNearestBatch(points, count, 1, result, pool);
+}
+
+template <typename T, typename Coord>
+template <typename Query>
+void QuadTree<T, Coord>::runBatch(size_t count, QuadTreeBatch<T, Coord> &result, ThreadPool &pool, Query &&query) const
+{
+    const size_t grain = 16;
+
+    // Each thread appends to its own buffer and notes where every query's results start
+    result.workerPoints.resize(pool.size());
+    for (auto &points : result.workerPoints)
+    {
+        points.clear();
+    }
+    result.sources.resize(count);
+    result.offsets.resize(count + 1);
+    result.offsets[0] = 0;
+    pool.parallelFor(count, grain, [&](size_t begin, size_t end, size_t participant) {
+        std::vector<Point<T, Coord>> &points = result.workerPoints[participant];
+        for (size_t i = begin; i < end; ++i)
+        {
+            size_t start = points.size();
+            query(i, points);
+            result.sources[i] = std::make_pair(static_cast<uint32_t>(participant), start);
+            result.offsets[i + 1] = points.size() - start;
+        }
+    });
+
+    // Prefix sum of the counts, then copy every slice into place
+    for (size_t i = 0; i < count; ++i)
+    {
+        result.offsets[i + 1] += result.offsets[i];
+    }
+    result.points.resize(result.offsets[count]);
+    pool.parallelFor(count, grain * 4, [&](size_t begin, size_t end, size_t /*participant*/) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const std::vector<Point<T, Coord>> &points = result.workerPoints[result.sources[i].first];
+            auto first = points.begin() + result.sources[i].second;
+            size_t count = result.offsets[i + 1] - result.offsets[i];
+            std::copy(first, first + count, result.points.begin() + result.offsets[i]);
+        }
+    });
+}
+
+template <typename T, typename Coord>
+double QuadTree<T, Coord>::distanceSq(double x1, double y1, double x2, double y2)
+{
+    double dx = x2 - x1;
+    double dy = y2 - y1;
+    return dx * dx + dy * dy;
+}
+
+template <typename T, typename Coord>
+double QuadTree<T, Coord>::distanceSqToBounds(double x, double y, const BoundingBox &bounds)
+{
+    double dx = std::max(0.0, std::max(bounds.x - x, x - (bounds.x + bounds.width)));
+    double dy = std::max(0.0, std::max(bounds.y - y, y - (bounds.y + bounds.height)));
+    return dx * dx + dy * dy;
+}
+
+template <typename T, typename Coord>
+double QuadTree<T, Coord>::farthestDistanceSq(double x, double y, const BoundingBox &bounds)
+{
+    double dx = std::max(std::abs(x - bounds.x), std::abs(bounds.x + bounds.width - x));
+    double dy = std::max(std::abs(y - bounds.y), std::abs(bounds.y + bounds.height - y));
+    return dx * dx + dy * dy;
+}
+
+template <typename T, typename Coord>
+std::vector<Point<T, Coord>> QuadTree<T, Coord>::getAllPoints() const
+{
+    std::vector<Point<T, Coord>> result;
+    getAllPoints(result);
+    return result;
+}
+
+template <typename T, typename Coord>
+size_t QuadTree<T, Coord>::getAllPoints(std::vector<Point<T, Coord>> &result) const
+{
+    result.reserve(result.size() + pointCount);
+    getAllPoints([&result](const Point<T, Coord> &point) {
+        result.push_back(point);
+    });
+    return pointCount;
+}
+
+template <typename T, typename Coord>
+template <typename Fn>
+bool QuadTree<T, Coord>::getAllPoints(Fn &&fn) const
+{
+    return getAllPointsRecursive(0, fn);
+}
+
+template <typename T, typename Coord>
+template <typename Fn>
+bool QuadTree<T, Coord>::getAllPointsRecursive(uint32_t node, Fn &fn) const
+{
+    const QuadTreeNode &current = nodes[node];
+
+    // Visit points from this node
+    if (current.isLeaf())
+    {
+        return forEachInLeaf(current, fn);
+    }
+
+    // Recursively visit points from children
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (!getAllPointsRecursive(current.firstChild + i, fn))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Coord>
+void QuadTree<T, Coord>::clear()
+{
+    // Only trivially destructible bookkeeping is dropped; the pool is kept for reuse
+    nodes.erase(nodes.begin() + 1, nodes.end());
+    nodes[0] = QuadTreeNode(nodes[0].bounds);
+    buckets.clear();
+    freeBuckets.clear();
+    freeNodes.clear();
+    handles.clear();
+    freeHandles.clear();
+    mergeCandidates.clear();
+    pointCount = 0;
+}
+
+template <typename T, typename Coord>
+size_t QuadTree<T, Coord>::size() const
+{
+    return pointCount;
 }
 
-template <typename T>
-bool QuadTree<T>::empty() const
+template <typename T, typename Coord>
+bool QuadTree<T, Coord>::empty() const
 {
     return size() == 0;
 }
@@ -0,0 +1,96 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads running parallel loops with work stealing
+ *
+ * Each parallelFor() splits its index range evenly between the calling thread
+ * and the workers. Every participant takes small chunks from the front of its
+ * own share. Once its share is empty it steals the back half of another
+ * participant's remaining share, so uneven per-index costs still balance out.
+ */
+class ThreadPool
+{
+private:
+    // Remaining share of one participant; the owner takes from begin, thieves from end
+    struct Share
+    {
+        std::mutex lock;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Share[]> shares; // One per participant, the caller is participant 0
+    std::function<void(size_t, size_t, size_t)> job;
+    size_t grain;
+
+    std::mutex jobLock;
+    std::condition_variable jobReady;
+    std::condition_variable jobDone;
+    uint64_t generation; // Incremented for every job handed to the workers
+    size_t active;       // Workers still running the current job
+    bool stopping;
+
+    /**
+     * Wait for jobs and run them until the pool is destroyed
+     */
+    void workerLoop(size_t participant);
+
+    /**
+     * Run chunks of the participant's own share, then steal until no work is left
+     */
+    void runShare(size_t participant);
+
+    /**
+     * Move the back half of another participant's share to this one
+     * @return False if every other share is empty
+     */
+    bool steal(size_t participant);
+
+public:
+    /**
+     * Constructor
+     * @param threads Participants including the calling thread (default: one per hardware thread)
+     */
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+
+    /**
+     * Stop and join all workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * Number of threads taking part in a parallelFor(), including the caller
+     */
+    size_t size() const;
+
+    /**
+     * Call fn(begin, end, participant) over disjoint chunks covering [0, count)
+     *
+     * Returns once every chunk has run. The participant index is below size()
+     * and identifies the thread, so fn can use it to pick per-thread scratch
+     * space. Only one thread may call parallelFor() on a pool at a time.
+     * @param count Number of indices
+     * @param grain Largest chunk a participant takes from its own share at once
+     * @param fn Callable taking (size_t begin, size_t end, size_t participant)
+     */
+    template <typename Fn>
+    void parallelFor(size_t count, size_t grain, Fn &&fn);
+};
+
+#include "thread_pool.hpp"
+
+#endif // THREAD_POOL_H
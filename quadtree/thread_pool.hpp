@@ -0,0 +1,154 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+inline ThreadPool::ThreadPool(size_t threads)
+    : shares(new Share[std::max<size_t>(threads, 1)]), grain(1), generation(0), active(0), stopping(false)
+{
+    // The calling thread is always a participant, so one fewer worker is started
+    for (size_t i = 1; i < std::max<size_t>(threads, 1); ++i)
+    {
+        workers.emplace_back([this, i]() {
+            workerLoop(i);
+        });
+    }
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(jobLock);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+inline size_t ThreadPool::size() const
+{
+    return workers.size() + 1;
+}
+
+template <typename Fn>
+void ThreadPool::parallelFor(size_t count, size_t grain, Fn &&fn)
+{
+    const size_t participants = size();
+    if (participants == 1 || count <= grain)
+    {
+        if (count > 0)
+        {
+            fn(size_t(0), count, size_t(0));
+        }
+        return;
+    }
+
+    // Even shares up front; stealing fixes whatever imbalance the work has
+    size_t step = (count + participants - 1) / participants;
+    for (size_t i = 0; i < participants; ++i)
+    {
+        shares[i].begin = std::min(i * step, count);
+        shares[i].end = std::min((i + 1) * step, count);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(jobLock);
+        job = [&fn](size_t begin, size_t end, size_t participant) {
+            fn(begin, end, participant);
+        };
+        this->grain = std::max<size_t>(grain, 1);
+        active = workers.size();
+        ++generation;
+    }
+    jobReady.notify_all();
+
+    runShare(0);
+
+    std::unique_lock<std::mutex> guard(jobLock);
+    jobDone.wait(guard, [this]() {
+        return active == 0;
+    });
+    job = nullptr;
+}
+
+inline void ThreadPool::workerLoop(size_t participant)
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> guard(jobLock);
+            jobReady.wait(guard, [this, seen]() {
+                return stopping || generation != seen;
+            });
+            if (stopping)
+            {
+                return;
+            }
+            seen = generation;
+        }
+
+        runShare(participant);
+
+        std::lock_guard<std::mutex> guard(jobLock);
+        if (--active == 0)
+        {
+            jobDone.notify_one();
+        }
+    }
+}
+
+inline void ThreadPool::runShare(size_t participant)
+{
+    Share &own = shares[participant];
+    for (;;)
+    {
+        size_t begin, end;
+        {
+            std::lock_guard<std::mutex> guard(own.lock);
+            begin = own.begin;
+            end = std::min(own.begin + grain, own.end);
+            own.begin = end;
+        }
+
+        if (begin < end)
+        {
+            job(begin, end, participant);
+        }
+        else if (!steal(participant))
+        {
+            return;
+        }
+    }
+}
+
+inline bool ThreadPool::steal(size_t participant)
+{
+    const size_t participants = size();
+    for (size_t offset = 1; offset < participants; ++offset)
+    {
+        Share &victim = shares[(participant + offset) % participants];
+        size_t begin, end;
+        {
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.begin >= victim.end)
+            {
+                continue;
+            }
+
+            // Leave the victim the front half it is about to work through
+            size_t remaining = victim.end - victim.begin;
+            begin = remaining <= grain ? victim.begin : victim.begin + remaining / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+
+        Share &own = shares[participant];
+        std::lock_guard<std::mutex> guard(own.lock);
+        own.begin = begin;
+        own.end = end;
+        return true;
+    }
+    return false;
+}